@@ -146,9 +146,16 @@ public static class Constants
     /// </summary>
     public const int CLOUDS_IN_ONE = 4;
 
+    // NOTE: these 2 constants need to match the native CompoundCloudSimulation
     public const int CLOUD_SQUARES_PER_SIDE = 3;
     public const int CLOUD_EDGE_WIDTH = 2;
 
+    /// <summary>
+    ///   Distance in cloud cells between the fluid velocity samples given to the cloud simulation. Velocities between
+    ///   the samples are interpolated.
+    /// </summary>
+    public const int CLOUD_VELOCITY_GRID_SPACING = 4;
+
     // NOTE: these 4 constants need to match what is setup in CompoundCloudPlane.tscn
     public const int CLOUD_WIDTH = 300;
     public const int CLOUD_X_EXTENT = CLOUD_WIDTH * 2;
@@ -166,6 +173,7 @@ public static class Constants
 
     public const float CLOUD_CHEAT_DENSITY = 16000.0f;
 
+    // NOTE: the membrane shape constants need to match the native MembraneGenerator
     public const int MEMBRANE_RESOLUTION = 10;
     public const int MEMBRANE_VERTICAL_RESOLUTION = 7;
     public const float MEMBRANE_HEIGHT_MULTIPLIER = 1.0f;
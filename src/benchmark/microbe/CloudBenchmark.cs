@@ -66,6 +66,7 @@ public partial class CloudBenchmark : BenchmarkBase
 #pragma warning restore CA2213
 
     private World? dummyEntityWorld;
+    private PhysicalWorld? dummyPhysicalWorld;
     private CompoundCloudSystem? cloudSystem;
 
     private int emittersCount;
@@ -385,6 +386,7 @@ public partial class CloudBenchmark : BenchmarkBase
         if (disposing)
         {
             dummyEntityWorld?.Dispose();
+            dummyPhysicalWorld?.Dispose();
             cloudSystem?.Dispose();
         }
 
@@ -398,7 +400,8 @@ public partial class CloudBenchmark : BenchmarkBase
 
         // Dummy currents that doesn't need to run on any entities has to be created for the cloud system
         dummyEntityWorld = new World();
-        var dummyCurrents = new FluidCurrentsSystem(dummyEntityWorld, new DefaultParallelRunner(1));
+        dummyPhysicalWorld = PhysicalWorld.Create();
+        var dummyCurrents = new FluidCurrentsSystem(dummyPhysicalWorld, dummyEntityWorld, new DefaultParallelRunner(1));
 
         cloudSystem.Init(dummyCurrents);
 
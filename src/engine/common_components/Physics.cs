@@ -53,6 +53,13 @@ public struct Physics
     /// </summary>
     public AxisLockType AxisLock;
 
+    /// <summary>
+    ///   When true the body uses continuous collision detection to not pass through other bodies when moving fast.
+    ///   This is more expensive so it should only be used for things like projectiles. Only applies on body
+    ///   creation.
+    /// </summary>
+    public bool ContinuousCollision;
+
     /// <summary>
     ///   When set to <see cref="CollisionState.DisableCollisions"/>, this disables all *further*
     ///   collisions for the object. This doesn't stop any existing collisions. To do that the physics body needs
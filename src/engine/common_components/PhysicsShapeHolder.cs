@@ -11,6 +11,13 @@ public struct PhysicsShapeHolder
     [JsonIgnore]
     public PhysicsShape? Shape;
 
+    /// <summary>
+    ///   Shape that is being built in the background. Once ready the shape is moved to <see cref="Shape"/> (and the
+    ///   body updated to use it) by <see cref="Systems.PhysicsBodyCreationSystem"/>.
+    /// </summary>
+    [JsonIgnore]
+    public PhysicsShapeBuildTask? PendingShape;
+
     /// <summary>
     ///   When true the body is created as a static body that cannot move
     /// </summary>
@@ -1,5 +1,6 @@
 ﻿namespace Systems;
 
+using System;
 using Components;
 using DefaultEcs;
 using DefaultEcs.System;
@@ -17,6 +18,13 @@ using World = DefaultEcs.World;
 [RuntimeCost(0.5f)]
 public sealed class PhysicsBodyControlSystem : AEntitySetSystem<float>
 {
+    /// <summary>
+    ///   Body modifications are collected per thread and submitted to the native side all at once at the end of each
+    ///   entity chunk
+    /// </summary>
+    [ThreadStatic]
+    private static PhysicsBodyCommandBuffer? commandBuffer;
+
     private readonly PhysicalWorld physicalWorld;
 
     public PhysicsBodyControlSystem(PhysicalWorld physicalWorld, World world, IParallelRunner runner) :
@@ -25,6 +33,15 @@ public sealed class PhysicsBodyControlSystem : AEntitySetSystem<float>
         this.physicalWorld = physicalWorld;
     }
 
+    protected override void Update(float delta, ReadOnlySpan<Entity> entities)
+    {
+        commandBuffer ??= new PhysicsBodyCommandBuffer();
+
+        base.Update(delta, entities);
+
+        physicalWorld.ApplyBodyCommands(commandBuffer);
+    }
+
     protected override void Update(float delta, in Entity entity)
     {
         ref var physics = ref entity.Get<Physics>();
@@ -39,9 +56,11 @@ public sealed class PhysicsBodyControlSystem : AEntitySetSystem<float>
         if (control.PhysicsApplied && physics.VelocitiesApplied)
             return;
 
+        var commands = commandBuffer!;
+
         if (!physics.VelocitiesApplied)
         {
-            physicalWorld.SetBodyVelocity(body, physics.Velocity, physics.AngularVelocity);
+            commands.SetBodyVelocity(body, physics.Velocity, physics.AngularVelocity);
             physics.VelocitiesApplied = true;
         }
 
@@ -51,30 +70,30 @@ public sealed class PhysicsBodyControlSystem : AEntitySetSystem<float>
             {
                 control.RemoveVelocity = false;
                 control.RemoveAngularVelocity = false;
-                physicalWorld.SetBodyVelocity(body, Vector3.Zero, Vector3.Zero);
+                commands.SetBodyVelocity(body, Vector3.Zero, Vector3.Zero);
             }
             else if (control.RemoveVelocity)
             {
                 control.RemoveVelocity = false;
-                physicalWorld.SetOnlyBodyVelocity(body, Vector3.Zero);
+                commands.SetOnlyBodyVelocity(body, Vector3.Zero);
             }
             else if (control.RemoveAngularVelocity)
             {
                 control.RemoveAngularVelocity = false;
-                physicalWorld.SetOnlyBodyAngularVelocity(body, Vector3.Zero);
+                commands.SetOnlyBodyAngularVelocity(body, Vector3.Zero);
             }
 
             if (control.ImpulseToGive != Vector3.Zero)
             {
                 // To not have objects that sit around until touched and then shoot off at high velocity we
                 // automatically activate bodies that have accumulated enough linear speed
-                physicalWorld.GiveImpulse(body, control.ImpulseToGive, true);
+                commands.GiveImpulse(body, control.ImpulseToGive, true);
                 control.ImpulseToGive = Vector3.Zero;
             }
 
             if (control.AngularImpulseToGive != Vector3.Zero)
             {
-                physicalWorld.GiveAngularImpulse(body, control.AngularImpulseToGive, true);
+                commands.GiveAngularImpulse(body, control.AngularImpulseToGive, true);
                 control.AngularImpulseToGive = Vector3.Zero;
             }
 
@@ -88,6 +88,9 @@ public sealed class PhysicsBodyCreationSystem : AEntitySetSystem<float>
 
         ref var shapeHolder = ref entity.Get<PhysicsShapeHolder>();
 
+        if (shapeHolder.PendingShape != null)
+            ApplyPendingShape(ref shapeHolder);
+
         // Don't need to do anything if body is already created and it is not requested to be recreated
         if (body != null && !shapeHolder.UpdateBodyShapeIfCreated)
             return;
@@ -141,6 +144,9 @@ public sealed class PhysicsBodyCreationSystem : AEntitySetSystem<float>
             {
                 physicalWorld.SetDamping(body, physics.LinearDamping.Value, physics.AngularDamping);
             }
+
+            if (physics.ContinuousCollision)
+                physicalWorld.SetBodyContinuousCollision(body, true);
         }
 
         // Store the entity in the body to make physics callbacks reported back from the physics system tell us
@@ -167,6 +173,30 @@ public sealed class PhysicsBodyCreationSystem : AEntitySetSystem<float>
         createdBodies.RemoveAll(destroyBodyIfNotMarkedCallable);
     }
 
+    /// <summary>
+    ///   Moves a shape built in the background to be the used shape once it is ready
+    /// </summary>
+    private static void ApplyPendingShape(ref PhysicsShapeHolder shapeHolder)
+    {
+        var pendingShape = shapeHolder.PendingShape!;
+
+        if (!pendingShape.IsCompleted)
+            return;
+
+        if (pendingShape.TryGetShape(out var shape))
+        {
+            shapeHolder.Shape = shape;
+            shapeHolder.UpdateBodyShapeIfCreated = true;
+        }
+        else
+        {
+            GD.PrintErr("Background physics shape build failed");
+        }
+
+        pendingShape.Dispose();
+        shapeHolder.PendingShape = null;
+    }
+
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     private bool DestroyBodyIfNotMarked(NativePhysicsBody body)
     {
@@ -1,6 +1,7 @@
 ﻿namespace Systems;
 
 using System;
+using System.Buffers;
 using Components;
 using DefaultEcs;
 using DefaultEcs.System;
@@ -30,16 +31,84 @@ public sealed class PhysicsUpdateAndPositionSystem : AEntitySetSystem<float>
     /// </summary>
     public bool EnforceYPosition { get; set; }
 
-    protected override void Update(float delta, in Entity entity)
+    protected override void Update(float delta, ReadOnlySpan<Entity> entities)
     {
-        ref var physics = ref entity.Get<Physics>();
+        // The body states are read with a single native call for the whole chunk of entities to avoid a lot of
+        // per-body interop and locking overhead
+        int count = entities.Length;
+
+        var bodies = ArrayPool<IntPtr>.Shared.Rent(count);
+        var positions = ArrayPool<JVec3>.Shared.Rent(count);
+        var rotations = ArrayPool<JQuat>.Shared.Rent(count);
+        var velocities = ArrayPool<JVecF3>.Shared.Rent(count);
+        var angularVelocities = ArrayPool<JVecF3>.Shared.Rent(count);
+        var stateFlags = ArrayPool<byte>.Shared.Rent(count);
+
+        try
+        {
+            int bodyCount = 0;
+
+            foreach (var entity in entities)
+            {
+                ref var physics = ref entity.Get<Physics>();
 
-        if (!physics.IsBodyEffectivelyEnabled())
-            return;
+                if (!physics.IsBodyEffectivelyEnabled())
+                    continue;
 
-        var body = physics.Body!;
+                bodies[bodyCount++] = physics.Body!.AccessBodyInternal();
+            }
+
+            if (bodyCount < 1)
+                return;
+
+            int readCount = physicalWorld.ReadBodyStates(bodies.AsSpan(0, bodyCount), positions, rotations,
+                velocities, angularVelocities, stateFlags);
+
+            bool allRead = readCount == bodyCount;
+
+            int index = 0;
+
+            foreach (var entity in entities)
+            {
+                ref var physics = ref entity.Get<Physics>();
+
+                if (!physics.IsBodyEffectivelyEnabled())
+                    continue;
+
+                ref var position = ref entity.Get<WorldPosition>();
+
+                // Bodies that could not be read have zeroed out data, so the previous values are kept for them
+                if (allRead || (stateFlags[index] & PhysicalWorld.BODY_STATE_FLAG_READ) != 0)
+                {
+                    position.Position = positions[index];
+                    position.Rotation = rotations[index];
 
-        ref var position = ref entity.Get<WorldPosition>();
+                    if (physics.TrackVelocity)
+                    {
+                        physics.Velocity = velocities[index];
+                        physics.AngularVelocity = angularVelocities[index];
+                    }
+                }
+
+                ++index;
+
+                ApplyPhysicsState(ref physics, ref position);
+            }
+        }
+        finally
+        {
+            ArrayPool<IntPtr>.Shared.Return(bodies);
+            ArrayPool<JVec3>.Shared.Return(positions);
+            ArrayPool<JQuat>.Shared.Return(rotations);
+            ArrayPool<JVecF3>.Shared.Return(velocities);
+            ArrayPool<JVecF3>.Shared.Return(angularVelocities);
+            ArrayPool<byte>.Shared.Return(stateFlags);
+        }
+    }
+
+    private void ApplyPhysicsState(ref Physics physics, ref WorldPosition position)
+    {
+        var body = physics.Body!;
 
         // TODO: implement this operation
         // if (physics.TeleportBodyPosition || physics.TeleportBodyRotationAlso)
@@ -53,15 +122,6 @@ public sealed class PhysicsUpdateAndPositionSystem : AEntitySetSystem<float>
         //     }
         // }
 
-        (position.Position, position.Rotation) = physicalWorld.ReadBodyPosition(body);
-
-        // TODO: it might be a good slight performance improvement to have a single native method to get both
-        // the velocities and positions with a single native method call
-        if (physics.TrackVelocity)
-        {
-            (physics.Velocity, physics.AngularVelocity) = physicalWorld.ReadBodyVelocity(body);
-        }
-
         if (EnforceYPosition && (physics.AxisLock & Physics.AxisLockType.YAxis) != 0)
         {
             // Apply fixing to Y-position if drifted too far
@@ -11,6 +11,17 @@ using Godot;
 /// </summary>
 public class PhysicalWorld : IDisposable
 {
+    /// <summary>
+    ///   Set in the state flags filled by <see cref="ReadBodyStates"/> when the body state was read successfully.
+    ///   Must match the native side PhysicsBodyStateFlagRead.
+    /// </summary>
+    public const byte BODY_STATE_FLAG_READ = 1;
+
+    /// <summary>
+    ///   Set in the state flags when the body is active (not sleeping)
+    /// </summary>
+    public const byte BODY_STATE_FLAG_ACTIVE = 2;
+
     private bool disposed;
     private bool stackAllocWarned;
     private IntPtr nativeInstance;
@@ -53,6 +64,12 @@ public class PhysicalWorld : IDisposable
     /// </summary>
     public float AveragePhysicsDuration => NativeMethods.PhysicalWorldGetPhysicsAverageTime(AccessWorldInternal());
 
+    /// <summary>
+    ///   Total time in seconds that the physics simulation has skipped due to not being allowed to run enough steps
+    ///   to catch up (see <see cref="SetSteppingPolicy"/>)
+    /// </summary>
+    public float DroppedPhysicsTime => NativeMethods.PhysicalWorldGetPhysicsDroppedTime(AccessWorldInternal());
+
     /// <summary>
     ///   Used to turn off metrics reporting when game is closing to no longer access metrics object which may be
     ///   disposed already
@@ -233,6 +250,45 @@ public class PhysicalWorld : IDisposable
         return (velocity, angularVelocity);
     }
 
+    /// <summary>
+    ///   Reads the state of multiple bodies with a single native call. This is a lot more efficient than reading the
+    ///   bodies one by one when there are many bodies. Must not be called while physics is running in the background.
+    /// </summary>
+    /// <param name="bodies">
+    ///   The bodies to read, these are the native pointers from <see cref="NativePhysicsBody.AccessBodyInternal"/>
+    /// </param>
+    /// <param name="positions">Receiver for positions, can be empty to skip reading this</param>
+    /// <param name="rotations">Receiver for rotations, can be empty to skip</param>
+    /// <param name="velocities">Receiver for linear velocities, can be empty to skip</param>
+    /// <param name="angularVelocities">Receiver for angular velocities, can be empty to skip</param>
+    /// <param name="stateFlags">
+    ///   Receiver for body state flags (<see cref="BODY_STATE_FLAG_READ"/> and <see cref="BODY_STATE_FLAG_ACTIVE"/>),
+    ///   can be empty. Entries without the read flag were not read and have zeroed out data in the other receivers.
+    /// </param>
+    /// <returns>The number of bodies that were read successfully</returns>
+    public int ReadBodyStates(ReadOnlySpan<IntPtr> bodies, Span<JVec3> positions, Span<JQuat> rotations,
+        Span<JVecF3> velocities, Span<JVecF3> angularVelocities, Span<byte> stateFlags)
+    {
+        int count = bodies.Length;
+
+        if ((!positions.IsEmpty && positions.Length < count) || (!rotations.IsEmpty && rotations.Length < count) ||
+            (!velocities.IsEmpty && velocities.Length < count) ||
+            (!angularVelocities.IsEmpty && angularVelocities.Length < count) ||
+            (!stateFlags.IsEmpty && stateFlags.Length < count))
+        {
+            throw new ArgumentException("Receiver spans must be empty or fit all of the read bodies");
+        }
+
+        if (count < 1)
+            return 0;
+
+        // Empty spans result in null pointers being passed to the native side, which means that data is skipped
+        return NativeMethods.PhysicalWorldReadBodyStatesBatch(AccessWorldInternal(),
+            in MemoryMarshal.GetReference(bodies), count, ref MemoryMarshal.GetReference(positions),
+            ref MemoryMarshal.GetReference(rotations), ref MemoryMarshal.GetReference(velocities),
+            ref MemoryMarshal.GetReference(angularVelocities), ref MemoryMarshal.GetReference(stateFlags));
+    }
+
     public void GiveImpulse(NativePhysicsBody body, Vector3 impulse, bool autoActivate)
     {
         NativeMethods.GiveImpulse(AccessWorldInternal(), body.AccessBodyInternal(), new JVecF3(impulse), autoActivate);
@@ -327,11 +383,38 @@ public class PhysicalWorld : IDisposable
             new JVecF3(angularVelocity), autoActivate);
     }
 
+    /// <summary>
+    ///   Applies all of the commands in a buffer with a single native call and then clears the buffer
+    /// </summary>
+    /// <returns>The number of applied commands</returns>
+    public int ApplyBodyCommands(PhysicsBodyCommandBuffer commandBuffer)
+    {
+        int count = commandBuffer.Count;
+
+        if (count < 1)
+            return 0;
+
+        var result = NativeMethods.PhysicalWorldApplyBodyCommands(AccessWorldInternal(),
+            in commandBuffer.AccessCommandsInternal(), count);
+
+        commandBuffer.Clear();
+        return result;
+    }
+
     public void SetBodyAllowSleep(NativePhysicsBody body, bool allowSleep)
     {
         NativeMethods.SetBodyAllowSleep(AccessWorldInternal(), body.AccessBodyInternal(), allowSleep);
     }
 
+    /// <summary>
+    ///   Enables continuous collision detection for a body. Needed for fast moving bodies (like projectiles) to not
+    ///   pass through other bodies between physics steps.
+    /// </summary>
+    public void SetBodyContinuousCollision(NativePhysicsBody body, bool enabled)
+    {
+        NativeMethods.SetBodyContinuousCollision(AccessWorldInternal(), body.AccessBodyInternal(), enabled);
+    }
+
     public bool FixBodyYCoordinateToZero(NativePhysicsBody body)
     {
         return NativeMethods.FixBodyYCoordinateToZero(AccessWorldInternal(), body.AccessBodyInternal());
@@ -490,6 +573,60 @@ public class PhysicalWorld : IDisposable
         NativeMethods.PhysicalWorldRemoveGravity(AccessWorldInternal());
     }
 
+    /// <summary>
+    ///   Makes fluid currents push the bodies that have a flow response (see <see cref="SetBodyFlowResponse"/>).
+    ///   The push is applied natively on each physics step. The world keeps the currents alive while they are used.
+    /// </summary>
+    /// <param name="currents">The currents to use, null disables the flow field</param>
+    public void SetFlowFieldCurrents(FluidCurrents? currents)
+    {
+        NativeMethods.PhysicalWorldSetFlowFieldCurrents(AccessWorldInternal(),
+            currents?.AccessCurrentsInternal() ?? IntPtr.Zero);
+    }
+
+    /// <summary>
+    ///   Uses a grid of velocities as the flow field instead of fluid currents
+    /// </summary>
+    /// <param name="velocities">
+    ///   The x and z velocity pairs of the grid points. Point (i, j) is at origin + (i, j) * spacing and has the
+    ///   index i * height + j.
+    /// </param>
+    /// <param name="width">Number of grid points along the x-axis, below 2 disables the flow field</param>
+    /// <param name="height">Number of grid points along the z-axis</param>
+    /// <param name="origin">World position (x, z) of the first grid point</param>
+    /// <param name="spacing">Distance between the grid points</param>
+    public void SetFlowFieldGrid(ReadOnlySpan<float> velocities, int width, int height, Vector2 origin,
+        float spacing)
+    {
+        if (width > 1 && height > 1 && velocities.Length < width * height * 2)
+            throw new ArgumentException("Not enough velocities for the grid size", nameof(velocities));
+
+        NativeMethods.PhysicalWorldSetFlowFieldGrid(AccessWorldInternal(), in MemoryMarshal.GetReference(velocities),
+            width, height, origin.X, origin.Y, spacing);
+    }
+
+    /// <summary>
+    ///   Sets the time the flow field currents are calculated at. This is safe to call while physics is running.
+    /// </summary>
+    public void SetFlowFieldTime(float time)
+    {
+        NativeMethods.PhysicalWorldSetFlowFieldTime(AccessWorldInternal(), time);
+    }
+
+    /// <summary>
+    ///   Sets how the flow field affects a body. The response is kept while a body is detached.
+    /// </summary>
+    /// <param name="body">The body to set the response for</param>
+    /// <param name="forceMultiplier">Flow velocity is multiplied by this to get the force applied to the body</param>
+    /// <param name="drag">
+    ///   How large fraction per second of the difference between the flow velocity and the body velocity is removed.
+    ///   When both this and <paramref name="forceMultiplier"/> are 0 the flow doesn't affect the body.
+    /// </param>
+    public void SetBodyFlowResponse(NativePhysicsBody body, float forceMultiplier, float drag = 0)
+    {
+        NativeMethods.SetBodyFlowResponse(AccessWorldInternal(), body.AccessBodyInternal(), forceMultiplier, drag);
+    }
+
     /// <summary>
     ///   Casts a ray from start to (start + directionAndLength) collecting all hit objects in results
     /// </summary>
@@ -503,6 +640,90 @@ public class PhysicalWorld : IDisposable
             new JVecF3(directionAndLength), ref results[0], results.Length);
     }
 
+    /// <summary>
+    ///   Finds bodies whose bounding boxes overlap a sphere. Uses only the physics broadphase so this is a lot cheaper
+    ///   than checking distances to all entities.
+    /// </summary>
+    /// <param name="center">Center of the sphere</param>
+    /// <param name="radius">Radius of the sphere</param>
+    /// <param name="results">
+    ///   Filled with the found bodies. The hit fraction of the results is the distance from the center to the body
+    ///   position. Needs to have size greater than 0.
+    /// </param>
+    /// <param name="filter">Filter for the bodies to include</param>
+    /// <returns>The number of found bodies in results</returns>
+    public int CollideSphere(Vector3 center, float radius, PhysicsRayWithUserData[] results,
+        in PhysicsBodyQueryFilter filter = default)
+    {
+        return NativeMethods.PhysicalWorldCollideSphere(AccessWorldInternal(), new JVec3(center), radius,
+            ref results[0], results.Length, filter);
+    }
+
+    /// <summary>
+    ///   Variant of <see cref="CollideSphere"/> for an axis aligned box. The hit fraction is the distance from the
+    ///   box center.
+    /// </summary>
+    public int CollideAABox(Vector3 min, Vector3 max, PhysicsRayWithUserData[] results,
+        in PhysicsBodyQueryFilter filter = default)
+    {
+        return NativeMethods.PhysicalWorldCollideAABox(AccessWorldInternal(), new JVec3(min), new JVec3(max),
+            ref results[0], results.Length, filter);
+    }
+
+    /// <summary>
+    ///   Finds the bodies that have their position nearest to the given position (up to the size of results)
+    /// </summary>
+    /// <returns>The number of found bodies. Results are sorted by the distance, which is in the hit fraction</returns>
+    public int FindNearestBodies(Vector3 position, float maxDistance, PhysicsRayWithUserData[] results,
+        in PhysicsBodyQueryFilter filter = default)
+    {
+        return NativeMethods.PhysicalWorldFindNearestBodies(AccessWorldInternal(), new JVec3(position), maxDistance,
+            ref results[0], results.Length, filter);
+    }
+
+    /// <summary>
+    ///   Runs a batch of ray, sphere overlap and shape cast queries. Large batches are spread over the native task
+    ///   threads. Returns once all of the queries are done.
+    /// </summary>
+    /// <param name="queries">
+    ///   The queries to run, <see cref="PhysicsQuery.ResultCount"/> is set in each one to its number of results
+    /// </param>
+    /// <param name="results">Shared result storage, each query writes only to its own slice</param>
+    /// <returns>The total number of results</returns>
+    public int RunQueryBatch(Span<PhysicsQuery> queries, PhysicsRayWithUserData[] results)
+    {
+        if (queries.Length < 1)
+            return 0;
+
+        return NativeMethods.PhysicalWorldRunQueryBatch(AccessWorldInternal(), ref queries[0], queries.Length,
+            ref results[0], results.Length);
+    }
+
+    /// <summary>
+    ///   Moves a shape from start along directionAndLength and finds the bodies it hits (up to the size of results)
+    /// </summary>
+    /// <returns>The number of hits, sorted so that the closest one is first</returns>
+    public int CastShape(PhysicsShape shape, Vector3 start, Quaternion rotation, Vector3 directionAndLength,
+        PhysicsShapeCastHit[] results, in PhysicsBodyQueryFilter filter = default)
+    {
+        return NativeMethods.PhysicalWorldCastShape(AccessWorldInternal(), shape.AccessShapeInternal(),
+            new JVec3(start), new JQuat(rotation), new JVecF3(directionAndLength), ref results[0], results.Length,
+            filter);
+    }
+
+    /// <summary>
+    ///   Batched variant of <see cref="CastShape"/>. Works like <see cref="RunQueryBatch"/> but all of the queries
+    ///   must be shape casts.
+    /// </summary>
+    public int CastShapeBatch(Span<PhysicsQuery> queries, PhysicsShapeCastHit[] results)
+    {
+        if (queries.Length < 1)
+            return 0;
+
+        return NativeMethods.PhysicalWorldCastShapeBatch(AccessWorldInternal(), ref queries[0], queries.Length,
+            ref results[0], results.Length);
+    }
+
     /// <summary>
     ///   Variant of raycast that automatically rents an array from the buffer pool, which must be returned with
     ///   <see cref="ReturnRayCastBuffer"/> after use.
@@ -523,11 +744,59 @@ public class PhysicalWorld : IDisposable
         ArrayPool<PhysicsRayWithUserData>.Shared.Return(buffer);
     }
 
+    /// <summary>
+    ///   Configures how physics catches up when a lot of time has accumulated (for example after a lag spike)
+    /// </summary>
+    /// <param name="maxStepsPerProcess">Max steps per physics process call, 0 for unlimited</param>
+    /// <param name="mergeExcessSteps">
+    ///   If true the excess time is simulated as a single longer step instead of being dropped
+    /// </param>
+    /// <param name="maxMergedSteps">How many normal length steps can be merged into one at most</param>
+    public void SetSteppingPolicy(int maxStepsPerProcess, bool mergeExcessSteps, int maxMergedSteps = 4)
+    {
+        NativeMethods.PhysicalWorldSetSteppingPolicy(AccessWorldInternal(), maxStepsPerProcess, mergeExcessSteps,
+            maxMergedSteps);
+    }
+
+    /// <summary>
+    ///   Reads the statistics of the latest physics updates
+    /// </summary>
+    /// <param name="receiver">Filled with the statistics, newest first. Needs to have size greater than 0</param>
+    /// <returns>The number of entries written to receiver</returns>
+    public int GetStepStatistics(PhysicsStepStatistics[] receiver)
+    {
+        return NativeMethods.PhysicalWorldGetStepStatistics(AccessWorldInternal(), ref receiver[0], receiver.Length);
+    }
+
+    /// <summary>
+    ///   Enables collecting the contact counters and callback time in <see cref="PhysicsStepStatistics"/>. This
+    ///   adds a small cost to each contact callback.
+    /// </summary>
+    public void SetContactStatisticsEnabled(bool enabled)
+    {
+        NativeMethods.PhysicalWorldSetContactStatisticsEnabled(AccessWorldInternal(), enabled);
+    }
+
     public bool DumpPhysicsState(string path)
     {
         return NativeMethods.PhysicalWorldDumpPhysicsState(AccessWorldInternal(), path);
     }
 
+    /// <summary>
+    ///   Dumps the current physics state and starts recording all operations affecting the simulation. The dump and
+    ///   the recording can then be replayed with the native replay tool without the game.
+    /// </summary>
+    /// <returns>True if recording started</returns>
+    public bool StartReplayRecording(string dumpPath, string recordingPath)
+    {
+        return NativeMethods.PhysicalWorldStartReplayRecording(AccessWorldInternal(), dumpPath, recordingPath);
+    }
+
+    public void StopReplayRecording()
+    {
+        NativeMethods.PhysicalWorldStopReplayRecording(AccessWorldInternal());
+    }
+
     public void Dispose()
     {
         Dispose(true);
@@ -641,6 +910,11 @@ internal static partial class NativeMethods
     internal static extern void ReadPhysicsBodyVelocity(IntPtr world, IntPtr body, [Out] out JVecF3 velocity,
         [Out] out JVecF3 angularVelocity);
 
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldReadBodyStatesBatch(IntPtr world, in IntPtr bodies, int count,
+        ref JVec3 positions, ref JQuat rotations, ref JVecF3 velocities, ref JVecF3 angularVelocities,
+        ref byte stateFlags);
+
     [DllImport("thrive_native")]
     internal static extern void GiveImpulse(IntPtr world, IntPtr body, JVecF3 impulse, bool autoActivate);
 
@@ -675,6 +949,13 @@ internal static partial class NativeMethods
     [DllImport("thrive_native")]
     internal static extern void SetBodyAllowSleep(IntPtr world, IntPtr body, bool allowSleep);
 
+    [DllImport("thrive_native")]
+    internal static extern void SetBodyContinuousCollision(IntPtr world, IntPtr body, bool enabled);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldApplyBodyCommands(IntPtr world, in PhysicsBodyCommand commands,
+        int count);
+
     [DllImport("thrive_native")]
     internal static extern bool FixBodyYCoordinateToZero(IntPtr world, IntPtr body);
 
@@ -728,19 +1009,79 @@ internal static partial class NativeMethods
     [DllImport("thrive_native")]
     internal static extern void PhysicalWorldRemoveGravity(IntPtr physicalWorld);
 
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldSetFlowFieldCurrents(IntPtr physicalWorld, IntPtr currents);
+
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldSetFlowFieldGrid(IntPtr physicalWorld, in float velocities, int width,
+        int height, float originX, float originZ, float spacing);
+
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldSetFlowFieldTime(IntPtr physicalWorld, float time);
+
+    [DllImport("thrive_native")]
+    internal static extern void SetBodyFlowResponse(IntPtr physicalWorld, IntPtr body, float forceMultiplier,
+        float drag);
+
     [DllImport("thrive_native")]
     internal static extern int PhysicalWorldCastRayGetAll(IntPtr physicalWorld, JVec3 start,
         JVecF3 endOffset, ref PhysicsRayWithUserData dataReceiver, int maxHits);
 
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldCollideSphere(IntPtr physicalWorld, JVec3 center, float radius,
+        ref PhysicsRayWithUserData dataReceiver, int maxHits, in PhysicsBodyQueryFilter filter);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldCollideAABox(IntPtr physicalWorld, JVec3 min, JVec3 max,
+        ref PhysicsRayWithUserData dataReceiver, int maxHits, in PhysicsBodyQueryFilter filter);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldFindNearestBodies(IntPtr physicalWorld, JVec3 position,
+        float maxDistance, ref PhysicsRayWithUserData dataReceiver, int maxCount, in PhysicsBodyQueryFilter filter);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldRunQueryBatch(IntPtr physicalWorld, ref PhysicsQuery queries,
+        int queryCount, ref PhysicsRayWithUserData results, int resultCapacity);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldCastShape(IntPtr physicalWorld, IntPtr shape, JVec3 start,
+        JQuat rotation, JVecF3 directionAndLength, ref PhysicsShapeCastHit dataReceiver, int maxHits,
+        in PhysicsBodyQueryFilter filter);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldCastShapeBatch(IntPtr physicalWorld, ref PhysicsQuery queries,
+        int queryCount, ref PhysicsShapeCastHit results, int resultCapacity);
+
     [DllImport("thrive_native")]
     internal static extern float PhysicalWorldGetPhysicsLatestTime(IntPtr physicalWorld);
 
     [DllImport("thrive_native")]
     internal static extern float PhysicalWorldGetPhysicsAverageTime(IntPtr physicalWorld);
 
+    [DllImport("thrive_native")]
+    internal static extern float PhysicalWorldGetPhysicsDroppedTime(IntPtr physicalWorld);
+
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldSetSteppingPolicy(IntPtr physicalWorld, int maxStepsPerProcess,
+        bool mergeExcessSteps, int maxMergedSteps);
+
+    [DllImport("thrive_native")]
+    internal static extern int PhysicalWorldGetStepStatistics(IntPtr physicalWorld,
+        ref PhysicsStepStatistics receiver, int maxCount);
+
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldSetContactStatisticsEnabled(IntPtr physicalWorld, bool enabled);
+
     [DllImport("thrive_native", CharSet = CharSet.Ansi, BestFitMapping = false)]
     internal static extern bool PhysicalWorldDumpPhysicsState(IntPtr physicalWorld, string path);
 
+    [DllImport("thrive_native", CharSet = CharSet.Ansi, BestFitMapping = false)]
+    internal static extern bool PhysicalWorldStartReplayRecording(IntPtr physicalWorld, string dumpPath,
+        string recordingPath);
+
+    [DllImport("thrive_native")]
+    internal static extern void PhysicalWorldStopReplayRecording(IntPtr physicalWorld);
+
     [DllImport("thrive_native")]
     internal static extern void PhysicalWorldSetDebugDrawLevel(IntPtr physicalWorld, int level);
 
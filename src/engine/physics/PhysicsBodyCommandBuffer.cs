@@ -0,0 +1,152 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using Godot;
+
+/// <summary>
+///   Type of a physics body modification command. Must match the native side PhysicsBodyCommandType.
+/// </summary>
+public enum PhysicsBodyCommandType
+{
+    None = 0,
+    GiveImpulse = 1,
+    GiveAngularImpulse = 2,
+    SetVelocity = 3,
+    SetAngularVelocity = 4,
+    SetVelocityAndAngularVelocity = 5,
+    SetPosition = 6,
+    SetPositionAndRotation = 7,
+    SetLinearDamping = 8,
+    SetLinearAndAngularDamping = 9,
+}
+
+/// <summary>
+///   A single queued body modification. Must match the byte layout of the native side PhysicsBodyCommand.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct PhysicsBodyCommand
+{
+    public const int FLAG_ACTIVATE = 1;
+
+    public IntPtr Body;
+    public JVec3 Position;
+    public JQuat Rotation;
+    public JVecF3 Vector;
+    public float Value;
+    public JVecF3 SecondVector;
+    public float SecondValue;
+    public PhysicsBodyCommandType Type;
+    public int Flags;
+}
+
+/// <summary>
+///   Collects physics body modifications to be applied all at once with
+///   <see cref="PhysicalWorld.ApplyBodyCommands"/>. This is much more efficient than calling the individual
+///   modification methods when a lot of bodies are modified.
+/// </summary>
+/// <remarks>
+///   <para>
+///     This is not thread safe, each thread needs to use its own buffer. The native pointers of the bodies are stored
+///     in this so the bodies must not be destroyed before this buffer is applied or cleared.
+///   </para>
+/// </remarks>
+public class PhysicsBodyCommandBuffer
+{
+    private PhysicsBodyCommand[] commands;
+    private int count;
+
+    public PhysicsBodyCommandBuffer(int initialCapacity = 32)
+    {
+        commands = new PhysicsBodyCommand[Math.Max(initialCapacity, 1)];
+    }
+
+    public int Count => count;
+
+    public void GiveImpulse(NativePhysicsBody body, Vector3 impulse, bool autoActivate)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.GiveImpulse, autoActivate);
+        command.Vector = new JVecF3(impulse);
+    }
+
+    public void GiveAngularImpulse(NativePhysicsBody body, Vector3 angularImpulse, bool autoActivate)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.GiveAngularImpulse, autoActivate);
+        command.Vector = new JVecF3(angularImpulse);
+    }
+
+    public void SetBodyVelocity(NativePhysicsBody body, Vector3 velocity, Vector3 angularVelocity,
+        bool autoActivate = true)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.SetVelocityAndAngularVelocity, autoActivate);
+        command.Vector = new JVecF3(velocity);
+        command.SecondVector = new JVecF3(angularVelocity);
+    }
+
+    public void SetOnlyBodyVelocity(NativePhysicsBody body, Vector3 velocity, bool autoActivate = true)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.SetVelocity, autoActivate);
+        command.Vector = new JVecF3(velocity);
+    }
+
+    public void SetOnlyBodyAngularVelocity(NativePhysicsBody body, Vector3 angularVelocity, bool autoActivate = true)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.SetAngularVelocity, autoActivate);
+        command.Vector = new JVecF3(angularVelocity);
+    }
+
+    public void SetBodyPosition(NativePhysicsBody body, Vector3 position, bool activate = true)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.SetPosition, activate);
+        command.Position = new JVec3(position);
+    }
+
+    public void SetBodyPositionAndRotation(NativePhysicsBody body, Vector3 position, Quaternion rotation,
+        bool activate = true)
+    {
+        ref var command = ref Add(body, PhysicsBodyCommandType.SetPositionAndRotation, activate);
+        command.Position = new JVec3(position);
+        command.Rotation = new JQuat(rotation);
+    }
+
+    public void SetDamping(NativePhysicsBody body, float linearDamping, float? angularDamping = null)
+    {
+        if (angularDamping != null)
+        {
+            ref var command = ref Add(body, PhysicsBodyCommandType.SetLinearAndAngularDamping, false);
+            command.Value = linearDamping;
+            command.SecondValue = angularDamping.Value;
+        }
+        else
+        {
+            ref var command = ref Add(body, PhysicsBodyCommandType.SetLinearDamping, false);
+            command.Value = linearDamping;
+        }
+    }
+
+    public void Clear()
+    {
+        count = 0;
+    }
+
+    /// <summary>
+    ///   Access to the raw command data for sending to the native side
+    /// </summary>
+    internal ref PhysicsBodyCommand AccessCommandsInternal()
+    {
+        return ref commands[0];
+    }
+
+    private ref PhysicsBodyCommand Add(NativePhysicsBody body, PhysicsBodyCommandType type, bool activate)
+    {
+        if (count >= commands.Length)
+            Array.Resize(ref commands, commands.Length * 2);
+
+        ref var command = ref commands[count++];
+
+        command = default(PhysicsBodyCommand);
+        command.Body = body.AccessBodyInternal();
+        command.Type = type;
+        command.Flags = activate ? PhysicsBodyCommand.FLAG_ACTIVATE : 0;
+
+        return ref command;
+    }
+}
@@ -0,0 +1,36 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+/// <summary>
+///   Filtering for physics body queries like <see cref="PhysicalWorld.CollideSphere"/>. Must match the native side
+///   PhysicsBodyQueryFilter byte layout. The default value doesn't filter out anything.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct PhysicsBodyQueryFilter
+{
+    /// <summary>
+    ///   Only bodies where the user data (as a 64-bit number) masked with this equals <see cref="UserDataValue"/>
+    ///   are included
+    /// </summary>
+    public ulong UserDataMask;
+
+    public ulong UserDataValue;
+
+    /// <summary>
+    ///   Native pointer of a body to never include in the results, for example the body of the entity doing the query
+    /// </summary>
+    public IntPtr IgnoredBody;
+
+    /// <summary>
+    ///   Bit for each physics object layer to include, 0 includes all layers
+    /// </summary>
+    public uint LayerMask;
+
+    public PhysicsBodyQueryFilter(NativePhysicsBody? ignoredBody, uint layerMask = 0)
+    {
+        UserDataMask = 0;
+        UserDataValue = 0;
+        IgnoredBody = ignoredBody?.AccessBodyInternal() ?? IntPtr.Zero;
+        LayerMask = layerMask;
+    }
+}
@@ -0,0 +1,104 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using Godot;
+
+/// <summary>
+///   Kind of a query in a query batch. Must match the native side PhysicsQueryType.
+/// </summary>
+public enum PhysicsQueryType
+{
+    Ray = 0,
+    SphereOverlap = 1,
+    ShapeCast = 2,
+}
+
+/// <summary>
+///   A single query for <see cref="PhysicalWorld.RunQueryBatch"/>. Must match the byte layout of the native side
+///   PhysicsQuery.
+/// </summary>
+/// <remarks>
+///   <para>
+///     All queries in a batch share a single result array. Each query writes its results to the part of it starting
+///     at <see cref="ResultOffset"/> and at most <see cref="MaxResults"/> long.
+///   </para>
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct PhysicsQuery
+{
+    public JVec3 Position;
+    public JQuat Rotation;
+    public JVecF3 Vector;
+    public float Radius;
+
+    /// <summary>
+    ///   Native pointer of the shape for shape casts. The shape must be kept alive until the batch has been ran.
+    /// </summary>
+    public IntPtr Shape;
+
+    public PhysicsBodyQueryFilter Filter;
+    public int ResultOffset;
+    public int MaxResults;
+    public PhysicsQueryType Type;
+
+    /// <summary>
+    ///   Set by the native side to the number of results this query wrote
+    /// </summary>
+    public int ResultCount;
+
+    /// <summary>
+    ///   Ray cast from start to start + directionAndLength. The hit fraction is the fraction along the ray.
+    /// </summary>
+    public static PhysicsQuery Ray(Vector3 start, Vector3 directionAndLength, int resultOffset, int maxResults,
+        in PhysicsBodyQueryFilter filter = default)
+    {
+        return new PhysicsQuery
+        {
+            Type = PhysicsQueryType.Ray,
+            Position = new JVec3(start),
+            Rotation = JQuat.Identity,
+            Vector = new JVecF3(directionAndLength),
+            Filter = filter,
+            ResultOffset = resultOffset,
+            MaxResults = maxResults,
+        };
+    }
+
+    /// <summary>
+    ///   Finds bodies whose shape overlaps a sphere. Unlike <see cref="PhysicalWorld.CollideSphere"/> this checks the
+    ///   exact body shapes. The hit fraction is the penetration depth.
+    /// </summary>
+    public static PhysicsQuery SphereOverlap(Vector3 center, float radius, int resultOffset, int maxResults,
+        in PhysicsBodyQueryFilter filter = default)
+    {
+        return new PhysicsQuery
+        {
+            Type = PhysicsQueryType.SphereOverlap,
+            Position = new JVec3(center),
+            Rotation = JQuat.Identity,
+            Radius = radius,
+            Filter = filter,
+            ResultOffset = resultOffset,
+            MaxResults = maxResults,
+        };
+    }
+
+    /// <summary>
+    ///   Moves a shape from a start position along directionAndLength and finds what it hits. The hit fraction is
+    ///   the fraction along the movement.
+    /// </summary>
+    public static PhysicsQuery ShapeCast(PhysicsShape shape, Vector3 start, Quaternion rotation,
+        Vector3 directionAndLength, int resultOffset, int maxResults, in PhysicsBodyQueryFilter filter = default)
+    {
+        return new PhysicsQuery
+        {
+            Type = PhysicsQueryType.ShapeCast,
+            Shape = shape.AccessShapeInternal(),
+            Position = new JVec3(start),
+            Rotation = new JQuat(rotation),
+            Vector = new JVecF3(directionAndLength),
+            Filter = filter,
+            ResultOffset = resultOffset,
+            MaxResults = maxResults,
+        };
+    }
+}
@@ -52,22 +52,12 @@ public class PhysicsShape : IDisposable
     public static PhysicsShape GetOrCreateMicrobeShape(IReadOnlyList<Vector2> membranePoints, int pointCount,
         float overallDensity, bool scaleAsBacteria)
     {
-        var cache = ProceduralDataCache.Instance;
-
-        var hash = MembraneCollisionShape.ComputeMicrobeShapeCacheHash(membranePoints, pointCount,
-            overallDensity, scaleAsBacteria);
+        var cached = TryGetCachedMicrobeShape(membranePoints, pointCount, overallDensity, scaleAsBacteria);
 
-        var result = cache.ReadMembraneCollisionShape(hash);
-
-        if (result != null)
-        {
-            if (result.MatchesCacheParameters(membranePoints, pointCount, overallDensity, scaleAsBacteria))
-            {
-                return result.Shape;
-            }
+        if (cached != null)
+            return cached;
 
-            CacheableDataExtensions.OnCacheHashCollision<MembraneCollisionShape>(hash);
-        }
+        var cache = ProceduralDataCache.Instance;
 
         // Need to convert the data to call the method that uses the native side to create the body
         // TODO: find out if a more performant way can be done to copy this data or not (luckily only needed when cache
@@ -80,7 +70,7 @@ public class PhysicsShape : IDisposable
         }
 
         // The rented array from the pool will be returned when the cache entry is disposed
-        result = new MembraneCollisionShape(
+        var result = new MembraneCollisionShape(
             CreateMicrobeShape(new ReadOnlySpan<JVecF3>(convertedData, 0, pointCount), overallDensity, scaleAsBacteria),
             convertedData, pointCount, overallDensity, scaleAsBacteria);
 
@@ -89,6 +79,45 @@ public class PhysicsShape : IDisposable
         return result.Shape;
     }
 
+    /// <summary>
+    ///   Variant of <see cref="GetOrCreateMicrobeShape"/> that builds the shape in the background when it is not
+    ///   already cached
+    /// </summary>
+    /// <param name="membranePoints">Membrane points to build the shape from</param>
+    /// <param name="pointCount">How many of the points are used</param>
+    /// <param name="overallDensity">Density of the shape</param>
+    /// <param name="scaleAsBacteria">True to scale the shape down for bacteria</param>
+    /// <param name="cachedShape">Set to the cached shape if there is one, in which case no build is started</param>
+    /// <returns>The started build or null if the shape was found in the cache</returns>
+    public static PhysicsShapeBuildTask? GetCachedOrStartMicrobeShapeBuild(IReadOnlyList<Vector2> membranePoints,
+        int pointCount, float overallDensity, bool scaleAsBacteria, out PhysicsShape? cachedShape)
+    {
+        cachedShape = TryGetCachedMicrobeShape(membranePoints, pointCount, overallDensity, scaleAsBacteria);
+
+        if (cachedShape != null)
+            return null;
+
+        var pool = ArrayPool<JVecF3>.Shared;
+        var convertedData = pool.Rent(pointCount);
+
+        try
+        {
+            for (int i = 0; i < pointCount; ++i)
+            {
+                convertedData[i] = new JVecF3(membranePoints[i].X, 0, membranePoints[i].Y);
+            }
+
+            // The native side copies the points so the array can be returned right away. Repeated builds of the same
+            // membrane share the shape through the native shape cache.
+            return StartMicrobeShapeBuild(new ReadOnlySpan<JVecF3>(convertedData, 0, pointCount), overallDensity,
+                scaleAsBacteria);
+        }
+        finally
+        {
+            pool.Return(convertedData);
+        }
+    }
+
     public static PhysicsShape CreateMicrobeShape(ReadOnlySpan<JVecF3> organellePositions, float overallDensity,
         bool scaleAsBacteria, bool createAsSpheres = false)
     {
@@ -131,6 +160,54 @@ public class PhysicsShape : IDisposable
         }
     }
 
+    /// <summary>
+    ///   Starts building a microbe shape in the background. The points are copied so the span doesn't need to stay
+    ///   valid after this returns.
+    /// </summary>
+    /// <returns>Task to poll for the built shape</returns>
+    public static PhysicsShapeBuildTask StartMicrobeShapeBuild(ReadOnlySpan<JVecF3> organellePositions,
+        float overallDensity, bool scaleAsBacteria)
+    {
+        return new PhysicsShapeBuildTask(NativeMethods.StartMicrobeShapeConvexBuild(
+            MemoryMarshal.GetReference(organellePositions), (uint)organellePositions.Length, overallDensity,
+            scaleAsBacteria ? 0.5f : 1));
+    }
+
+    public static PhysicsShapeBuildTask StartConvexShapeBuild(ReadOnlySpan<JVecF3> points, float density,
+        float scale = 1, float convexRadius = 0.01f)
+    {
+        return new PhysicsShapeBuildTask(NativeMethods.StartConvexShapeBuild(MemoryMarshal.GetReference(points),
+            (uint)points.Length, density, scale, convexRadius));
+    }
+
+    /// <summary>
+    ///   Background building variant of <see cref="CreateCombinedShapeStatic"/>. The sub-shapes are kept alive by the
+    ///   native side until the build is done.
+    /// </summary>
+    public static PhysicsShapeBuildTask StartCombinedShapeStaticBuild(
+        IReadOnlyList<(PhysicsShape Shape, Vector3 Position, Quaternion Rotation)> subShapes)
+    {
+        var pool = ArrayPool<SubShapeDefinition>.Shared;
+
+        var count = subShapes.Count;
+        var buffer = pool.Rent(count);
+
+        try
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                var data = subShapes[i];
+                buffer[i] = new SubShapeDefinition(data.Position, data.Rotation, data.Shape.AccessShapeInternal());
+            }
+
+            return new PhysicsShapeBuildTask(NativeMethods.StartStaticCompoundShapeBuild(buffer[0], (uint)count));
+        }
+        finally
+        {
+            pool.Return(buffer);
+        }
+    }
+
     /// <summary>
     ///   Loads a physics shape from a Godot resource
     /// </summary>
@@ -245,6 +322,29 @@ public class PhysicsShape : IDisposable
         return cached;
     }
 
+    /// <summary>
+    ///   Sets how many shapes the native shape cache keeps. The native cache shares identical point based shapes
+    ///   (microbe and convex shapes) between all users. 0 disables the cache.
+    /// </summary>
+    public static void SetNativeShapeCacheSize(int maxEntries)
+    {
+        NativeMethods.SetShapeCacheMaxEntries(maxEntries);
+    }
+
+    /// <summary>
+    ///   Releases the native cached shapes that are not currently used by anything
+    /// </summary>
+    public static void ClearUnusedNativeCachedShapes()
+    {
+        NativeMethods.ClearUnusedCachedShapes();
+    }
+
+    public static ShapeCacheStatistics GetNativeShapeCacheStatistics()
+    {
+        NativeMethods.GetShapeCacheStatistics(out var statistics);
+        return statistics;
+    }
+
     /// <summary>
     ///   Gets the mass of this shape, unit size of normal density has mass of 1000 so in most cases the mass should be
     ///   divided by 1000 for processing purposes (though physics forces will work correctly with unadjusted values)
@@ -297,6 +397,14 @@ public class PhysicsShape : IDisposable
         GC.SuppressFinalize(this);
     }
 
+    /// <summary>
+    ///   Wraps a native shape reference that was given to the C# side (for example by a shape build task)
+    /// </summary>
+    internal static PhysicsShape WrapNativeShape(IntPtr nativeInstance)
+    {
+        return new PhysicsShape(nativeInstance);
+    }
+
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     internal IntPtr AccessShapeInternal()
     {
@@ -315,6 +423,24 @@ public class PhysicsShape : IDisposable
         }
     }
 
+    private static PhysicsShape? TryGetCachedMicrobeShape(IReadOnlyList<Vector2> membranePoints, int pointCount,
+        float overallDensity, bool scaleAsBacteria)
+    {
+        var hash = MembraneCollisionShape.ComputeMicrobeShapeCacheHash(membranePoints, pointCount,
+            overallDensity, scaleAsBacteria);
+
+        var result = ProceduralDataCache.Instance.ReadMembraneCollisionShape(hash);
+
+        if (result == null)
+            return null;
+
+        if (result.MatchesCacheParameters(membranePoints, pointCount, overallDensity, scaleAsBacteria))
+            return result.Shape;
+
+        CacheableDataExtensions.OnCacheHashCollision<MembraneCollisionShape>(hash);
+        return null;
+    }
+
     private void ReleaseUnmanagedResources()
     {
         if (nativeInstance.ToInt64() != 0)
@@ -363,6 +489,15 @@ internal static partial class NativeMethods
     [DllImport("thrive_native")]
     internal static extern void ReleaseShape(IntPtr shape);
 
+    [DllImport("thrive_native")]
+    internal static extern void SetShapeCacheMaxEntries(int maxEntries);
+
+    [DllImport("thrive_native")]
+    internal static extern void ClearUnusedCachedShapes();
+
+    [DllImport("thrive_native")]
+    internal static extern void GetShapeCacheStatistics(out ShapeCacheStatistics statistics);
+
     [DllImport("thrive_native")]
     internal static extern float ShapeGetMass(IntPtr shape);
 
@@ -0,0 +1,161 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+/// <summary>
+///   State of a shape being built in the background. Must match the native side ShapeBuildTaskState.
+/// </summary>
+public enum ShapeBuildTaskState
+{
+    Queued = 0,
+    Building = 1,
+    Completed = 2,
+    Failed = 3,
+}
+
+/// <summary>
+///   A physics shape that is being built in the background by the native task system. Started with the
+///   <c>Start...Build</c> methods in <see cref="PhysicsShape"/>.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The build can be polled with <see cref="IsCompleted"/> each update and the shape taken with
+///     <see cref="TryGetShape"/> once it is ready. If the shape is needed right away <see cref="Wait"/> can be used
+///     instead. Disposing this before the build is done is allowed, the built shape is then just discarded.
+///   </para>
+/// </remarks>
+public class PhysicsShapeBuildTask : IDisposable
+{
+    private bool disposed;
+    private IntPtr nativeInstance;
+
+    private PhysicsShape? result;
+
+    internal PhysicsShapeBuildTask(IntPtr nativeInstance)
+    {
+        if (nativeInstance.ToInt64() == 0)
+            throw new ArgumentException("Failed to start shape build");
+
+        this.nativeInstance = nativeInstance;
+    }
+
+    ~PhysicsShapeBuildTask()
+    {
+        Dispose(false);
+    }
+
+    public ShapeBuildTaskState State
+    {
+        get
+        {
+            if (result != null)
+                return ShapeBuildTaskState.Completed;
+
+            return NativeMethods.ShapeBuildTaskGetState(AccessTaskInternal());
+        }
+    }
+
+    /// <summary>
+    ///   True once the build has finished, either successfully or by failing
+    /// </summary>
+    public bool IsCompleted => State is ShapeBuildTaskState.Completed or ShapeBuildTaskState.Failed;
+
+    public bool Disposed => disposed;
+
+    /// <summary>
+    ///   Gets the built shape if it is ready
+    /// </summary>
+    /// <param name="shape">The built shape, the caller is responsible for disposing it</param>
+    /// <returns>True when the shape was ready</returns>
+    public bool TryGetShape(out PhysicsShape? shape)
+    {
+        if (result == null)
+        {
+            var nativeShape = NativeMethods.ShapeBuildTaskTakeResult(AccessTaskInternal());
+
+            if (nativeShape.ToInt64() != 0)
+                result = PhysicsShape.WrapNativeShape(nativeShape);
+        }
+
+        shape = result;
+        return shape != null;
+    }
+
+    /// <summary>
+    ///   Blocks until the shape is built. If the build hasn't been started by a background thread yet it is done on
+    ///   the calling thread.
+    /// </summary>
+    /// <returns>The built shape or null if building failed</returns>
+    public PhysicsShape? Wait()
+    {
+        if (result != null)
+            return result;
+
+        var nativeShape = NativeMethods.ShapeBuildTaskWait(AccessTaskInternal());
+
+        if (nativeShape.ToInt64() != 0)
+            result = PhysicsShape.WrapNativeShape(nativeShape);
+
+        return result;
+    }
+
+    public void Dispose()
+    {
+        Dispose(true);
+        GC.SuppressFinalize(this);
+    }
+
+    protected virtual void Dispose(bool disposing)
+    {
+        ReleaseUnmanagedResources();
+        if (disposing)
+        {
+            disposed = true;
+        }
+    }
+
+    private IntPtr AccessTaskInternal()
+    {
+        if (disposed)
+            throw new ObjectDisposedException(nameof(PhysicsShapeBuildTask));
+
+        return nativeInstance;
+    }
+
+    private void ReleaseUnmanagedResources()
+    {
+        if (nativeInstance.ToInt64() != 0)
+        {
+            NativeMethods.ReleaseShapeBuildTask(nativeInstance);
+            nativeInstance = new IntPtr(0);
+        }
+    }
+}
+
+/// <summary>
+///   Thrive native library methods related to building physics shapes in the background
+/// </summary>
+internal static partial class NativeMethods
+{
+    [DllImport("thrive_native")]
+    internal static extern IntPtr StartMicrobeShapeConvexBuild(in JVecF3 microbePoints, uint pointCount,
+        float density, float scale, float thickness = 1);
+
+    [DllImport("thrive_native")]
+    internal static extern IntPtr StartConvexShapeBuild(in JVecF3 convexPoints, uint pointCount, float density,
+        float scale = 1, float convexRadius = 0.01f);
+
+    [DllImport("thrive_native")]
+    internal static extern IntPtr StartStaticCompoundShapeBuild(in SubShapeDefinition subShapes, uint shapeCount);
+
+    [DllImport("thrive_native")]
+    internal static extern ShapeBuildTaskState ShapeBuildTaskGetState(IntPtr task);
+
+    [DllImport("thrive_native")]
+    internal static extern IntPtr ShapeBuildTaskTakeResult(IntPtr task);
+
+    [DllImport("thrive_native")]
+    internal static extern IntPtr ShapeBuildTaskWait(IntPtr task);
+
+    [DllImport("thrive_native")]
+    internal static extern void ReleaseShapeBuildTask(IntPtr task);
+}
@@ -0,0 +1,41 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using DefaultEcs;
+
+/// <summary>
+///   A shape cast hit with the full contact info. Must match the native side PhysicsShapeCastHit byte layout.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct PhysicsShapeCastHit
+{
+    /// <summary>
+    ///   Contact point on the surface of the hit body in world space
+    /// </summary>
+    public readonly JVec3 ContactPoint;
+
+    /// <summary>
+    ///   Surface normal of the hit body at the contact point, points towards the cast shape
+    /// </summary>
+    public readonly JVecF3 Normal;
+
+    /// <summary>
+    ///   Fraction of the cast movement at which the hit happened. 0 when the shape was already overlapping the body
+    ///   at the start of the cast.
+    /// </summary>
+    public readonly float Fraction;
+
+    /// <summary>
+    ///   Raw pointer that is not wrapped in a <see cref="NativePhysicsBody"/> for performance reasons
+    /// </summary>
+    public readonly IntPtr Body;
+
+    /// <summary>
+    ///   The hit entity. May be 0 bytes if it hits a physics object not created through the ECS simulation
+    /// </summary>
+    public readonly Entity BodyEntity;
+
+    /// <summary>
+    ///   Unresolved sub-shape data of the hit, see <see cref="PhysicsRayWithUserData.SubShapeData"/>
+    /// </summary>
+    public readonly uint SubShapeData;
+}
@@ -0,0 +1,46 @@
+﻿using System.Runtime.InteropServices;
+
+/// <summary>
+///   Timing and counters of a single physics update. Must match the native side PhysicsStepStatistics byte layout.
+///   Times are in seconds.
+/// </summary>
+/// <remarks>
+///   <para>
+///     Body control and collision record clearing happen inside the Jolt update so their times are also included in
+///     <see cref="JoltUpdateTime"/>. The contact counters and callback time are only collected when enabled with
+///     <see cref="PhysicalWorld.SetContactStatisticsEnabled"/>.
+///   </para>
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct PhysicsStepStatistics
+{
+    public float BroadPhaseOptimizationTime;
+    public float BodyControlTime;
+    public float CollisionRecordClearTime;
+    public float JoltUpdateTime;
+
+    /// <summary>
+    ///   Summed over all threads running the callbacks, so this can be more than the update time
+    /// </summary>
+    public float ContactCallbackTime;
+
+    public float SimulatedTime;
+
+    /// <summary>
+    ///   Increases by one for each update. Can be used to detect which entries are new since the last read.
+    /// </summary>
+    public uint UpdateNumber;
+
+    public int CollisionSteps;
+    public int Bodies;
+    public int ActiveBodies;
+    public int BodyPairsValidated;
+    public int ContactsAdded;
+    public int ContactsPersisted;
+    public int ContactsRemoved;
+
+    /// <summary>
+    ///   Collisions that were not recorded because a body had no free collision recording slots left
+    /// </summary>
+    public int RecordedCollisionOverflows;
+}
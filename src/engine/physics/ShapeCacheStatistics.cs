@@ -0,0 +1,23 @@
+﻿using System.Runtime.InteropServices;
+
+/// <summary>
+///   Usage info of the native shape cache. Must match the native side ShapeCacheStatistics byte layout.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct ShapeCacheStatistics
+{
+    public long Hits;
+    public long Misses;
+    public long Evictions;
+    public int Entries;
+
+    /// <summary>
+    ///   Entries only kept alive by the cache, these are the ones that can be evicted
+    /// </summary>
+    public int UnusedEntries;
+
+    /// <summary>
+    ///   Total time in seconds spent creating shapes when they were not found in the cache
+    /// </summary>
+    public float CreationTime;
+}
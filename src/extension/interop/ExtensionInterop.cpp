@@ -2,6 +2,7 @@
 #include "ExtensionInterop.h"
 
 #include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/core/object.hpp>
 #include <godot_cpp/variant/variant.hpp>
@@ -60,6 +61,33 @@ bool ArrayMeshUnwrap(GodotVariant* mesh, float texelSize)
     return Thrive::Unwrap(*arrayMesh, texelSize);
 }
 
+uint8_t* ImageGetWritableData(GodotVariant* image, int64_t* dataSize)
+{
+    *dataSize = 0;
+
+    const auto variant = reinterpret_cast<godot::Variant*>(image);
+
+    if (variant->get_type() != godot::Variant::OBJECT)
+    {
+        return nullptr;
+    }
+
+    const auto imageObject = godot::Object::cast_to<godot::Image>(static_cast<godot::Object*>(*variant));
+
+    if (imageObject == nullptr || imageObject->is_empty() ||
+        imageObject->get_format() != godot::Image::FORMAT_RGBA8 || imageObject->has_mipmaps())
+    {
+        return nullptr;
+    }
+
+    // ptrw makes sure the data is not shared with anything else (for example a previous texture update) so it is
+    // safe to write to
+    const auto data = imageObject->ptrw();
+
+    *dataSize = static_cast<int64_t>(imageObject->get_width()) * imageObject->get_height() * 4;
+    return data;
+}
+
 void DebugDrawerAddPoint(DebugDrawer* drawerInstance, JVecF3* position, JColour* colour)
 {
     reinterpret_cast<Thrive::DebugDrawer*>(drawerInstance)
@@ -113,6 +113,30 @@ public static class ExtensionInterop
 
         return NativeMethods.ExtensionGetVersion(nativeConfigInstance);
     }
+
+    /// <summary>
+    ///   Gets a pointer to the pixel data of an RGBA8 image that native code can write directly to
+    /// </summary>
+    /// <param name="image">The image to get the data of, needs to be RGBA8 and not have mipmaps</param>
+    /// <param name="dataSize">Size of the data in bytes</param>
+    /// <returns>
+    ///   The data pointer or zero on failure. Only valid until the image is used or modified in any other way.
+    /// </returns>
+    public static IntPtr GetImageWritableData(Image image, out long dataSize)
+    {
+        // See the comment in MulticellularConvolutionDisplayer.UVUnwrapAndTexture about this variant copy
+        var nativeVariant = Variant.From(image).CopyNativeVariant();
+
+        try
+        {
+            return NativeMethods.ImageGetWritableData(nativeVariant, out dataSize);
+        }
+        finally
+        {
+            // Must be disposed to not leak resources
+            nativeVariant.Dispose();
+        }
+    }
 }
 
 /// <summary>
@@ -125,4 +149,7 @@ internal static partial class NativeMethods
 
     [DllImport("thrive_extension")]
     internal static extern bool ArrayMeshUnwrap(in godot_variant mesh, float texelSize);
+
+    [DllImport("thrive_extension")]
+    internal static extern IntPtr ImageGetWritableData(in godot_variant image, out long dataSize);
 }
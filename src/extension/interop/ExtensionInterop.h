@@ -24,6 +24,13 @@ extern "C"
 
     [[maybe_unused]] API_EXPORT bool ArrayMeshUnwrap(GodotVariant* mesh, float texelSize);
 
+    /// \brief Gets direct write access to the pixel data of an RGBA8 Image (without mipmaps), for example for native
+    /// code to update texture data without copies. The pointer is only valid until the image is modified in any other
+    /// way or used to update a texture.
+    /// \param dataSize Set to the size of the data in bytes
+    /// \return The data pointer or null if the variant is not a suitable Image
+    [[maybe_unused]] API_EXPORT uint8_t* ImageGetWritableData(GodotVariant* image, int64_t* dataSize);
+
     // ------------------------------------ //
     // DebugDrawer direct access calls
     [[maybe_unused]] API_EXPORT void DebugDrawerAddLine(DebugDrawer* drawerInstance, JVecF3* from, JVecF3* to,
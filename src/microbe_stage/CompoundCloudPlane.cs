@@ -1,7 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Threading;
-using System.Threading.Tasks;
 using Godot;
 using Newtonsoft.Json;
 using Systems;
@@ -16,19 +15,6 @@ using Vector4 = System.Numerics.Vector4;
 [SceneLoadedClass("res://src/microbe_stage/CompoundCloudPlane.tscn", UsesEarlyResolve = false)]
 public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
 {
-    /// <summary>
-    ///   The current densities of compounds. This uses custom writing so this is ignored.
-    /// </summary>
-    /// <remarks>
-    ///   <para>
-    ///     Because this is such a high priority system this uses a bit more happily null suppressing than elsewhere
-    ///   </para>
-    /// </remarks>
-    public Vector4[,] Density = null!;
-
-    [JsonIgnore]
-    public Vector4[,] OldDensity = null!;
-
     [JsonProperty]
     public Compound[] Compounds = null!;
 
@@ -46,6 +32,21 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
 
     private Vector4 decayRates;
 
+    /// <summary>
+    ///   Runs the cloud simulation and holds the current densities of the compounds
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///     Because this is such a high priority system this uses a bit more happily null suppressing than elsewhere
+    ///   </para>
+    /// </remarks>
+    private CompoundCloudSimulation simulation = null!;
+
+    /// <summary>
+    ///   Density read from a save that is copied to the simulation once it is created
+    /// </summary>
+    private Vector4[,]? loadedDensity;
+
     [JsonProperty]
     private Vector2I position = new(0, 0);
 
@@ -63,6 +64,19 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
 
     public bool IsLoadedFromSave { get; set; }
 
+    [JsonIgnore]
+    public CompoundCloudSimulation Simulation => simulation;
+
+    /// <summary>
+    ///   The current densities of compounds in the format they are saved in. Converted from / to the simulation data.
+    /// </summary>
+    [JsonProperty]
+    private Vector4[,]? Density
+    {
+        get => loadedDensity ?? ExportDensity();
+        set => loadedDensity = value;
+    }
+
     // Called when the node enters the scene tree for the first time.
     public override void _Ready()
     {
@@ -71,10 +85,7 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
             Size = Settings.Instance.CloudSimulationWidth;
             Resolution = Settings.Instance.CloudResolution;
             CreateDensityTexture();
-
-            Density = new Vector4[Size, Size];
-            OldDensity = new Vector4[Size, Size];
-            ClearContents();
+            simulation = new CompoundCloudSimulation(Size, Constants.CLOUD_DIFFUSION_RATE, VISCOSITY);
         }
         else
         {
@@ -82,8 +93,14 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
             // TODO: could resample the density data here to allow changing the cloud resolution or size
             // without starting a new save
             CreateDensityTexture();
+            simulation = new CompoundCloudSimulation(Size, Constants.CLOUD_DIFFUSION_RATE, VISCOSITY);
+
+            if (loadedDensity != null)
+            {
+                ImportDensity(loadedDensity);
+                loadedDensity = null;
+            }
 
-            OldDensity = new Vector4[Size, Size];
             SetMaterialUVForPosition();
         }
     }
@@ -181,225 +198,31 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
     }
 
     /// <summary>
-    ///   Updates the edge concentrations of this cloud before the rest of the cloud.
-    ///   This is not ran in parallel.
+    ///   Passes the current parameters to the simulation, needs to be called before the simulation is updated
     /// </summary>
-    public void UpdateEdgesBeforeCenter(float delta)
+    public void PrepareSimulationUpdate()
     {
-        // The diffusion rate seems to have a bigger effect
-        delta *= 100.0f;
+        simulation.SetDecayRates(decayRates.X, decayRates.Y, decayRates.Z, decayRates.W);
+        simulation.SetPlanePosition(position.X, position.Y);
+        simulation.UpdateVelocityGrid(fluidSystem!.Currents, new Vector2(cachedWorldPosition.X, cachedWorldPosition.Z),
+            Resolution);
 
-        if (position.X != 0)
-        {
-            PartialDiffuseEdges(0, 0, Constants.CLOUD_EDGE_WIDTH / 2, Size, delta);
-            PartialDiffuseEdges(Size - Constants.CLOUD_EDGE_WIDTH / 2, 0, Constants.CLOUD_EDGE_WIDTH / 2, Size, delta);
-        }
-
-        if (position.X != 1)
-        {
-            PartialDiffuseEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2, 0,
-                Constants.CLOUD_EDGE_WIDTH, Size, delta);
-        }
-
-        if (position.X != 2)
-        {
-            PartialDiffuseEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2, 0,
-                Constants.CLOUD_EDGE_WIDTH, Size, delta);
-        }
-
-        if (position.Y != 0)
-        {
-            PartialDiffuseEdges(Constants.CLOUD_EDGE_WIDTH / 2, 0,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta);
-            PartialDiffuseEdges(Constants.CLOUD_EDGE_WIDTH / 2, Size - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta);
-            PartialDiffuseEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2, 0,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta);
-            PartialDiffuseEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size - Constants.CLOUD_EDGE_WIDTH / 2, Size / Constants.CLOUD_SQUARES_PER_SIDE
-                - Constants.CLOUD_EDGE_WIDTH, Constants.CLOUD_EDGE_WIDTH / 2, delta);
-            PartialDiffuseEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                0, Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta);
-            PartialDiffuseEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta);
-        }
+        // The native side writes the densities directly to the image memory, which is then used to update the
+        // texture in UpdateTexture
+        var pixels = ExtensionInterop.GetImageWritableData(image!, out var dataSize);
 
-        if (position.Y != 1)
+        if (dataSize < (long)Size * Size * 4)
         {
-            PartialDiffuseEdges(Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
-            PartialDiffuseEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
-            PartialDiffuseEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
+            GD.PrintErr("Cannot write compound cloud image data, image size is wrong");
+            pixels = IntPtr.Zero;
         }
 
-        if (position.Y != 2)
-        {
-            PartialDiffuseEdges(Constants.CLOUD_EDGE_WIDTH / 2,
-                2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
-            PartialDiffuseEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Constants.CLOUD_EDGE_WIDTH * Size / Constants.CLOUD_SQUARES_PER_SIDE
-                - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
-            PartialDiffuseEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta);
-        }
+        simulation.SetTextureOutput(pixels, 1 / Constants.CLOUD_MAX_INTENSITY_SHOWN);
     }
 
     /// <summary>
-    ///   Updates the edge concentrations of this cloud after the rest of the cloud.
-    ///   This is not ran in parallel.
+    ///   Uploads the image data written by the last simulation update to the texture
     /// </summary>
-    public void UpdateEdgesAfterCenter(float delta)
-    {
-        // The diffusion rate seems to have a bigger effect
-        delta *= 100.0f;
-        var pos = new Vector2(cachedWorldPosition.X, cachedWorldPosition.Z);
-
-        if (position.X != 0)
-        {
-            PartialAdvectEdges(0, 0, Constants.CLOUD_EDGE_WIDTH / 2, Size, delta, pos);
-            PartialAdvectEdges(Size - Constants.CLOUD_EDGE_WIDTH / 2, 0, Constants.CLOUD_EDGE_WIDTH / 2,
-                Size, delta, pos);
-        }
-
-        if (position.X != 1)
-        {
-            PartialAdvectEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                0, Constants.CLOUD_EDGE_WIDTH, Size, delta, pos);
-        }
-
-        if (position.X != 2)
-        {
-            PartialAdvectEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                0, Constants.CLOUD_EDGE_WIDTH, Size, delta, pos);
-        }
-
-        if (position.Y != 0)
-        {
-            PartialAdvectEdges(Constants.CLOUD_EDGE_WIDTH / 2, 0,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-            PartialAdvectEdges(Constants.CLOUD_EDGE_WIDTH / 2, Size - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-            PartialAdvectEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                0, Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-            PartialAdvectEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-            PartialAdvectEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                0, Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-            PartialAdvectEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH / 2, delta, pos);
-        }
-
-        if (position.Y != 1)
-        {
-            PartialAdvectEdges(Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-            PartialAdvectEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-            PartialAdvectEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-        }
-
-        if (position.Y != 2)
-        {
-            PartialAdvectEdges(Constants.CLOUD_EDGE_WIDTH / 2,
-                2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-            PartialAdvectEdges(Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                Constants.CLOUD_EDGE_WIDTH * Size / Constants.CLOUD_SQUARES_PER_SIDE
-                - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-            PartialAdvectEdges(2 * Size / Constants.CLOUD_SQUARES_PER_SIDE + Constants.CLOUD_EDGE_WIDTH / 2,
-                2 * Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH / 2,
-                Size / Constants.CLOUD_SQUARES_PER_SIDE - Constants.CLOUD_EDGE_WIDTH,
-                Constants.CLOUD_EDGE_WIDTH, delta, pos);
-        }
-    }
-
-    /// <summary>
-    ///   Updates the cloud in parallel.
-    /// </summary>
-    public void QueueUpdateCloud(float delta, List<Task> queue)
-    {
-        // The diffusion rate seems to have a bigger effect
-        delta *= 100.0f;
-        var pos = new Vector2(cachedWorldPosition.X, cachedWorldPosition.Z);
-
-        for (int i = 0; i < Constants.CLOUD_SQUARES_PER_SIDE; ++i)
-        {
-            for (int j = 0; j < Constants.CLOUD_SQUARES_PER_SIDE; ++j)
-            {
-                var x0 = i;
-                var y0 = j;
-
-                // TODO: fix task allocations
-                var task = new Task(() => PartialUpdateCenter(x0 * Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    y0 * Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    delta, pos));
-                queue.Add(task);
-            }
-        }
-    }
-
-    /// <summary>
-    ///   Updates the cloud in parallel.
-    /// </summary>
-    public void QueueUpdateTextureImage(List<Task> queue)
-    {
-        for (int i = 0; i < Constants.CLOUD_SQUARES_PER_SIDE; ++i)
-        {
-            for (int j = 0; j < Constants.CLOUD_SQUARES_PER_SIDE; ++j)
-            {
-                var x0 = i;
-                var y0 = j;
-
-                // TODO: fix task allocations
-                var task = new Task(() => PartialUpdateTextureImage(x0 * Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    y0 * Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    Size / Constants.CLOUD_SQUARES_PER_SIDE,
-                    Size / Constants.CLOUD_SQUARES_PER_SIDE));
-                queue.Add(task);
-            }
-        }
-    }
-
     public void UpdateTexture()
     {
         texture.Update(image);
@@ -421,72 +244,8 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
     /// </summary>
     public void AddCloudInterlocked(Compound compound, int x, int y, float density)
     {
-        var compoundIndex = GetCompoundIndex(compound);
-
-        float seenCurrentAmount;
-        float newValue;
-
-        // Exact comparisons used to know when the atomic operation really succeeded
-        // ReSharper disable CompareOfFloatsByEqualityOperator
-        switch (compoundIndex)
-        {
-            case 0:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].X;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].X, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                break;
-            }
-
-            case 1:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].Y;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].Y, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                break;
-            }
-
-            case 2:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].Z;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].Z, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                break;
-            }
-
-            case 3:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].W;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].W, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                break;
-            }
-
-            default:
-                throw new ArgumentException("This cloud doesn't handle the given compound type");
-        }
-
-        // ReSharper restore CompareOfFloatsByEqualityOperator
+        if (!AddCloudInterlockedIfHandlesType(compound, x, y, density))
+            throw new ArgumentException("This cloud doesn't handle the given compound type");
     }
 
     /// <summary>
@@ -497,70 +256,26 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
     {
         var compoundIndex = GetCompoundIndex(compound);
 
+        if (compoundIndex < 0)
+            return false;
+
+        ref var cell = ref simulation.DensityAt(compoundIndex, x, y);
+
         float seenCurrentAmount;
         float newValue;
 
         // Exact comparisons used to know when the atomic operation really succeeded
         // ReSharper disable CompareOfFloatsByEqualityOperator
-        switch (compoundIndex)
+        do
         {
-            case 0:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].X;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].X, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                return true;
-            }
-
-            case 1:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].Y;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].Y, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                return true;
-            }
-
-            case 2:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].Z;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].Z, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                return true;
-            }
-
-            case 3:
-            {
-                do
-                {
-                    seenCurrentAmount = Density[x, y].W;
-                    newValue = seenCurrentAmount + density;
-                }
-                while (Interlocked.CompareExchange(ref Density[x, y].W, newValue, seenCurrentAmount) !=
-                       seenCurrentAmount);
-
-                return true;
-            }
-
-            default:
-                return false;
+            seenCurrentAmount = cell;
+            newValue = seenCurrentAmount + density;
         }
+        while (Interlocked.CompareExchange(ref cell, newValue, seenCurrentAmount) != seenCurrentAmount);
 
         // ReSharper restore CompareOfFloatsByEqualityOperator
+
+        return true;
     }
 
     /// <summary>
@@ -569,17 +284,22 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
     /// <returns>The amount of compound taken</returns>
     public float TakeCompound(Compound compound, int x, int y, float fraction = 1.0f)
     {
-        float amountInCloud = HackyAddress(ref Density[x, y], GetCompoundIndex(compound));
+        var compoundIndex = GetCompoundIndex(compound);
+
+        if (compoundIndex < 0)
+            return 0;
+
+        ref var amountInCloud = ref simulation.DensityAt(compoundIndex, x, y);
         var amountToGive = amountInCloud * fraction;
 
         if (amountInCloud - amountToGive < 0.1f)
         {
             // Taking basically everything in the cloud
-            Density[x, y] += CalculateCloudToAdd(compound, -amountInCloud);
+            amountInCloud = 0;
         }
         else
         {
-            Density[x, y] += CalculateCloudToAdd(compound, -amountToGive);
+            amountInCloud -= amountToGive;
         }
 
         return amountToGive;
@@ -608,27 +328,13 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
             newValue = seenCurrentAmount - taken;
         }
 
-        // Exact comparisons used to know when the atomic operation really succeeded
-        // ReSharper disable CompareOfFloatsByEqualityOperator
-        switch (compoundIndex)
-        {
-            case 0:
-                return Interlocked.CompareExchange(ref Density[x, y].X, newValue, seenCurrentAmount) ==
-                    seenCurrentAmount;
-            case 1:
-                return Interlocked.CompareExchange(ref Density[x, y].Y, newValue, seenCurrentAmount) ==
-                    seenCurrentAmount;
-            case 2:
-                return Interlocked.CompareExchange(ref Density[x, y].Z, newValue, seenCurrentAmount) ==
-                    seenCurrentAmount;
-            case 3:
-                return Interlocked.CompareExchange(ref Density[x, y].W, newValue, seenCurrentAmount) ==
-                    seenCurrentAmount;
-            default:
-                throw new ArgumentException("Compound index out of range");
-        }
+        if (compoundIndex is < 0 or >= Constants.CLOUDS_IN_ONE)
+            throw new ArgumentException("Compound index out of range");
 
-        // ReSharper restore CompareOfFloatsByEqualityOperator
+        // Exact comparison used to know when the atomic operation really succeeded
+        // ReSharper disable once CompareOfFloatsByEqualityOperator
+        return Interlocked.CompareExchange(ref simulation.DensityAt(compoundIndex, x, y), newValue,
+            seenCurrentAmount) == seenCurrentAmount;
     }
 
     /// <summary>
@@ -637,7 +343,12 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
     /// <returns>The amount available for taking</returns>
     public float AmountAvailable(Compound compound, int x, int y, float fraction = 1.0f)
     {
-        float amountInCloud = HackyAddress(ref Density[x, y], GetCompoundIndex(compound));
+        var compoundIndex = GetCompoundIndex(compound);
+
+        if (compoundIndex < 0)
+            return 0;
+
+        float amountInCloud = simulation.DensityAt(compoundIndex, x, y);
         float amountToGive = amountInCloud * fraction;
         return amountToGive;
     }
@@ -656,7 +367,7 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
             if (onlyAbsorbable && !compoundDefinitions[i]!.IsAbsorbable)
                 continue;
 
-            float amount = HackyAddress(ref Density[x, y], i);
+            float amount = simulation.DensityAt(i, x, y);
             if (amount > 0)
                 result[compound] = amount;
         }
@@ -743,7 +454,7 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
             while (true)
             {
                 // Overestimate of how much compounds we get
-                float cloudAmount = HackyAddress(ref Density[localX, localY], i);
+                float cloudAmount = simulation.DensityAt(i, localX, localY);
                 float generousAmount = cloudAmount * Constants.SKIP_TRYING_TO_ABSORB_RATIO;
 
                 // Skip if there isn't enough to absorb
@@ -790,14 +501,7 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
 
     public void ClearContents()
     {
-        for (int x = 0; x < Size; ++x)
-        {
-            for (int y = 0; y < Size; ++y)
-            {
-                Density[x, y] = Vector4.Zero;
-                OldDensity[x, y] = Vector4.Zero;
-            }
-        }
+        simulation.AllData().Clear();
     }
 
     public void SetBrightness(float brightness)
@@ -817,190 +521,65 @@ public partial class CompoundCloudPlane : CsgMesh3D, ISaveLoadedTracked
                 image.Dispose();
                 texture.Dispose();
             }
+
+            simulation?.Dispose();
         }
 
         base.Dispose(disposing);
     }
 
-    /// <summary>
-    ///   Calculates the multipliers for the old density to move to new locations
-    /// </summary>
-    /// <remarks>
-    ///   <para>
-    ///     The name might not be super accurate as I just picked something to reduce code duplication
-    ///   </para>
-    /// </remarks>
-    private static void CalculateMovementFactors(float dx, float dy, out int q0, out int q1, out int r0, out int r1,
-        out float s1, out float s0, out float t1, out float t0)
-    {
-        q0 = (int)Math.Floor(dx);
-        q1 = q0 + 1;
-        r0 = (int)Math.Floor(dy);
-        r1 = r0 + 1;
-
-        s1 = Math.Abs(dx - q0);
-        s0 = 1.0f - s1;
-        t1 = Math.Abs(dy - r0);
-        t0 = 1.0f - t1;
-    }
-
-    private Vector4 CalculateCloudToAdd(Compound compound, float density)
-    {
-        return new Vector4(Compounds[0] == compound ? density : 0.0f,
-            Compounds[1] == compound ? density : 0.0f,
-            Compounds[2] == compound ? density : 0.0f,
-            Compounds[3] == compound ? density : 0.0f);
-    }
-
-    private void PartialDiffuseCenter(int x0, int y0, int width, int height, float delta)
+    private void PartialClearDensity(int x0, int y0, int width, int height)
     {
-        float a = delta * Constants.CLOUD_DIFFUSION_RATE;
-
-        for (int x = x0; x < x0 + width; ++x)
+        for (int channel = 0; channel < Constants.CLOUDS_IN_ONE; ++channel)
         {
-            for (int y = y0; y < y0 + height; ++y)
-            {
-                int adjacentClouds = 4;
-                OldDensity[x, y] =
-                    Density[x, y] * (1 - a) +
-                    (Density[x, y - 1] + Density[x, y + 1] + Density[x - 1, y] + Density[x + 1, y])
-                    * (a / adjacentClouds);
-            }
-        }
-    }
+            var data = simulation.DensityChannel(channel);
 
-    private void PartialDiffuseEdges(int x0, int y0, int width, int height, float delta)
-    {
-        float a = delta * Constants.CLOUD_DIFFUSION_RATE;
-
-        for (int x = x0; x < x0 + width; ++x)
-        {
-            for (int y = y0; y < y0 + height; ++y)
+            for (int x = x0; x < x0 + width; ++x)
             {
-                int adjacentClouds = 4;
-                OldDensity[x, y] =
-                    Density[x, y] * (1 - a) +
-                    (Density[x, (y - 1 + Size) % Size] +
-                        Density[x, (y + 1) % Size] +
-                        Density[(x - 1 + Size) % Size, y] +
-                        Density[(x + 1) % Size, y]) * (a / adjacentClouds);
+                data.Slice(x * simulation.RowStride + y0, height).Clear();
             }
         }
     }
 
-    private void PartialAdvectCenter(int x0, int y0, int width, int height, float delta, Vector2 pos)
+    private Vector4[,] ExportDensity()
     {
-        for (int x = x0; x < x0 + width; ++x)
-        {
-            for (int y = y0; y < y0 + height; ++y)
-            {
-                if (OldDensity[x, y].LengthSquared() > 1)
-                {
-                    var velocity = fluidSystem!.VelocityAt(pos + new Vector2(x, y) * Resolution) * VISCOSITY;
-
-                    // This is run in parallel, this may not touch the other compound clouds
-                    float dx = x + (delta * velocity.X);
-                    float dy = y + (delta * velocity.Y);
-
-                    // So this is clamped to not go to the other clouds
-                    dx = Math.Clamp(dx, x0 - 0.5f, x0 + width + 0.5f);
-                    dy = Math.Clamp(dy, y0 - 0.5f, y0 + height + 0.5f);
-
-                    CalculateMovementFactors(dx, dy, out var q0, out var q1, out var r0, out var r1,
-                        out var s1, out var s0, out var t1, out var t0);
-
-                    // NOTE: we add modulo to avoid overflow due to large time steps
-                    // This makes this function a duplicate of PartialAdvectEdges
-                    // TODO: check for refactorization (and in general of the whole file) --Maxonovien
-                    q0 = q0.PositiveModulo(Size);
-                    q1 = q1.PositiveModulo(Size);
-                    r0 = r0.PositiveModulo(Size);
-                    r1 = r1.PositiveModulo(Size);
-
-                    Density[q0, r0] += OldDensity[x, y] * decayRates * s0 * t0;
-                    Density[q0, r1] += OldDensity[x, y] * decayRates * s0 * t1;
-                    Density[q1, r0] += OldDensity[x, y] * decayRates * s1 * t0;
-                    Density[q1, r1] += OldDensity[x, y] * decayRates * s1 * t1;
-                }
-            }
-        }
-    }
+        var result = new Vector4[Size, Size];
 
-    private void PartialAdvectEdges(int x0, int y0, int width, int height, float delta, Vector2 pos)
-    {
-        for (int x = x0; x < x0 + width; ++x)
+        for (int x = 0; x < Size; ++x)
         {
-            for (int y = y0; y < y0 + height; ++y)
+            for (int y = 0; y < Size; ++y)
             {
-                if (OldDensity[x, y].LengthSquared() > 1)
-                {
-                    var velocity = fluidSystem!.VelocityAt(pos + new Vector2(x, y) * Resolution) * VISCOSITY;
-
-                    // This is run in parallel, this may not touch the other compound clouds
-                    float dx = x + (delta * velocity.X);
-                    float dy = y + (delta * velocity.Y);
-
-                    CalculateMovementFactors(dx, dy, out var q0, out var q1, out var r0, out var r1,
-                        out var s1, out var s0, out var t1, out var t0);
-
-                    Density[(q0 + Size) % Size, (r0 + Size) % Size] += OldDensity[x, y] * s0 * t0;
-                    Density[(q0 + Size) % Size, (r1 + Size) % Size] += OldDensity[x, y] * s0 * t1;
-                    Density[(q1 + Size) % Size, (r0 + Size) % Size] += OldDensity[x, y] * s1 * t0;
-                    Density[(q1 + Size) % Size, (r1 + Size) % Size] += OldDensity[x, y] * s1 * t1;
-                }
+                result[x, y] = new Vector4(simulation.DensityAt(0, x, y), simulation.DensityAt(1, x, y),
+                    simulation.DensityAt(2, x, y), simulation.DensityAt(3, x, y));
             }
         }
+
+        return result;
     }
 
-    private void PartialUpdateTextureImage(int x0, int y0, int width, int height)
+    private void ImportDensity(Vector4[,] density)
     {
-        for (int x = x0; x < x0 + width; ++x)
+        // Saves with a different cloud size can't be directly used
+        // TODO: could resample the data here
+        if (density.GetLength(0) != Size || density.GetLength(1) != Size)
         {
-            for (int y = y0; y < y0 + height; ++y)
-            {
-                var pixel = Density[x, y] * (1 / Constants.CLOUD_MAX_INTENSITY_SHOWN);
-                image!.SetPixel(x, y, new Color(pixel.X, pixel.Y, pixel.Z, pixel.W));
-            }
+            GD.PrintErr("Loaded cloud density has wrong size, ignoring it");
+            return;
         }
-    }
 
-    private void PartialClearDensity(int x0, int y0, int width, int height)
-    {
-        for (int x = x0; x < x0 + width; ++x)
+        for (int x = 0; x < Size; ++x)
         {
-            for (int y = y0; y < y0 + height; ++y)
+            for (int y = 0; y < Size; ++y)
             {
-                Density[x, y] = Vector4.Zero;
+                var value = density[x, y];
+                simulation.DensityAt(0, x, y) = value.X;
+                simulation.DensityAt(1, x, y) = value.Y;
+                simulation.DensityAt(2, x, y) = value.Z;
+                simulation.DensityAt(3, x, y) = value.W;
             }
         }
     }
 
-    private void PartialUpdateCenter(int x0, int y0, int width, int height, float delta, Vector2 pos)
-    {
-        PartialDiffuseCenter(x0 + Constants.CLOUD_EDGE_WIDTH / 2, y0 + Constants.CLOUD_EDGE_WIDTH / 2, width
-            - Constants.CLOUD_EDGE_WIDTH, height - Constants.CLOUD_EDGE_WIDTH, delta);
-        PartialClearDensity(x0, y0, width, height);
-        PartialAdvectCenter(x0 + Constants.CLOUD_EDGE_WIDTH / 2, y0 + Constants.CLOUD_EDGE_WIDTH / 2, width
-            - Constants.CLOUD_EDGE_WIDTH, height - Constants.CLOUD_EDGE_WIDTH, delta, pos);
-    }
-
-    private float HackyAddress(ref Vector4 vector, int index)
-    {
-        switch (index)
-        {
-            case 0:
-                return vector.X;
-            case 1:
-                return vector.Y;
-            case 2:
-                return vector.Z;
-            case 3:
-                return vector.W;
-        }
-
-        return 0;
-    }
-
     private int GetCompoundIndex(Compound compound)
     {
         for (int i = 0; i < Constants.CLOUDS_IN_ONE; ++i)
@@ -0,0 +1,217 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using Godot;
+
+/// <summary>
+///   Native diffusion and advection simulation of one <see cref="CompoundCloudPlane"/>. Owns the density data of the
+///   plane so that the native side can operate on it without copying.
+/// </summary>
+/// <remarks>
+///   <para>
+///     The densities are stored as a separate grid for each compound (channel). Each x coordinate is a row of
+///     <see cref="RowStride"/> floats. The data is in a pinned array, aligned for the native vector operations, which
+///     is only accessed through spans and refs on this side. While <see cref="UpdateAll"/> is running the density
+///     must not be touched. The update also writes the cloud textures straight to the memory given with
+///     <see cref="SetTextureOutput"/>.
+///   </para>
+/// </remarks>
+public class CompoundCloudSimulation : IDisposable
+{
+    /// <summary>
+    ///   Alignment of the density data in floats (32 bytes)
+    /// </summary>
+    private const int ALIGNMENT = 8;
+
+    private readonly float[] storage;
+
+    /// <summary>
+    ///   Where the aligned density data starts in <see cref="storage"/>
+    /// </summary>
+    private readonly int dataStart;
+
+    private readonly int channelLength;
+
+    private bool disposed;
+    private IntPtr nativeInstance;
+
+    public CompoundCloudSimulation(int size, float diffusionRate, float viscosity)
+    {
+        Size = size;
+        RowStride = NativeMethods.CompoundCloudSimulationRowStride(size);
+        channelLength = size * RowStride;
+
+        // Both density and old density have all channels
+        storage = GC.AllocateArray<float>(channelLength * Constants.CLOUDS_IN_ONE * 2 + ALIGNMENT, true);
+
+        var misalignment = (int)(Marshal.UnsafeAddrOfPinnedArrayElement(storage, 0).ToInt64() % (ALIGNMENT * 4)) / 4;
+        dataStart = (ALIGNMENT - misalignment) % ALIGNMENT;
+
+        nativeInstance = NativeMethods.CreateCompoundCloudSimulation(size, RowStride,
+            Marshal.UnsafeAddrOfPinnedArrayElement(storage, dataStart),
+            Marshal.UnsafeAddrOfPinnedArrayElement(storage, dataStart + channelLength * Constants.CLOUDS_IN_ONE),
+            diffusionRate, viscosity);
+
+        if (nativeInstance.ToInt64() == 0)
+            throw new ArgumentException("Failed to create native cloud simulation");
+    }
+
+    ~CompoundCloudSimulation()
+    {
+        Dispose(false);
+    }
+
+    public int Size { get; }
+
+    /// <summary>
+    ///   Distance in floats between the starts of consecutive x coordinates of a channel
+    /// </summary>
+    public int RowStride { get; }
+
+    /// <summary>
+    ///   Runs one simulation step of all the given clouds in parallel
+    /// </summary>
+    /// <param name="simulations">The clouds to update, only the first <paramref name="count"/> are used</param>
+    /// <param name="nativePointers">Temporary storage at least as long as the count</param>
+    /// <param name="count">How many clouds to update</param>
+    /// <param name="delta">Already scaled time step</param>
+    public static void UpdateAll(CompoundCloudSimulation[] simulations, IntPtr[] nativePointers, int count,
+        float delta)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            nativePointers[i] = simulations[i].AccessSimulationInternal();
+        }
+
+        NativeMethods.UpdateCompoundCloudSimulations(nativePointers, count, delta);
+    }
+
+    /// <summary>
+    ///   Access to the density of a single cell. The ref can be used with <see cref="System.Threading.Interlocked"/>
+    /// </summary>
+    public ref float DensityAt(int channel, int x, int y)
+    {
+        return ref storage[dataStart + channel * channelLength + x * RowStride + y];
+    }
+
+    /// <summary>
+    ///   The whole density grid of a single channel, including the padding at the end of each row
+    /// </summary>
+    public Span<float> DensityChannel(int channel)
+    {
+        return new Span<float>(storage, dataStart + channel * channelLength, channelLength);
+    }
+
+    /// <summary>
+    ///   All of the density data (including old density), used for clearing everything
+    /// </summary>
+    public Span<float> AllData()
+    {
+        return new Span<float>(storage, dataStart, channelLength * Constants.CLOUDS_IN_ONE * 2);
+    }
+
+    public void SetDecayRates(float decay1, float decay2, float decay3, float decay4)
+    {
+        NativeMethods.CompoundCloudSimulationSetDecayRates(AccessSimulationInternal(), decay1, decay2, decay3, decay4);
+    }
+
+    public void SetPlanePosition(int x, int y)
+    {
+        NativeMethods.CompoundCloudSimulationSetPlanePosition(AccessSimulationInternal(), x, y);
+    }
+
+    /// <summary>
+    ///   Sets where the densities are written as RGBA8 pixels on the next update
+    /// </summary>
+    /// <param name="pixels">
+    ///   Size * Size pixels where each image row is one y coordinate. Needs to stay valid until the update is done.
+    ///   Zero to not write texture data.
+    /// </param>
+    /// <param name="intensityScale">Multiplier for the density to get the 0-1 colour values</param>
+    public void SetTextureOutput(IntPtr pixels, float intensityScale)
+    {
+        NativeMethods.CompoundCloudSimulationSetTextureOutput(AccessSimulationInternal(), pixels, intensityScale);
+    }
+
+    /// <summary>
+    ///   Calculates the fluid velocity for the cloud cells every <see cref="Constants.CLOUD_VELOCITY_GRID_SPACING"/>
+    ///   cells on the native side. If the currents have a grid covering the cloud, the velocities are taken from it.
+    /// </summary>
+    /// <param name="currents">Where the velocities are read from</param>
+    /// <param name="position">World position of cloud cell 0, 0</param>
+    /// <param name="resolution">Size of a cloud cell in world units</param>
+    public void UpdateVelocityGrid(FluidCurrents currents, Vector2 position, int resolution)
+    {
+        NativeMethods.CompoundCloudSimulationSetVelocityGridFromCurrents(AccessSimulationInternal(),
+            currents.AccessCurrentsInternal(), position.X, position.Y, resolution,
+            Constants.CLOUD_VELOCITY_GRID_SPACING);
+    }
+
+    public void Dispose()
+    {
+        Dispose(true);
+        GC.SuppressFinalize(this);
+    }
+
+    internal IntPtr AccessSimulationInternal()
+    {
+        if (disposed)
+            throw new ObjectDisposedException(nameof(CompoundCloudSimulation));
+
+        return nativeInstance;
+    }
+
+    protected virtual void Dispose(bool disposing)
+    {
+        ReleaseUnmanagedResources();
+
+        if (disposing)
+            disposed = true;
+    }
+
+    private void ReleaseUnmanagedResources()
+    {
+        if (nativeInstance.ToInt64() != 0)
+        {
+            NativeMethods.ReleaseCompoundCloudSimulation(nativeInstance);
+            nativeInstance = new IntPtr(0);
+        }
+    }
+}
+
+/// <summary>
+///   Thrive native library methods related to compound clouds
+/// </summary>
+internal static partial class NativeMethods
+{
+    [DllImport("thrive_native")]
+    internal static extern IntPtr CreateCompoundCloudSimulation(int size, int rowStride, IntPtr density,
+        IntPtr oldDensity, float diffusionRate, float viscosity);
+
+    [DllImport("thrive_native")]
+    internal static extern void ReleaseCompoundCloudSimulation(IntPtr simulation);
+
+    [DllImport("thrive_native")]
+    internal static extern int CompoundCloudSimulationRowStride(int size);
+
+    [DllImport("thrive_native")]
+    internal static extern void CompoundCloudSimulationSetDecayRates(IntPtr simulation, float decay1, float decay2,
+        float decay3, float decay4);
+
+    [DllImport("thrive_native")]
+    internal static extern void CompoundCloudSimulationSetPlanePosition(IntPtr simulation, int x, int y);
+
+    [DllImport("thrive_native")]
+    internal static extern void CompoundCloudSimulationSetVelocityGrid(IntPtr simulation, float[] velocities,
+        int width, int height, float spacing);
+
+    [DllImport("thrive_native")]
+    internal static extern void CompoundCloudSimulationSetVelocityGridFromCurrents(IntPtr simulation,
+        IntPtr currents, float originX, float originY, float cellSize, int spacing);
+
+    [DllImport("thrive_native")]
+    internal static extern void CompoundCloudSimulationSetTextureOutput(IntPtr simulation, IntPtr pixels,
+        float intensityScale);
+
+    [DllImport("thrive_native")]
+    internal static extern void UpdateCompoundCloudSimulations(IntPtr[] simulations, int count, float delta);
+}
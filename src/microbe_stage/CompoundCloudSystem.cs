@@ -1,7 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
-using System.Threading.Tasks;
 using Godot;
 using Newtonsoft.Json;
 using Systems;
@@ -36,6 +35,15 @@ public partial class CompoundCloudSystem : Node, IReadonlyCompoundClouds, ISaveL
     [JsonIgnore]
     private float currentBrightness = 1.0f;
 
+    [JsonIgnore]
+    private CompoundCloudSimulation[] simulationsToUpdate = Array.Empty<CompoundCloudSimulation>();
+
+    [JsonIgnore]
+    private IntPtr[] nativeSimulationPointers = Array.Empty<IntPtr>();
+
+    [JsonIgnore]
+    private FluidCurrentsSystem? fluidCurrents;
+
     /// <summary>
     ///   The cloud resolution of the first cloud
     /// </summary>
@@ -54,6 +62,8 @@ public partial class CompoundCloudSystem : Node, IReadonlyCompoundClouds, ISaveL
     /// </summary>
     public void Init(FluidCurrentsSystem fluidSystem)
     {
+        fluidCurrents = fluidSystem;
+
         var allCloudCompounds = SimulationParameters.Instance.GetCloudCompounds();
 
         if (!IsLoadedFromSave)
@@ -415,39 +425,59 @@ public partial class CompoundCloudSystem : Node, IReadonlyCompoundClouds, ISaveL
         }
     }
 
-    private void UpdateCloudContents(float delta)
+    /// <summary>
+    ///   Makes the fluid currents calculate a grid that covers the velocity samples of the clouds and the area
+    ///   where entities can interact with the clouds. This way the currents are calculated just once per frame
+    ///   for both.
+    /// </summary>
+    private void UpdateCurrentsGridArea()
     {
-        // Do moving compounds on the edges of the clouds serially
-        foreach (var cloud in clouds)
-        {
-            cloud.UpdateEdgesBeforeCenter(delta);
-        }
+        if (fluidCurrents == null || clouds.Count < 1)
+            return;
+
+        // All clouds are at the same position
+        var cloud = clouds[0];
+
+        int spacing = Constants.CLOUD_VELOCITY_GRID_SPACING * cloud.Resolution;
+
+        // The grid is aligned with the cloud samples so that the clouds get exactly the same values as without it
+        int samplesBeforeX = (Constants.CLOUD_WIDTH + spacing - 1) / spacing;
+        int samplesBeforeY = (Constants.CLOUD_HEIGHT + spacing - 1) / spacing;
+        int cloudSamples = (cloud.Size + Constants.CLOUD_VELOCITY_GRID_SPACING - 1) /
+            Constants.CLOUD_VELOCITY_GRID_SPACING + 1;
 
-        var executor = TaskExecutor.Instance;
-        var tasks = new List<Task>(9 * neededCloudsAtOnePosition);
+        var origin = new Vector2(cloud.Position.X - samplesBeforeX * spacing,
+            cloud.Position.Z - samplesBeforeY * spacing);
+
+        fluidCurrents.SetVelocityGridArea(origin, spacing,
+            samplesBeforeX + Math.Max(cloudSamples, samplesBeforeX + 1),
+            samplesBeforeY + Math.Max(cloudSamples, samplesBeforeY + 1));
+    }
+
+    private void UpdateCloudContents(float delta)
+    {
+        UpdateCurrentsGridArea();
 
         foreach (var cloud in clouds)
         {
-            cloud.QueueUpdateCloud(delta, tasks);
+            cloud.PrepareSimulationUpdate();
         }
 
-        // Start and wait for tasks to finish
-        executor.RunTasks(tasks);
-        tasks.Clear();
-
-        // Do moving compounds on the edges of the clouds serially
-        foreach (var cloud in clouds)
+        if (simulationsToUpdate.Length < clouds.Count)
         {
-            cloud.UpdateEdgesAfterCenter(delta);
+            simulationsToUpdate = new CompoundCloudSimulation[clouds.Count];
+            nativeSimulationPointers = new IntPtr[clouds.Count];
         }
 
-        // Update the cloud textures in parallel
-        foreach (var cloud in clouds)
+        for (int i = 0; i < clouds.Count; ++i)
         {
-            cloud.QueueUpdateTextureImage(tasks);
+            simulationsToUpdate[i] = clouds[i].Simulation;
         }
 
-        executor.RunTasks(tasks);
+        // The diffusion rate seems to have a bigger effect so the time is scaled up. All the clouds are processed
+        // at once on the native side so that they can be split between all the threads.
+        CompoundCloudSimulation.UpdateAll(simulationsToUpdate, nativeSimulationPointers, clouds.Count,
+            delta * 100.0f);
 
         foreach (var cloud in clouds)
         {
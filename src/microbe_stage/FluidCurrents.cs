@@ -0,0 +1,141 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using Godot;
+
+/// <summary>
+///   Native calculation of the fluid current velocities used by <see cref="Systems.FluidCurrentsSystem"/> and the
+///   compound clouds
+/// </summary>
+/// <remarks>
+///   <para>
+///     Velocities are calculated in batches with vectorized noise. Optionally a coarse grid of the noise values can
+///     be calculated once per frame with <see cref="UpdateGrid"/>, positions inside it are then interpolated from the
+///     grid instead of calculating the noise again.
+///   </para>
+/// </remarks>
+public class FluidCurrents : IDisposable
+{
+    private bool disposed;
+    private IntPtr nativeInstance;
+
+    public FluidCurrents()
+    {
+        nativeInstance = NativeMethods.CreateFluidCurrents();
+
+        if (nativeInstance.ToInt64() == 0)
+            throw new InvalidOperationException("Failed to create native fluid currents");
+    }
+
+    ~FluidCurrents()
+    {
+        Dispose(false);
+    }
+
+    /// <summary>
+    ///   Sets the time of the currents. <see cref="UpdateGrid"/> needs to be called after this if the grid is used.
+    /// </summary>
+    public void SetTime(float time)
+    {
+        NativeMethods.FluidCurrentsSetTime(AccessCurrentsInternal(), time);
+    }
+
+    /// <summary>
+    ///   Calculates the grid used for sampling velocities. Must not be called while velocities are being sampled.
+    /// </summary>
+    /// <param name="origin">World position (x, z) of the first grid point</param>
+    /// <param name="spacing">Distance between the grid points</param>
+    /// <param name="width">Grid points along the x-axis, below 2 removes the grid</param>
+    /// <param name="height">Grid points along the z-axis</param>
+    public void UpdateGrid(Vector2 origin, float spacing, int width, int height)
+    {
+        NativeMethods.FluidCurrentsUpdateGrid(AccessCurrentsInternal(), origin.X, origin.Y, spacing, width, height);
+    }
+
+    /// <summary>
+    ///   Calculates the velocities at a batch of positions with a single native call
+    /// </summary>
+    /// <param name="positionsX">The x coordinates of the positions</param>
+    /// <param name="positionsY">The y (world z) coordinates of the positions</param>
+    /// <param name="resultX">Receives the velocity x components, needs to be as long as the positions</param>
+    /// <param name="resultY">Receives the velocity y components</param>
+    public void SampleVelocities(ReadOnlySpan<float> positionsX, ReadOnlySpan<float> positionsY,
+        Span<float> resultX, Span<float> resultY)
+    {
+        int count = positionsX.Length;
+
+        if (positionsY.Length != count || resultX.Length < count || resultY.Length < count)
+            throw new ArgumentException("Position and result spans need to fit all of the positions");
+
+        if (count < 1)
+            return;
+
+        NativeMethods.FluidCurrentsSampleVelocities(AccessCurrentsInternal(),
+            in MemoryMarshal.GetReference(positionsX), in MemoryMarshal.GetReference(positionsY), count,
+            ref MemoryMarshal.GetReference(resultX), ref MemoryMarshal.GetReference(resultY));
+    }
+
+    public Vector2 VelocityAt(Vector2 position)
+    {
+        float velocityX = 0;
+        float velocityY = 0;
+
+        NativeMethods.FluidCurrentsSampleVelocities(AccessCurrentsInternal(), in position.X, in position.Y, 1,
+            ref velocityX, ref velocityY);
+
+        return new Vector2(velocityX, velocityY);
+    }
+
+    public void Dispose()
+    {
+        Dispose(true);
+        GC.SuppressFinalize(this);
+    }
+
+    internal IntPtr AccessCurrentsInternal()
+    {
+        if (disposed)
+            throw new ObjectDisposedException(nameof(FluidCurrents));
+
+        return nativeInstance;
+    }
+
+    protected virtual void Dispose(bool disposing)
+    {
+        ReleaseUnmanagedResources();
+
+        if (disposing)
+            disposed = true;
+    }
+
+    private void ReleaseUnmanagedResources()
+    {
+        if (nativeInstance.ToInt64() != 0)
+        {
+            NativeMethods.ReleaseFluidCurrents(nativeInstance);
+            nativeInstance = new IntPtr(0);
+        }
+    }
+}
+
+/// <summary>
+///   Thrive native library methods related to fluid currents
+/// </summary>
+internal static partial class NativeMethods
+{
+    [DllImport("thrive_native")]
+    internal static extern IntPtr CreateFluidCurrents();
+
+    [DllImport("thrive_native")]
+    internal static extern void ReleaseFluidCurrents(IntPtr currents);
+
+    [DllImport("thrive_native")]
+    internal static extern void FluidCurrentsSetTime(IntPtr currents, float time);
+
+    [DllImport("thrive_native")]
+    internal static extern void FluidCurrentsUpdateGrid(IntPtr currents, float originX, float originY,
+        float spacing, int width, int height);
+
+    [DllImport("thrive_native")]
+    internal static extern void FluidCurrentsSampleVelocities(IntPtr currents, in float positionsX,
+        in float positionsY, int count, ref float resultX, ref float resultY);
+}
@@ -321,7 +321,7 @@ public partial class MicrobeWorldSimulation : WorldSimulationWithPhysics
         }
 
         entitySignalingSystem = new EntitySignalingSystem(EntitySystem, parallelRunner);
-        fluidCurrentsSystem = new FluidCurrentsSystem(EntitySystem, parallelRunner);
+        fluidCurrentsSystem = new FluidCurrentsSystem(physics, EntitySystem, parallelRunner);
 
         SpawnSystem = new SpawnSystem(this);
     }
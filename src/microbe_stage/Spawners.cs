@@ -1075,6 +1075,9 @@ public static class SpawnHelpers
         {
             Velocity = normalizedDirection * Constants.AGENT_EMISSION_VELOCITY,
             AxisLock = Physics.AxisLockType.YAxisWithRotation,
+
+            // Projectiles are fast and small so they would go through things without this
+            ContinuousCollision = true,
         });
 
         // Need to specify shape like this to make saving work
@@ -1,14 +1,20 @@
 ﻿namespace Components;
 
+using Newtonsoft.Json;
 using Systems;
 
 /// <summary>
-///   Marks entity as being affected by <see cref="FluidCurrentsSystem"/>. Additionally
-///   <see cref="ManualPhysicsControl"/> and <see cref="WorldPosition"/> are required components.
+///   Marks entity as being affected by <see cref="FluidCurrentsSystem"/>. Additionally <see cref="Physics"/> is a
+///   required component. The currents are applied by the physics world to the physics body each physics step.
 ///   This exists as currents need to be skipped for microbes for now as we don't have visualizations for the
 ///   currents.
 /// </summary>
 [JSONDynamicTypeAllowed]
 public struct CurrentAffected
 {
+    /// <summary>
+    ///   The body the flow response has been set on. Used to detect when the physics body is created or replaced.
+    /// </summary>
+    [JsonIgnore]
+    public NativePhysicsBody? FlowAppliedToBody;
 }
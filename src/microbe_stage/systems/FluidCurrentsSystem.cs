@@ -7,56 +7,46 @@ using DefaultEcs.System;
 using DefaultEcs.Threading;
 using Godot;
 using Newtonsoft.Json;
-using FastNoiseLite = FastNoiseLite;
 using World = DefaultEcs.World;
 
 /// <summary>
-///   Gives a push from currents in a fluid to physics entities (that have <see cref="ManualPhysicsControl"/>).
-///   Only acts on entities marked with <see cref="CurrentAffected"/>.
+///   Gives a push from currents in a fluid to physics entities. Only acts on entities marked with
+///   <see cref="CurrentAffected"/>.
 /// </summary>
+/// <remarks>
+///   <para>
+///     The push is applied natively by the physical world on each physics step, this system just registers the
+///     currents with the world, keeps the time of the currents up to date and sets the flow response of new physics
+///     bodies. When an area is set with <see cref="SetVelocityGridArea"/> a coarse grid of the currents is
+///     calculated each update for the compound clouds.
+///   </para>
+/// </remarks>
 [With(typeof(CurrentAffected))]
 [With(typeof(Physics))]
-[With(typeof(ManualPhysicsControl))]
-[With(typeof(WorldPosition))]
-[ReadsComponent(typeof(CurrentAffected))]
+[WritesToComponent(typeof(CurrentAffected))]
 [ReadsComponent(typeof(Physics))]
-[ReadsComponent(typeof(WorldPosition))]
-[RuntimeCost(8)]
+[RuntimeCost(0.5f)]
 [JsonObject(MemberSerialization.OptIn)]
 public sealed class FluidCurrentsSystem : AEntitySetSystem<float>
 {
-    private const float DISTURBANCE_TIMESCALE = 1.000f;
-    private const float CURRENTS_TIMESCALE = 1.000f / 500.0f;
-    private const float CURRENTS_STRETCHING_MULTIPLIER = 1.0f / 10.0f;
-    private const float MIN_CURRENT_INTENSITY = 0.4f;
-    private const float DISTURBANCE_TO_CURRENTS_RATIO = 0.15f;
-    private const float POSITION_SCALING = 0.9f;
-
-    // TODO: test the inbuilt fast noise in Godot to see if it is faster / a good enough replacement
-    private readonly FastNoiseLite noiseDisturbancesX;
-    private readonly FastNoiseLite noiseDisturbancesY;
-    private readonly FastNoiseLite noiseCurrentsX;
-    private readonly FastNoiseLite noiseCurrentsY;
-
-    // private readonly Vector2 scale = new Vector2(0.05f, 0.05f);
+    private readonly FluidCurrents? currents;
+    private readonly PhysicalWorld? physicalWorld;
 
     [JsonProperty]
     private float currentsTimePassed;
 
-    public FluidCurrentsSystem(World world, IParallelRunner runner) : base(world, runner,
-        Constants.SYSTEM_HIGHER_ENTITIES_PER_THREAD)
-    {
-        noiseDisturbancesX = new FastNoiseLite(69);
-        noiseDisturbancesX.SetNoiseType(FastNoiseLite.NoiseType.Perlin);
-
-        noiseDisturbancesY = new FastNoiseLite(13);
-        noiseDisturbancesY.SetNoiseType(FastNoiseLite.NoiseType.Perlin);
+    private Vector2 gridOrigin;
+    private float gridSpacing;
+    private int gridWidth;
+    private int gridHeight;
 
-        noiseCurrentsX = new FastNoiseLite(420);
-        noiseCurrentsX.SetNoiseType(FastNoiseLite.NoiseType.Perlin);
+    public FluidCurrentsSystem(PhysicalWorld physicalWorld, World world, IParallelRunner runner) : base(world,
+        runner, Constants.SYSTEM_HIGHER_ENTITIES_PER_THREAD)
+    {
+        this.physicalWorld = physicalWorld;
+        currents = new FluidCurrents();
 
-        noiseCurrentsY = new FastNoiseLite(1337);
-        noiseCurrentsY.SetNoiseType(FastNoiseLite.NoiseType.Perlin);
+        physicalWorld.SetFlowFieldCurrents(currents);
     }
 
     /// <summary>
@@ -66,34 +56,38 @@ public sealed class FluidCurrentsSystem : AEntitySetSystem<float>
     public FluidCurrentsSystem(float currentsTimePassed) : base(TemporarySystemHelper.GetDummyWorldForLoad(), null)
     {
         this.currentsTimePassed = currentsTimePassed;
-
-        noiseDisturbancesX = null!;
-        noiseDisturbancesY = null!;
-        noiseCurrentsX = null!;
-        noiseCurrentsY = null!;
     }
 
+    /// <summary>
+    ///   The native currents, used by the compound clouds to calculate their velocities directly
+    /// </summary>
+    public FluidCurrents Currents => currents ?? throw new InvalidOperationException("Temporary instance");
+
     public Vector2 VelocityAt(Vector2 position)
     {
-        var scaledPosition = position * POSITION_SCALING;
-
-        float disturbancesX = noiseDisturbancesX.GetNoise(scaledPosition.X, scaledPosition.Y,
-            currentsTimePassed * DISTURBANCE_TIMESCALE);
-        float disturbancesY = noiseDisturbancesY.GetNoise(scaledPosition.X, scaledPosition.Y,
-            currentsTimePassed * DISTURBANCE_TIMESCALE);
-
-        float currentsX = noiseCurrentsX.GetNoise(scaledPosition.X * CURRENTS_STRETCHING_MULTIPLIER,
-            scaledPosition.Y, currentsTimePassed * CURRENTS_TIMESCALE);
-        float currentsY = noiseCurrentsY.GetNoise(scaledPosition.X,
-            scaledPosition.Y * CURRENTS_STRETCHING_MULTIPLIER,
-            currentsTimePassed * CURRENTS_TIMESCALE);
+        return Currents.VelocityAt(position);
+    }
 
-        var disturbancesVelocity = new Vector2(disturbancesX, disturbancesY);
-        var currentsVelocity = new Vector2(Math.Abs(currentsX) > MIN_CURRENT_INTENSITY ? currentsX : 0.0f,
-            Math.Abs(currentsY) > MIN_CURRENT_INTENSITY ? currentsY : 0.0f);
+    /// <summary>
+    ///   Sets the area where a grid of the currents is calculated on each update. Positions inside the grid are
+    ///   interpolated from it. The grid is calculated on the next update.
+    /// </summary>
+    /// <param name="origin">World position (x, z) of the first grid point</param>
+    /// <param name="spacing">Distance between the grid points</param>
+    /// <param name="width">Number of grid points along the x-axis, 0 to not use a grid</param>
+    /// <param name="height">Number of grid points along the z-axis</param>
+    public void SetVelocityGridArea(Vector2 origin, float spacing, int width, int height)
+    {
+        gridOrigin = origin;
+        gridSpacing = spacing;
+        gridWidth = width;
+        gridHeight = height;
+    }
 
-        return (disturbancesVelocity * DISTURBANCE_TO_CURRENTS_RATIO) +
-            (currentsVelocity * (1.0f - DISTURBANCE_TO_CURRENTS_RATIO));
+    public override void Dispose()
+    {
+        Dispose(true);
+        base.Dispose();
     }
 
     protected override void PreUpdate(float delta)
@@ -101,22 +95,39 @@ public sealed class FluidCurrentsSystem : AEntitySetSystem<float>
         base.PreUpdate(delta);
 
         currentsTimePassed += delta;
+
+        Currents.SetTime(currentsTimePassed);
+
+        // The physics uses its own copy of the time so that physics running in the background doesn't see a partial
+        // update of the currents
+        physicalWorld!.SetFlowFieldTime(currentsTimePassed);
+
+        // The grid needs to be recalculated even if the area is the same as the currents change over time
+        Currents.UpdateGrid(gridOrigin, gridSpacing, gridWidth, gridHeight);
     }
 
     protected override void Update(float delta, in Entity entity)
     {
         ref var physics = ref entity.Get<Physics>();
+        ref var currentAffected = ref entity.Get<CurrentAffected>();
+
+        // The flow response only needs to be set once for each body, after that the physics applies the currents
+        var body = physics.Body;
 
-        if (physics.Body == null)
+        if (ReferenceEquals(currentAffected.FlowAppliedToBody, body))
             return;
 
-        ref var position = ref entity.Get<WorldPosition>();
-        ref var physicsControl = ref entity.Get<ManualPhysicsControl>();
+        if (body != null)
+            physicalWorld!.SetBodyFlowResponse(body, Constants.MAX_FORCE_APPLIED_BY_CURRENTS);
 
-        var pos = new Vector2(position.Position.X, position.Position.Z);
-        var vel = VelocityAt(pos) * Constants.MAX_FORCE_APPLIED_BY_CURRENTS;
+        currentAffected.FlowAppliedToBody = body;
+    }
 
-        physicsControl.ImpulseToGive += new Vector3(vel.X, 0, vel.Y) * delta;
-        physicsControl.PhysicsApplied = false;
+    private void Dispose(bool disposing)
+    {
+        if (disposing)
+        {
+            currents?.Dispose();
+        }
     }
 }
@@ -175,16 +175,35 @@ public sealed class MicrobePhysicsCreationAndSizeSystem : AEntitySetSystem<float
                 requiresCompoundShape = true;
             }
 
+            // The sub-shape counts describe the shape in use, so a single shape can only be built in the background
+            // when the previous shape was a single shape as well (the previous shape stays in use until the build
+            // is done)
+            bool previousShapeIsSimple = extraData.TotalShapeCount <= 1;
+
             extraData.MicrobeShapesCount = 0;
             extraData.TotalShapeCount = 0;
             extraData.PilusCount = 0;
 
-            // TODO: background thread shape creation to not take up main thread time (or maybe at least the
-            // density calculation?)
+            // A build started for an earlier membrane is no longer wanted
+            if (shapeHolder.PendingShape != null)
+            {
+                shapeHolder.PendingShape.Dispose();
+                shapeHolder.PendingShape = null;
+            }
 
             var oldShape = shapeHolder.Shape;
 
-            if (!requiresCompoundShape)
+            if (!requiresCompoundShape && previousShapeIsSimple)
+            {
+                var cachedShape = StartSimpleMicrobeShapeBuild(ref shapeHolder, ref extraData, ref organelles,
+                    ref cellProperties, rawData, count);
+
+                // A cached shape is applied right away, otherwise PhysicsBodyCreationSystem swaps in the built shape
+                // once it is ready
+                if (cachedShape != null)
+                    shapeHolder.Shape = cachedShape;
+            }
+            else if (!requiresCompoundShape)
             {
                 shapeHolder.Shape = CreateSimpleMicrobeShape(ref extraData, ref organelles, ref cellProperties,
                     rawData, count);
@@ -269,6 +288,27 @@ public sealed class MicrobePhysicsCreationAndSizeSystem : AEntitySetSystem<float
         return shape;
     }
 
+    /// <summary>
+    ///   Background building variant of <see cref="CreateSimpleMicrobeShape"/>. Sets the pending shape of the shape
+    ///   holder if the shape isn't cached.
+    /// </summary>
+    /// <returns>The shape if it was already cached, null when a build was started</returns>
+    private PhysicsShape? StartSimpleMicrobeShapeBuild(ref PhysicsShapeHolder shapeHolder,
+        ref MicrobePhysicsExtraData extraData, ref OrganelleContainer organelles, ref CellProperties cellProperties,
+        Vector2[] membraneVertices, int vertexCount)
+    {
+        UpdateRotationRate(ref organelles);
+
+        shapeHolder.PendingShape = PhysicsShape.GetCachedOrStartMicrobeShapeBuild(membraneVertices, vertexCount,
+            MicrobeInternalCalculations.CalculateAverageDensity(organelles.Organelles!), cellProperties.IsBacteria,
+            out var cachedShape);
+
+        ++extraData.MicrobeShapesCount;
+        ++extraData.TotalShapeCount;
+
+        return cachedShape;
+    }
+
     private PhysicsShape CreateColonyMemberBaseShape(ref MicrobePhysicsExtraData extraData,
         ref OrganelleContainer organelles, Membrane membrane, bool isBacteria)
     {
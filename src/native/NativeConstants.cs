@@ -9,9 +9,9 @@ using SharedBase.Models;
 /// </summary>
 public class NativeConstants
 {
-    public const int Version = 19;
+    public const int Version = 24;
     public const int EarlyCheck = 2;
-    public const int ExtensionVersion = 6;
+    public const int ExtensionVersion = 7;
 
     public const string LibraryFolder = "native_libs";
     public const string DistributableFolderName = "distributable";
@@ -0,0 +1,574 @@
+// ------------------------------------ //
+// Standalone benchmark driver for the native library. Runs without Godot so that it can be used on CI machines without
+// a GPU. Results are printed as JSON (or written to a file) to allow tracking performance across commits.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/TaskSystem.hpp"
+#include "interop/CInterop.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float BENCHMARK_PHYSICS_DELTA = 1 / 60.0f;
+
+/// \brief Fixed seed so that all runs (and commits) simulate the exact same starting world
+constexpr uint32_t BENCHMARK_RANDOM_SEED = 4242;
+
+constexpr int MEMBRANE_POINT_COUNT = 40;
+constexpr int MAX_RECORDED_COLLISIONS = 8;
+
+struct BenchmarkOptions
+{
+    int Microbes = 500;
+    int Chunks = 100;
+    int Sensors = 50;
+    int Steps = 600;
+    int WarmupSteps = 60;
+    int Threads = -1;
+    int Tasks = 200000;
+    std::string OutputFile;
+
+    /// \brief When set a native trace of the benchmark run is written here (needs a tracing enabled build)
+    std::string TraceFile;
+};
+
+struct StepTimings
+{
+    std::vector<double> StepMilliseconds;
+
+    /// \brief Average of the physics time reported by the world itself (only the Jolt update part of a step)
+    double ReportedPhysicsMilliseconds = 0;
+
+    int64_t RecordedCollisions = 0;
+
+    /// \brief Average time spent in the contact listener callbacks per step, summed over all threads. Only measured
+    /// when contact statistics are enabled for the run.
+    double ContactCallbackMilliseconds = 0;
+};
+
+struct TaskThroughput
+{
+    int Tasks = 0;
+    double Seconds = 0;
+};
+
+// ------------------------------------ //
+bool ParseArguments(int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+
+        if (argument == "--help" || argument == "-h")
+        {
+            std::cerr << "Usage: thrive_native_bench [--microbes N] [--chunks N] [--sensors N] [--steps N] "
+                         "[--warmup N] [--threads N] [--tasks N] [--output file.json] [--trace trace.json]\n";
+            return false;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for argument: " << argument << "\n";
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (argument == "--output")
+        {
+            options.OutputFile = value;
+            continue;
+        }
+
+        if (argument == "--trace")
+        {
+            options.TraceFile = value;
+            continue;
+        }
+
+        int* target = nullptr;
+
+        if (argument == "--microbes")
+        {
+            target = &options.Microbes;
+        }
+        else if (argument == "--chunks")
+        {
+            target = &options.Chunks;
+        }
+        else if (argument == "--sensors")
+        {
+            target = &options.Sensors;
+        }
+        else if (argument == "--steps")
+        {
+            target = &options.Steps;
+        }
+        else if (argument == "--warmup")
+        {
+            target = &options.WarmupSteps;
+        }
+        else if (argument == "--threads")
+        {
+            target = &options.Threads;
+        }
+        else if (argument == "--tasks")
+        {
+            target = &options.Tasks;
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << argument << "\n";
+            return false;
+        }
+
+        *target = std::atoi(value);
+    }
+
+    if (options.Steps < 1 || options.Microbes < 0 || options.Chunks < 0 || options.Sensors < 0 ||
+        options.WarmupSteps < 0 || options.Tasks < 0)
+    {
+        std::cerr << "Invalid benchmark options\n";
+        return false;
+    }
+
+    return true;
+}
+
+void ForwardLogMessage(const char* message, int32_t messageLength, int8_t logLevel)
+{
+    // Logs go to stderr to keep the JSON output clean
+    if (logLevel >= 2)
+        std::cerr << std::string_view(message, messageLength) << "\n";
+}
+
+double Mean(const std::vector<double>& values)
+{
+    if (values.empty())
+        return 0;
+
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+double Percentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0;
+
+    const auto index = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedValues.size())));
+
+    return sortedValues[std::clamp<size_t>(index, 1, sortedValues.size()) - 1];
+}
+
+// ------------------------------------ //
+/// \brief Physics world populated with microbe like bodies similar to what the game creates
+class SyntheticWorld
+{
+public:
+    SyntheticWorld(const BenchmarkOptions& options, bool recordCollisions) : random(BENCHMARK_RANDOM_SEED)
+    {
+        world = CreatePhysicalWorld();
+        PhysicalWorldRemoveGravity(world);
+
+        // Each process call should run exactly one step to get clean per-step timings
+        PhysicalWorldSetSteppingPolicy(world, 1, false, 1);
+
+        // Roughly the density of a busy patch in the game
+        const float worldSize = std::sqrt(static_cast<float>(options.Microbes + options.Chunks) * 40.0f) + 20;
+        std::uniform_real_distribution<float> positionDistribution(-worldSize * 0.5f, worldSize * 0.5f);
+
+        const auto randomPosition = [&]()
+        { return JVec3{positionDistribution(random), 0, positionDistribution(random)}; };
+
+        CreateMicrobes(options.Microbes, recordCollisions, randomPosition);
+        CreateChunks(options.Chunks, randomPosition);
+        CreateSensors(options.Sensors, randomPosition);
+    }
+
+    ~SyntheticWorld()
+    {
+        for (auto* body : bodies)
+        {
+            DestroyPhysicalWorldBody(world, body);
+            ReleasePhysicsBodyReference(body);
+        }
+
+        for (auto* shape : shapes)
+        {
+            ReleaseShape(shape);
+        }
+
+        DestroyPhysicalWorld(world);
+    }
+
+    SyntheticWorld(const SyntheticWorld& other) = delete;
+    SyntheticWorld& operator=(const SyntheticWorld& other) = delete;
+
+    /// \brief Applies movement to all microbes and runs a single physics step
+    /// \returns The wall time the step took in milliseconds or a negative value if no step was ran
+    double Step()
+    {
+        std::uniform_real_distribution<float> directionDistribution(-1, 1);
+
+        for (auto* microbe : microbes)
+        {
+            // Change direction now and then like the AI does
+            if (random() % 30 == 0)
+            {
+                const float angle = directionDistribution(random) * 3.14159f;
+                const auto movement = JVecF3{std::sin(angle) * 20, 0, std::cos(angle) * 20};
+                const auto rotation = JQuat{0, std::sin(angle * 0.5f), 0, std::cos(angle * 0.5f)};
+
+                SetBodyControl(world, microbe, movement, rotation, 0.2f);
+            }
+        }
+
+        const auto start = Clock::now();
+
+        const bool stepped = ProcessPhysicalWorld(world, BENCHMARK_PHYSICS_DELTA);
+
+        const auto end = Clock::now();
+
+        if (!stepped)
+            return -1;
+
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    [[nodiscard]] int64_t CountActiveCollisions() const
+    {
+        int64_t total = 0;
+
+        for (const auto* count : collisionCounts)
+        {
+            total += *count;
+        }
+
+        return total;
+    }
+
+    [[nodiscard]] PhysicalWorld* GetWorld() const
+    {
+        return world;
+    }
+
+private:
+    template<typename PositionGenerator>
+    void CreateMicrobes(int count, bool recordCollisions, PositionGenerator& randomPosition)
+    {
+        std::uniform_real_distribution<float> radiusDistribution(1.0f, 3.0f);
+
+        // A handful of different membrane shapes are shared like species share them in the game
+        std::vector<PhysicsShape*> membraneShapes;
+        std::vector<JVecF3> points(MEMBRANE_POINT_COUNT);
+
+        for (int shapeIndex = 0; shapeIndex < 8; ++shapeIndex)
+        {
+            const float radius = radiusDistribution(random);
+
+            for (int i = 0; i < MEMBRANE_POINT_COUNT; ++i)
+            {
+                const float angle = static_cast<float>(i) / MEMBRANE_POINT_COUNT * 2 * 3.14159f;
+
+                // Slightly wobbly membrane to not be a perfect circle
+                const float pointRadius = radius * (1 + 0.1f * std::sin(angle * static_cast<float>(shapeIndex + 2)));
+                points[i] = JVecF3{std::cos(angle) * pointRadius, 0, std::sin(angle) * pointRadius};
+            }
+
+            auto* shape = CreateMicrobeShapeConvex(points.data(), MEMBRANE_POINT_COUNT, 1000, 1, 1);
+
+            if (shape == nullptr)
+                continue;
+
+            membraneShapes.push_back(shape);
+            shapes.push_back(shape);
+        }
+
+        if (membraneShapes.empty())
+            return;
+
+        if (recordCollisions)
+            collisionBuffer.resize(static_cast<size_t>(count) * MAX_RECORDED_COLLISIONS * sizeof(PhysicsCollision));
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto* body = PhysicalWorldCreateMovingBodyWithAxisLock(world,
+                membraneShapes[i % membraneShapes.size()], randomPosition(), QuatIdentity, JVecF3{0, 1, 0}, true, true);
+
+            if (body == nullptr)
+                continue;
+
+            if (recordCollisions)
+            {
+                auto* target =
+                    collisionBuffer.data() + static_cast<size_t>(i) * MAX_RECORDED_COLLISIONS * sizeof(PhysicsCollision);
+
+                collisionCounts.push_back(
+                    PhysicsBodyEnableCollisionRecording(world, body, target, MAX_RECORDED_COLLISIONS));
+            }
+
+            microbes.push_back(body);
+            bodies.push_back(body);
+        }
+    }
+
+    template<typename PositionGenerator>
+    void CreateChunks(int count, PositionGenerator& randomPosition)
+    {
+        std::uniform_real_distribution<float> pointDistribution(-1.5f, 1.5f);
+
+        std::vector<JVecF3> points(12);
+        for (auto& point : points)
+        {
+            point = JVecF3{pointDistribution(random), pointDistribution(random) * 0.3f, pointDistribution(random)};
+        }
+
+        auto* shape = CreateConvexShape(points.data(), static_cast<uint32_t>(points.size()), 500);
+
+        if (shape == nullptr)
+            return;
+
+        shapes.push_back(shape);
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto* body = PhysicalWorldCreateMovingBodyWithAxisLock(
+                world, shape, randomPosition(), QuatIdentity, JVecF3{0, 1, 0}, false, true);
+
+            if (body != nullptr)
+                bodies.push_back(body);
+        }
+    }
+
+    template<typename PositionGenerator>
+    void CreateSensors(int count, PositionGenerator& randomPosition)
+    {
+        auto* shape = CreateSphereShape(5);
+
+        if (shape == nullptr)
+            return;
+
+        shapes.push_back(shape);
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto* body = PhysicalWorldCreateSensor(world, shape, randomPosition(), QuatIdentity, false, false);
+
+            if (body != nullptr)
+                bodies.push_back(body);
+        }
+    }
+
+private:
+    std::mt19937 random;
+
+    PhysicalWorld* world = nullptr;
+
+    std::vector<PhysicsShape*> shapes;
+    std::vector<PhysicsBody*> bodies;
+    std::vector<PhysicsBody*> microbes;
+
+    std::vector<char> collisionBuffer;
+    std::vector<int32_t*> collisionCounts;
+};
+
+// ------------------------------------ //
+StepTimings RunPhysicsBenchmark(const BenchmarkOptions& options, bool recordCollisions, bool measureContacts)
+{
+    SyntheticWorld world(options, recordCollisions);
+
+    if (measureContacts)
+        PhysicalWorldSetContactStatisticsEnabled(world.GetWorld(), true);
+
+    for (int i = 0; i < options.WarmupSteps; ++i)
+    {
+        world.Step();
+    }
+
+    StepTimings result;
+    result.StepMilliseconds.reserve(options.Steps);
+
+    double reportedTotal = 0;
+    double contactCallbackTotal = 0;
+
+    PhysicsStepStatistics statistics{};
+
+    for (int i = 0; i < options.Steps; ++i)
+    {
+        const auto time = world.Step();
+
+        if (time < 0)
+            continue;
+
+        result.StepMilliseconds.push_back(time);
+        reportedTotal += PhysicalWorldGetPhysicsLatestTime(world.GetWorld()) * 1000.0;
+        result.RecordedCollisions += world.CountActiveCollisions();
+
+        // The stepping policy makes each process call run exactly one update so the latest entry is this step
+        if (measureContacts && PhysicalWorldGetStepStatistics(world.GetWorld(), &statistics, 1) == 1)
+            contactCallbackTotal += statistics.ContactCallbackTime * 1000.0;
+    }
+
+    if (!result.StepMilliseconds.empty())
+    {
+        const auto samples = static_cast<double>(result.StepMilliseconds.size());
+
+        result.ReportedPhysicsMilliseconds = reportedTotal / samples;
+        result.ContactCallbackMilliseconds = contactCallbackTotal / samples;
+    }
+
+    std::sort(result.StepMilliseconds.begin(), result.StepMilliseconds.end());
+    return result;
+}
+
+TaskThroughput RunTaskSystemBenchmark(int taskCount)
+{
+    auto& taskSystem = Thrive::TaskSystem::Get();
+
+    std::atomic<int> completed{0};
+
+    const auto start = Clock::now();
+
+    for (int i = 0; i < taskCount; ++i)
+    {
+        taskSystem.QueueTask([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); });
+    }
+
+    while (completed.load(std::memory_order_acquire) < taskCount)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto end = Clock::now();
+
+    return TaskThroughput{taskCount, std::chrono::duration<double>(end - start).count()};
+}
+
+// ------------------------------------ //
+void WriteTimings(std::ostream& output, const char* name, const StepTimings& timings, bool last)
+{
+    const auto& values = timings.StepMilliseconds;
+
+    output << "    \"" << name << "\": {\n";
+    output << "      \"samples\": " << values.size() << ",\n";
+    output << "      \"mean_ms\": " << Mean(values) << ",\n";
+    output << "      \"p50_ms\": " << Percentile(values, 50) << ",\n";
+    output << "      \"p90_ms\": " << Percentile(values, 90) << ",\n";
+    output << "      \"p99_ms\": " << Percentile(values, 99) << ",\n";
+    output << "      \"max_ms\": " << (values.empty() ? 0 : values.back()) << ",\n";
+    output << "      \"reported_physics_ms\": " << timings.ReportedPhysicsMilliseconds << ",\n";
+    output << "      \"recorded_collisions\": " << timings.RecordedCollisions << "\n";
+    output << "    }" << (last ? "\n" : ",\n");
+}
+
+void WriteResults(std::ostream& output, const BenchmarkOptions& options, const StepTimings& withRecording,
+    const StepTimings& withoutRecording, const StepTimings& contactMeasurement, const TaskThroughput& tasks)
+{
+    // Difference of the separately ran worlds, so this is only a rough estimate that run-to-run noise affects. The
+    // medians are used to not let a few outlier steps dominate the difference.
+    const double recordingCost =
+        Percentile(withRecording.StepMilliseconds, 50) - Percentile(withoutRecording.StepMilliseconds, 50);
+
+    output << "{\n";
+    output << "  \"library_version\": " << CheckAPIVersion() << ",\n";
+    output << "  \"config\": {\n";
+    output << "    \"microbes\": " << options.Microbes << ",\n";
+    output << "    \"chunks\": " << options.Chunks << ",\n";
+    output << "    \"sensors\": " << options.Sensors << ",\n";
+    output << "    \"steps\": " << options.Steps << ",\n";
+    output << "    \"warmup_steps\": " << options.WarmupSteps << ",\n";
+    output << "    \"threads\": " << GetNativeExecutorThreads() << "\n";
+    output << "  },\n";
+    output << "  \"physics\": {\n";
+    WriteTimings(output, "with_collision_recording", withRecording, false);
+    WriteTimings(output, "without_collision_recording", withoutRecording, true);
+    output << "  },\n";
+    output << "  \"collision_recording_step_delta_ms\": " << recordingCost << ",\n";
+    // Measured in a separate run as timing each callback slows down the steps a bit. This is CPU time summed over
+    // all the threads, not wall time.
+    output << "  \"contact_listener_cost_ms\": " << contactMeasurement.ContactCallbackMilliseconds << ",\n";
+    output << "  \"task_system\": {\n";
+    output << "    \"tasks\": " << tasks.Tasks << ",\n";
+    output << "    \"seconds\": " << tasks.Seconds << ",\n";
+    output << "    \"tasks_per_second\": " << (tasks.Seconds > 0 ? tasks.Tasks / tasks.Seconds : 0) << "\n";
+    output << "  }\n";
+    output << "}\n";
+}
+
+} // namespace
+
+// ------------------------------------ //
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if (!ParseArguments(argc, argv, options))
+        return 1;
+
+    SetLogForwardingCallback(&ForwardLogMessage);
+
+    if (InitThriveLibrary() != 0)
+    {
+        std::cerr << "Failed to initialize the native library\n";
+        return 2;
+    }
+
+    if (options.Threads > 0)
+        SetNativeExecutorThreads(options.Threads);
+
+    const bool tracing = !options.TraceFile.empty() && StartNativeTracing(1 << 20);
+
+    const auto withRecording = RunPhysicsBenchmark(options, true, false);
+    const auto withoutRecording = RunPhysicsBenchmark(options, false, false);
+    const auto contactMeasurement = RunPhysicsBenchmark(options, true, true);
+    const auto tasks = RunTaskSystemBenchmark(options.Tasks);
+
+    if (tracing)
+    {
+        StopNativeTracing();
+
+        if (!WriteNativeTraceFile(options.TraceFile.c_str()))
+            std::cerr << "Failed to write trace to: " << options.TraceFile << "\n";
+    }
+
+    std::ostringstream output;
+    output.precision(6);
+    output << std::fixed;
+
+    WriteResults(output, options, withRecording, withoutRecording, contactMeasurement, tasks);
+
+    ShutdownThriveLibrary();
+
+    if (options.OutputFile.empty())
+    {
+        std::cout << output.str();
+        return 0;
+    }
+
+    std::ofstream file(options.OutputFile);
+    file << output.str();
+
+    if (!file.good())
+    {
+        std::cerr << "Failed to write results to: " << options.OutputFile << "\n";
+        return 3;
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "NonCopyable.hpp"
+
+namespace Thrive
+{
+
+/// \brief Lets threads sleep until new work is published without losing wakeups
+///
+/// Waiters use a two phase protocol: first call PrepareWait, then check for work once more and either call CancelWait
+/// (if work was found) or Wait with the key from PrepareWait. Producers call Notify after publishing work. Notify
+/// only bumps the epoch and calls into the OS if there are threads in the wait phase, so it is cheap when all threads
+/// are busy. The parking uses std::atomic wait which is futex based on the platforms that support it.
+class EventCount final : NonCopyable
+{
+public:
+    using Key = uint32_t;
+
+    EventCount() = default;
+
+    /// \brief Registers the calling thread as a waiter. After this the caller must check the work condition again
+    [[nodiscard]] Key PrepareWait() noexcept
+    {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+
+        // Pairs with the fence in Notify so that either the waiter sees the new work or the producer sees the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        return epoch.load(std::memory_order_acquire);
+    }
+
+    void CancelWait() noexcept
+    {
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Sleeps until Notify is called after the PrepareWait call that returned the key
+    void Wait(Key key) noexcept
+    {
+        while (epoch.load(std::memory_order_acquire) == key)
+        {
+            epoch.wait(key, std::memory_order_acquire);
+        }
+
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Wakes up a single waiting thread, must be called after the work has been made visible to other threads
+    void NotifyOne() noexcept
+    {
+        if (!HasWaiters())
+            return;
+
+        epoch.fetch_add(1, std::memory_order_release);
+        epoch.notify_one();
+    }
+
+    /// \brief Wakes up to count waiting threads
+    void Notify(uint32_t count) noexcept
+    {
+        if (count < 1 || !HasWaiters())
+            return;
+
+        epoch.fetch_add(1, std::memory_order_release);
+
+        if (count == 1)
+        {
+            epoch.notify_one();
+        }
+        else if (count >= waiters.load(std::memory_order_relaxed))
+        {
+            epoch.notify_all();
+        }
+        else
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                epoch.notify_one();
+            }
+        }
+    }
+
+    void NotifyAll() noexcept
+    {
+        if (!HasWaiters())
+            return;
+
+        epoch.fetch_add(1, std::memory_order_release);
+        epoch.notify_all();
+    }
+
+private:
+    [[nodiscard]] bool HasWaiters() const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return waiters.load(std::memory_order_relaxed) != 0;
+    }
+
+private:
+    std::atomic<Key> epoch{0};
+
+    /// \brief Number of threads between PrepareWait and the end of Wait (or CancelWait)
+    std::atomic<uint32_t> waiters{0};
+};
+
+} // namespace Thrive
@@ -18,4 +18,9 @@ class PhysicsBody;
 class PhysicalWorld;
 class TrackedConstraint;
 } // namespace Physics
+
+namespace Simulation
+{
+class FluidCurrents;
+} // namespace Simulation
 } // namespace Thrive
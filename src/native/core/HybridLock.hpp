@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "NonCopyable.hpp"
+
+namespace Thrive
+{
+
+/// \brief How many times hybrid primitives spin with a CPU pause before falling back to yielding the thread
+constexpr int HYBRID_SPIN_COUNT = 64;
+
+/// \brief How many times hybrid primitives yield their time slice before parking the thread
+constexpr int HYBRID_YIELD_COUNT = 16;
+
+/// \brief Runs the spin and yield phases of a hybrid wait until the condition becomes true
+/// \returns True if the condition became true, false if the caller should park the thread
+template<typename Condition>
+inline bool HybridSpinUntil(Condition&& condition) noexcept
+{
+    for (int i = 0; i < HYBRID_SPIN_COUNT; ++i)
+    {
+        if (condition())
+            return true;
+
+        HYPER_THREAD_YIELD;
+    }
+
+    for (int i = 0; i < HYBRID_YIELD_COUNT; ++i)
+    {
+        if (condition())
+            return true;
+
+        std::this_thread::yield();
+    }
+
+    return condition();
+}
+
+/// \brief A lock that first spins briefly, then yields and finally parks the waiting thread (using the futex like
+/// wait of std::atomic) so that long waits don't burn a full core
+///
+/// Uncontended lock and unlock cost the same as with Spinlock. The state is 0 when unlocked, 1 when locked and 2
+/// when locked and there may be threads parked waiting for the lock.
+class HybridLock final : NonCopyable
+{
+public:
+    HybridLock() = default;
+
+    void Lock() noexcept
+    {
+        uint32_t expected = 0;
+        if (state.compare_exchange_strong(expected, 1, std::memory_order_acquire)) [[likely]]
+            return;
+
+        if (HybridSpinUntil([this]() { return TryLock(); }))
+            return;
+
+        // Mark the lock as contended so that the unlocking thread knows to wake someone up
+        while (state.exchange(2, std::memory_order_acquire) != 0)
+        {
+            state.wait(2, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryLock() noexcept
+    {
+        uint32_t expected = 0;
+        return state.load(std::memory_order_relaxed) == 0 &&
+            state.compare_exchange_strong(expected, 1, std::memory_order_acquire);
+    }
+
+    void Unlock() noexcept
+    {
+        if (state.exchange(0, std::memory_order_release) == 2) [[unlikely]]
+            state.notify_one();
+    }
+
+private:
+    std::atomic<uint32_t> state{0};
+};
+
+/// \brief Manual reset event that waits with the same spin, yield and then park approach as HybridLock
+///
+/// Set only calls into the OS to wake threads if some thread has actually parked on this event.
+class HybridEvent final : NonCopyable
+{
+public:
+    explicit HybridEvent(bool initiallySet = false) : signaled(initiallySet ? 1 : 0)
+    {
+    }
+
+    void Set() noexcept
+    {
+        signaled.store(1);
+
+        if (parkedWaiters.load() != 0) [[unlikely]]
+            signaled.notify_all();
+    }
+
+    void Reset() noexcept
+    {
+        signaled.store(0, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool IsSet() const noexcept
+    {
+        return signaled.load(std::memory_order_acquire) != 0;
+    }
+
+    void Wait() noexcept
+    {
+        if (HybridSpinUntil([this]() { return IsSet(); }))
+            return;
+
+        // The waiter count is registered before checking the flag (and Set does this in the reverse order) so with
+        // sequentially consistent operations a wakeup can't be missed
+        parkedWaiters.fetch_add(1);
+
+        while (signaled.load() == 0)
+        {
+            signaled.wait(0);
+        }
+
+        parkedWaiters.fetch_sub(1);
+    }
+
+private:
+    std::atomic<uint32_t> signaled;
+    std::atomic<uint32_t> parkedWaiters{0};
+};
+
+} // namespace Thrive
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Thrive
+{
+
+/// \brief Type erased callable like std::function<void()> but that never allocates memory
+///
+/// The callable object is always stored in the inline buffer, trying to store a too big callable (for example a lambda
+/// with a lot of captures) is a compile error. Only move operations are supported.
+template<std::size_t Size>
+class InlineCallable
+{
+    struct Operations
+    {
+        void (*Invoke)(void* storage);
+        void (*MoveTo)(void* storage, void* target) noexcept;
+        void (*Destroy)(void* storage) noexcept;
+    };
+
+    template<typename T>
+    static constexpr Operations OperationsFor = {
+        [](void* storage) { (*static_cast<T*>(storage))(); },
+        [](void* storage, void* target) noexcept
+        {
+            new (target) T(std::move(*static_cast<T*>(storage)));
+            static_cast<T*>(storage)->~T();
+        },
+        [](void* storage) noexcept { static_cast<T*>(storage)->~T(); },
+    };
+
+public:
+    InlineCallable() noexcept = default;
+
+    template<typename Callable,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, InlineCallable> &&
+            std::is_invocable_v<std::decay_t<Callable>&>>>
+    InlineCallable(Callable&& callable) // NOLINT(*-explicit-constructor)
+    {
+        using T = std::decay_t<Callable>;
+
+        static_assert(sizeof(T) <= Size, "Callable captures too much data to fit in the inline callable storage");
+        static_assert(alignof(T) <= alignof(void*), "Callable has too strict alignment");
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Callable must be nothrow move constructible");
+
+        new (storage) T(std::forward<Callable>(callable));
+        operations = &OperationsFor<T>;
+    }
+
+    InlineCallable(InlineCallable&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    InlineCallable(const InlineCallable& other) = delete;
+
+    ~InlineCallable()
+    {
+        Reset();
+    }
+
+    InlineCallable& operator=(InlineCallable&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+
+        return *this;
+    }
+
+    InlineCallable& operator=(const InlineCallable& other) = delete;
+
+    void operator()() const
+    {
+        operations->Invoke(const_cast<std::byte*>(storage));
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return operations != nullptr;
+    }
+
+    void Reset() noexcept
+    {
+        if (operations != nullptr)
+        {
+            operations->Destroy(storage);
+            operations = nullptr;
+        }
+    }
+
+private:
+    void MoveFrom(InlineCallable& other) noexcept
+    {
+        if (other.operations != nullptr)
+        {
+            other.operations->MoveTo(other.storage, storage);
+            operations = other.operations;
+            other.operations = nullptr;
+        }
+    }
+
+private:
+    // Pointer alignment is enough for normal captures and keeps the size of this minimal
+    alignas(void*) std::byte storage[Size];
+
+    const Operations* operations = nullptr;
+};
+
+} // namespace Thrive
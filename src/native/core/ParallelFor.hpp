@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "Include.h"
+
+#include "TaskSystem.hpp"
+#include "Tracing.hpp"
+
+namespace Thrive
+{
+
+/// \brief Shared state of a ParallelFor call. Reference counted as task threads that start only after all chunks are
+/// already processed still need to be able to check that there's nothing left to do.
+template<class Callback>
+class ParallelForBatch
+{
+public:
+    ParallelForBatch(const Callback& callback, size_t itemCount, size_t chunkSize) :
+        callback(callback), itemCount(itemCount), chunkSize(chunkSize),
+        chunkCount((itemCount + chunkSize - 1) / chunkSize)
+    {
+    }
+
+    /// \brief Processes chunks until there are none left
+    void RunChunks()
+    {
+        TRACE_SCOPE("ParallelForChunks");
+
+        while (true)
+        {
+            const auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+
+            if (chunk >= chunkCount)
+                return;
+
+            const auto start = chunk * chunkSize;
+            callback(start, std::min(start + chunkSize, itemCount));
+
+            completedChunks.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /// \brief Waits for chunks that other threads have started to complete
+    void WaitForCompletion() const
+    {
+        while (completedChunks.load(std::memory_order_acquire) < chunkCount)
+        {
+            HYPER_THREAD_YIELD;
+        }
+    }
+
+    [[nodiscard]] size_t GetChunkCount() const noexcept
+    {
+        return chunkCount;
+    }
+
+private:
+    const Callback& callback;
+    const size_t itemCount;
+    const size_t chunkSize;
+    const size_t chunkCount;
+
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> completedChunks{0};
+};
+
+/// \brief Calls callback(start, end) for consecutive ranges of at most chunkSize items until all items are processed
+///
+/// Chunks are processed on the task system in parallel. The calling thread also processes chunks so this can't
+/// deadlock even when all task threads are busy. Returns once all chunks are done.
+template<class Callback>
+void ParallelFor(size_t itemCount, size_t chunkSize, const Callback& callback)
+{
+    if (itemCount < 1)
+        return;
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    auto& taskSystem = TaskSystem::Get();
+
+    if (itemCount <= chunkSize || taskSystem.GetThreads() < 2)
+    {
+        callback(0, itemCount);
+        return;
+    }
+
+    auto batch = std::make_shared<ParallelForBatch<Callback>>(callback, itemCount, chunkSize);
+
+    const auto helpers = std::min(batch->GetChunkCount() - 1, static_cast<size_t>(taskSystem.GetThreads()));
+
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        taskSystem.QueueTaskFromBackgroundThread([batch]() { batch->RunChunks(); });
+    }
+
+    batch->RunChunks();
+    batch->WaitForCompletion();
+}
+
+} // namespace Thrive
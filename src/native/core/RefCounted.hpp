@@ -40,6 +40,12 @@ public:
         intrusive_ptr_add_ref(this);
     }
 
+    /// \brief Current reference count, only reliable when no other threads can add or remove references
+    [[nodiscard]] FORCE_INLINE int32_t GetRefCount() const noexcept
+    {
+        return static_cast<int32_t>(refCount.load(std::memory_order_relaxed));
+    }
+
 protected:
     friend void intrusive_ptr_add_ref(const RefCountedBase* obj)
     {
@@ -36,8 +36,8 @@ public:
                 // Reduce hyperthreaded core usage to work more efficiently on modern systems
                 HYPER_THREAD_YIELD;
 
-                // TODO: create a hybrid lock variant that falls back to a condition variable after some time to let
-                // the thread sleep
+                // For locks that can be held for a longer time HybridLock should be used instead as it lets the
+                // waiting thread sleep
             }
         }
     }
@@ -5,6 +5,7 @@
 
 #include "Logger.hpp"
 #include "Time.hpp"
+#include "Tracing.hpp"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -27,11 +28,32 @@ static thread_local int MainThreadIdentifier = 0;
 
 static std::atomic<int> ThreadIdentifierNumber{0};
 
+/// \brief Index of the local job queue of the current worker thread, -1 if not a worker or it has no local queue
+static thread_local int LocalQueueSlot = -1;
+
+/// \brief Xorshift state used to pick random threads to steal from
+static thread_local uint32_t StealRandomState = 1;
+
 std::string GenerateThreadName(int id)
 {
     return "TNative_" + std::to_string(id);
 }
 
+#ifdef THRIVE_NATIVE_TRACING
+/// \brief Name to show a Jolt job with in traces. Jolt only keeps the job names when its profiling support is on.
+/// This is a template to be able to take in the protected job type.
+template<typename JobType>
+const char* GetJobTraceName(const JobType* job)
+{
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+    return job->GetName();
+#else
+    UNUSED(job);
+    return "JoltJob";
+#endif
+}
+#endif
+
 #ifdef _WIN32
 
 // Thread rename trick on Windows
@@ -141,23 +163,16 @@ TaskSystem::QueuedTask::QueuedTask(SimpleCallable callable)
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cppcoreguidelines-pro-type-member-init"
 
-#ifdef USE_LOCK_FREE_QUEUE
 TaskSystem::QueuedTask::QueuedTask() : Type(TaskType::Cleared)
 {
+    static_assert(sizeof(QueuedTask) <= 64, "Queued tasks should fit in a cache line");
 }
-#endif
 
-TaskSystem::QueuedTask::QueuedTask(std::function<void()> callable) : Type(TaskType::StdFunction)
+TaskSystem::QueuedTask::QueuedTask(TaskCallable&& callable) : Type(TaskType::Callable)
 {
-    new (&Function) std::function<void()>(std::move(callable));
+    new (&Function) TaskCallable(std::move(callable));
 }
 
-/*TaskSystem::QueuedTask::QueuedTask(std::function<void()>&& callable)
-{
-    Type = TaskType::StdFunction;
-    new (&Function) std::function<void()>(std::move(callable));
-}*/
-
 TaskSystem::QueuedTask::QueuedTask(Job* callable) : Type(TaskType::JoltJob)
 {
     callable->AddRef();
@@ -186,25 +201,36 @@ void TaskSystem::QueuedTask::Invoke() const
             LOG_ERROR("Can't execute quit command");
             break;
         case TaskType::Simple:
+        {
+            TRACE_SCOPE("Task");
             Simple();
             break;
-        case TaskType::StdFunction:
+        }
+        case TaskType::Callable:
+        {
+            TRACE_SCOPE("Task");
             Function();
             break;
+        }
         case TaskType::JoltJob:
+        {
+            TRACE_SCOPE(GetJobTraceName(Jolt));
+
             // TODO: handle the return value?
             Jolt->Execute();
             break;
+        }
     }
 }
 
 TaskSystem::QueuedTask& TaskSystem::QueuedTask::operator=(QueuedTask&& other) noexcept
 {
-    if (other.Type != Type)
-    {
-        ReleaseCurrentData();
-        Type = other.Type;
-    }
+    if (this == &other) [[unlikely]]
+        return *this;
+
+    // Current data is always released as placing the new data on top of existing data of the same type would leak it
+    ReleaseCurrentData();
+    Type = other.Type;
 
     MoveDataFromOther(std::move(other));
 
@@ -215,8 +241,8 @@ void TaskSystem::QueuedTask::ReleaseCurrentData()
 {
     switch (Type)
     {
-        case TaskType::StdFunction:
-            Function.~function<void()>();
+        case TaskType::Callable:
+            Function.~TaskCallable();
             break;
         case TaskType::JoltJob:
             Jolt->Release();
@@ -245,8 +271,8 @@ void TaskSystem::QueuedTask::MoveDataFromOther(QueuedTask&& other)
         case TaskType::Simple:
             Simple = other.Simple;
             break;
-        case TaskType::StdFunction:
-            new (&Function) std::function<void()>(std::move(other.Function));
+        case TaskType::Callable:
+            new (&Function) TaskCallable(std::move(other.Function));
             break;
         case TaskType::JoltJob:
             // Steal the job from the other one
@@ -257,19 +283,26 @@ void TaskSystem::QueuedTask::MoveDataFromOther(QueuedTask&& other)
 }
 
 TaskSystem::TaskSystem() :
+#ifdef USE_OBJECT_POOLS
+    // Sized to fit all the jobs of a physics step so that the pool doesn't run out when physics is running
+    jobPool(JPH::cMaxPhysicsJobs),
+#endif
 #ifdef USE_LOCK_FREE_QUEUE
     // Must have enough queue size to not deadlock when running with 32 threads (untested if this works with more than
     // 32 threads, but hopefully this does)
-    taskQueue(JPH::cMaxPhysicsJobs),
+    taskQueue(JPH::cMaxPhysicsJobs)
 #endif
-    queueLock(queueMutex)
 {
     // Mark main thread
     MainThreadIdentifier = MAIN_THREAD;
+    TRACE_THREAD_NAME("Main");
 
     Init(JPH::cMaxPhysicsBarriers);
 
-    queueLock.unlock();
+#ifdef TASK_QUEUE_USES_POINTERS
+    // Allocate the initial task nodes already to not need to do that when the first tasks are queued
+    FreeTaskNode(AllocateTaskNodeBlock());
+#endif
 
     // Start at least one thread initially
     SetThreads(1);
@@ -293,7 +326,7 @@ void TaskSystem::Shutdown()
 
     // A duplicate notify compared to the EndTaskThread method but this feels better to ensure all threads are woken
     // up if they were waiting immediately on shutdown
-    queueNotify.notify_all();
+    workAvailable.NotifyAll();
 
     try
     {
@@ -309,16 +342,27 @@ void TaskSystem::Shutdown()
         LOG_ERROR(std::string("Failed to join a task thread: ") + e.what());
     }
 
-#ifdef USE_LOCK_FREE_QUEUE
     // Empty out the queue
     for (int i = 0; i < 5; ++i)
     {
         QueuedTask task;
-        while (taskQueue.try_dequeue(task))
+        while (TryDequeueGlobalTask(task))
         {
         }
     }
-#endif
+
+    // And release any jobs that were left in the local queues (threads have ended so this thread can act as the owner)
+    for (auto& localQueue : localQueues)
+    {
+        if (!localQueue)
+            continue;
+
+        Job* job;
+        while (localQueue->Pop(job))
+        {
+            job->Release();
+        }
+    }
 }
 
 bool TaskSystem::IsOnMainThread()
@@ -341,7 +385,7 @@ void TaskSystem::AssertIsMainThread()
 // ------------------------------------ //
 #ifdef USE_LOCK_FREE_QUEUE
 
-void TaskSystem::TryEnqueueTask(QueuedTask&& task)
+void TaskSystem::TryEnqueueTask(GlobalQueueEntry&& entry)
 {
     int retryCount = 0;
 
@@ -350,7 +394,7 @@ void TaskSystem::TryEnqueueTask(QueuedTask&& task)
 #pragma ide diagnostic ignored "bugprone-use-after-move"
 
     // Retry the move until there is room in the queue
-    while (!taskQueue.try_enqueue(std::move(task)))
+    while (!taskQueue.try_enqueue(std::move(entry)))
     {
         ++retryCount;
 
@@ -383,32 +427,70 @@ void TaskSystem::TryEnqueueTask(QueuedTask&& task)
 
 // ------------------------------------ //
 
-void TaskSystem::QueueTask(QueuedTask&& task)
+void TaskSystem::PushGlobalTask(QueuedTask&& task)
 {
-#ifdef USE_LOCK_FREE_QUEUE
-    TryEnqueueTask(std::move(task));
+#ifdef TASK_QUEUE_USES_POINTERS
+    GlobalQueueEntry entry = AllocateTaskNode(std::move(task));
 #else
-    queueLock.lock();
+    GlobalQueueEntry& entry = task;
+#endif
 
-    taskQueue.emplace(std::move(task));
+#ifdef USE_LOCK_FREE_QUEUE
+    TryEnqueueTask(std::move(entry));
+#else
+    std::lock_guard<std::mutex> lock(queueMutex);
 
-    queueLock.unlock();
+    taskQueue.emplace(std::move(entry));
 #endif
+}
 
-    queueNotify.notify_one();
+#ifdef TASK_QUEUE_USES_POINTERS
+TaskSystem::QueuedTask* TaskSystem::AllocateTaskNode(QueuedTask&& task)
+{
+    QueuedTask* node;
+
+    if (!freeTaskNodes.try_dequeue(node)) [[unlikely]]
+        node = AllocateTaskNodeBlock();
+
+    *node = std::move(task);
+    return node;
 }
 
-void TaskSystem::QueueTaskFromBackgroundThread(QueuedTask&& task)
+void TaskSystem::FreeTaskNode(QueuedTask* node)
 {
-#ifdef USE_LOCK_FREE_QUEUE
-    TryEnqueueTask(std::move(task));
-#else
-    std::lock_guard<std::mutex> lock(queueMutex);
+    // Clear the node so that it doesn't keep any resources referenced while in the pool
+    *node = QueuedTask();
+
+    freeTaskNodes.enqueue(node);
+}
+
+TaskSystem::QueuedTask* TaskSystem::AllocateTaskNodeBlock()
+{
+    std::lock_guard<std::mutex> lock(taskNodeBlockMutex);
+
+    auto& block = taskNodeBlocks.emplace_back(std::make_unique<QueuedTask[]>(TASK_NODE_BLOCK_SIZE));
+
+    for (int i = 1; i < TASK_NODE_BLOCK_SIZE; ++i)
+    {
+        freeTaskNodes.enqueue(&block[i]);
+    }
 
-    taskQueue.emplace(std::move(task));
+    return &block[0];
+}
 #endif
 
-    queueNotify.notify_one();
+void TaskSystem::QueueTask(QueuedTask&& task)
+{
+    PushGlobalTask(std::move(task));
+
+    workAvailable.NotifyOne();
+}
+
+void TaskSystem::QueueTaskFromBackgroundThread(QueuedTask&& task)
+{
+    PushGlobalTask(std::move(task));
+
+    workAvailable.NotifyOne();
 }
 
 // ------------------------------------ //
@@ -418,13 +500,7 @@ TaskSystem::JobHandle TaskSystem::CreateJob(
     Job* job;
 
 #ifdef USE_OBJECT_POOLS
-    {
-        std::lock_guard<std::mutex> lock(jobPoolMutex);
-        job = jobPool.malloc();
-    }
-
-    ::new (job) Job(inName, inColor, this, inJobFunction, inNumDependencies);
-
+    job = jobPool.Create(inName, inColor, this, inJobFunction, inNumDependencies);
 #else
     job = new Job(inName, inColor, this, inJobFunction, inNumDependencies);
 #endif
@@ -440,9 +516,7 @@ TaskSystem::JobHandle TaskSystem::CreateJob(
 void TaskSystem::FreeJob(Job* inJob)
 {
 #ifdef USE_OBJECT_POOLS
-    std::lock_guard<std::mutex> lock(jobPoolMutex);
-
-    jobPool.destroy(inJob);
+    jobPool.Destroy(inJob);
 #else
     delete inJob;
 #endif
@@ -450,46 +524,177 @@ void TaskSystem::FreeJob(Job* inJob)
 
 void TaskSystem::QueueJob(Job* inJob)
 {
-#ifdef USE_LOCK_FREE_QUEUE
-    TryEnqueueTask(QueuedTask(inJob));
-#else
-    std::lock_guard<std::mutex> lock(queueMutex);
-    taskQueue.emplace(inJob);
-#endif
+    // Jobs created by jobs running on the worker threads stay on the same thread unless someone steals them
+    if (TryQueueLocalJob(inJob))
+    {
+        workAvailable.NotifyOne();
+        return;
+    }
+
+    PushGlobalTask(QueuedTask(inJob));
 
-    queueNotify.notify_one();
+    workAvailable.NotifyOne();
 }
 
 void TaskSystem::QueueJobs(Job** inJobs, uint32_t inNumJobs)
 {
-#ifdef USE_LOCK_FREE_QUEUE
+    uint32_t queuedLocally = 0;
+
+    while (queuedLocally < inNumJobs && TryQueueLocalJob(inJobs[queuedLocally]))
+    {
+        ++queuedLocally;
+    }
+
     // TODO: should try_enqueue_bulk be used instead (at least when num jobs is over 2)?
-    for (size_t i = 0; i < inNumJobs; ++i)
+    for (size_t i = queuedLocally; i < inNumJobs; ++i)
     {
-        TryEnqueueTask(QueuedTask(inJobs[i]));
+        PushGlobalTask(QueuedTask(inJobs[i]));
     }
-#else
-    std::lock_guard<std::mutex> lock(queueMutex);
 
-    for (size_t i = 0; i < inNumJobs; ++i)
+    workAvailable.Notify(inNumJobs);
+}
+
+bool TaskSystem::TryQueueLocalJob(Job* job)
+{
+    if (LocalQueueSlot < 0)
+        return false;
+
+    // The queue holds a reference to the job like QueuedTask does
+    job->AddRef();
+
+    if (localQueues[LocalQueueSlot]->Push(job)) [[likely]]
+        return true;
+
+    job->Release();
+    return false;
+}
+
+bool TaskSystem::TryPopLocalJob(Job*& job)
+{
+    if (LocalQueueSlot < 0)
+        return false;
+
+    return localQueues[LocalQueueSlot]->Pop(job);
+}
+
+bool TaskSystem::TryStealJob(Job*& job)
+{
+    const int count = localQueueCount.load(std::memory_order_acquire);
+
+    if (count < 1)
+        return false;
+
+    auto random = StealRandomState;
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    StealRandomState = random;
+
+    const int start = static_cast<int>(random % static_cast<uint32_t>(count));
+
+    for (int i = 0; i < count; ++i)
+    {
+        const int victim = (start + i) % count;
+
+        if (victim == LocalQueueSlot)
+            continue;
+
+        auto& victimQueue = *localQueues[victim];
+
+        if (victimQueue.LooksEmpty())
+            continue;
+
+        if (victimQueue.Steal(job))
+            return true;
+    }
+
+    return false;
+}
+
+bool TaskSystem::TryDequeueGlobalTask(QueuedTask& task)
+{
+#ifdef TASK_QUEUE_USES_POINTERS
+    QueuedTask* node;
+
+#ifdef USE_LOCK_FREE_QUEUE
+    if (!taskQueue.try_dequeue(node))
+        return false;
+#else
     {
-        taskQueue.emplace(inJobs[i]);
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        if (taskQueue.empty())
+            return false;
+
+        node = taskQueue.front();
+        taskQueue.pop();
     }
 #endif
 
-    if (inNumJobs > 4)
+    task = std::move(*node);
+    FreeTaskNode(node);
+    return true;
+
+#else
+
+#ifdef USE_LOCK_FREE_QUEUE
+    return taskQueue.try_dequeue(task);
+#else
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    if (taskQueue.empty())
+        return false;
+
+    task = std::move(taskQueue.front());
+    taskQueue.pop();
+    return true;
+#endif
+
+#endif
+}
+
+void TaskSystem::ReleaseLocalQueue()
+{
+    if (LocalQueueSlot < 0)
+        return;
+
+    auto& localQueue = *localQueues[LocalQueueSlot];
+
+    bool movedJobs = false;
+
+    Job* job;
+    while (localQueue.Pop(job))
     {
-        queueNotify.notify_all();
+        PushGlobalTask(QueuedTask(job));
+
+        // Release the reference held by the local queue as the global queue task took its own
+        job->Release();
+        movedJobs = true;
     }
-    else if (inNumJobs > 3)
+
+    localQueueInUse[LocalQueueSlot].store(false, std::memory_order_release);
+    LocalQueueSlot = -1;
+
+    if (movedJobs)
+        workAvailable.NotifyAll();
+}
+
+void TaskSystem::RunJob(Job* job)
+{
+    try
     {
-        queueNotify.notify_one();
-        queueNotify.notify_one();
+        TRACE_SCOPE(GetJobTraceName(job));
+
+        job->Execute();
     }
-    else
+    catch (const std::exception& e)
     {
-        queueNotify.notify_one();
+        LOG_ERROR(std::string("Background job exception: ") + e.what());
+        job->Release();
+        throw;
     }
+
+    job->Release();
 }
 
 // ------------------------------------ //
@@ -509,8 +714,6 @@ void TaskSystem::SetThreads(int count) noexcept
         return;
     }
 
-    queueLock.lock();
-
     targetThreadCount = count;
 
     // Start new threads
@@ -525,8 +728,6 @@ void TaskSystem::SetThreads(int count) noexcept
         EndTaskThread();
     }
 
-    queueLock.unlock();
-
     // TODO: where should this thread cleaning exist? (here it is not possible to know really which threads have exited)
     /*for (auto iter = taskThreads.begin(); iter != taskThreads.end(); )
     {
@@ -538,7 +739,32 @@ void TaskSystem::StartTaskThread()
 {
     const auto threadId = ThreadIdentifierNumber.fetch_add(1);
 
-    auto thread = std::thread(&TaskSystem::RunTaskThread, this, threadId);
+    // Find a free local queue for the thread, queues of threads that have quit are reused
+    int localQueueSlot = -1;
+    const int existingQueues = localQueueCount.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < existingQueues; ++i)
+    {
+        if (!localQueueInUse[i].load(std::memory_order_acquire))
+        {
+            localQueueSlot = i;
+            break;
+        }
+    }
+
+    if (localQueueSlot < 0 && existingQueues < MAX_LOCAL_QUEUES)
+    {
+        localQueueSlot = existingQueues;
+        localQueues[localQueueSlot] = std::make_unique<LocalJobQueue>();
+
+        // Published only after the queue is allocated so that stealing threads never see a null queue
+        localQueueCount.store(existingQueues + 1, std::memory_order_release);
+    }
+
+    if (localQueueSlot >= 0)
+        localQueueInUse[localQueueSlot].store(true, std::memory_order_relaxed);
+
+    auto thread = std::thread(&TaskSystem::RunTaskThread, this, threadId, localQueueSlot);
 
     SetThreadName(threadId, thread);
 
@@ -549,108 +775,99 @@ void TaskSystem::StartTaskThread()
 
 void TaskSystem::EndTaskThread()
 {
-#ifdef USE_LOCK_FREE_QUEUE
-    TryEnqueueTask(QueuedTask(QuitSentinel()));
-#else
-    queueLock.lock();
+    PushGlobalTask(QueuedTask(QuitSentinel()));
 
-    taskQueue.emplace(QuitSentinel());
-
-    queueLock.unlock();
-#endif
-
-    queueNotify.notify_one();
+    workAvailable.NotifyOne();
 
     --threadCount;
 }
 
 // ------------------------------------ //
-void TaskSystem::RunTaskThread(int id)
+bool TaskSystem::TryGetWork(Job*& job, QueuedTask& task)
 {
-    const auto threadWait = MillisecondDuration(8);
+    // Own jobs are preferred as they are likely still in the cache, then the global queue and then jobs from other
+    // threads
+    if (TryPopLocalJob(job))
+        return true;
 
-    std::unique_lock<std::mutex> lock{queueMutex};
+    if (TryDequeueGlobalTask(task))
+        return true;
 
-    SetThreadNameCurrent(id);
-
-#ifdef USE_LOCK_FREE_QUEUE
-    lock.unlock();
-#endif
+    return TryStealJob(job);
+}
 
-    while (runThreads)
+bool TaskSystem::WaitForWork(Job*& job, QueuedTask& task)
+{
+    // While latency critical work is running new jobs are very likely to appear soon so spinning a bit is preferred
+    // over sleeping and then paying the cost of waking up again
+    if (latencyCriticalWork.load(std::memory_order_relaxed) > 0)
     {
-        bool processed = false;
+        for (int i = 0; i < TASK_WAIT_LOOP_COUNT; ++i)
+        {
+            if (TryGetWork(job, task))
+                return true;
 
-#ifdef USE_LOCK_FREE_QUEUE
-        lock.lock();
-#endif
+            HYPER_THREAD_YIELD;
+        }
+    }
 
-        queueNotify.wait_for(lock, threadWait);
+    const auto key = workAvailable.PrepareWait();
 
-#ifdef USE_LOCK_FREE_QUEUE
-        lock.unlock();
-#endif
+    // Need to check again after registering as a waiter as work could have been added just before
+    if (TryGetWork(job, task))
+    {
+        workAvailable.CancelWait();
+        return true;
+    }
 
-        for (int i = 0; i < TASK_WAIT_LOOP_COUNT; ++i)
-        {
-            // Process tasks until empty before waiting again
-#ifdef USE_LOCK_FREE_QUEUE
-            // TODO: should this variable be in the outer scope?
-            QueuedTask task;
-            while (taskQueue.try_dequeue(task))
-#else
-            while (!taskQueue.empty())
-#endif
-            {
-                {
-#ifndef USE_LOCK_FREE_QUEUE
-                    const auto task = std::move(taskQueue.front());
+    workAvailable.Wait(key);
+    return false;
+}
 
-                    taskQueue.pop();
+void TaskSystem::RunTaskThread(int id, int localQueueSlot)
+{
+    SetThreadNameCurrent(id);
+    TRACE_THREAD_NAME(GenerateThreadName(id));
 
-                    // Unlock while running the task
-                    lock.unlock();
-#endif
+    LocalQueueSlot = localQueueSlot;
+    StealRandomState = static_cast<uint32_t>(id) * 2654435761U + 1;
 
-                    if (task.Type == TaskType::Quit)
-                    {
-                        return;
-                    }
-
-                    processed = true;
-
-                    try
-                    {
-                        task.Invoke();
-                    }
-                    catch (const std::exception& e)
-                    {
-                        LOG_ERROR(std::string("Background task exception: ") + e.what());
-                        throw;
-                    }
-                }
+    QueuedTask task;
 
-#ifndef USE_LOCK_FREE_QUEUE
-                // Extra scope used above to not lock this again until needed (task is destructed)
-                lock.lock();
-#endif
-            }
+    while (runThreads)
+    {
+        Job* job = nullptr;
 
-#ifdef USE_LOCK_FREE_QUEUE
-            /*if (!processed)
-            {
-                // Reduce looping speed while the queue is empty
-                HYPER_THREAD_YIELD;
-            }*/
-#endif
+        if (!TryGetWork(job, task) && !WaitForWork(job, task))
+            continue;
 
-            // If we woke up but didn't find any work, go back to sleep
-            if (!processed)
-            {
-                break;
-            }
+        if (job != nullptr)
+        {
+            RunJob(job);
+            continue;
         }
+
+        if (task.Type == TaskType::Quit)
+        {
+            ReleaseLocalQueue();
+            return;
+        }
+
+        try
+        {
+            task.Invoke();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR(std::string("Background task exception: ") + e.what());
+            throw;
+        }
+
+        // Release the task data now rather than when the next task is received
+        task = QueuedTask();
     }
+
+    ReleaseLocalQueue();
 }
 
 } // namespace Thrive
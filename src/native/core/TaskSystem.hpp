@@ -1,19 +1,23 @@
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
-#include <functional>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <vector>
 
-#include "boost/pool/object_pool.hpp"
 #include "Jolt/Core/JobSystemWithBarrier.h"
 
 #include "Include.h"
 
 #include "concurrentqueue.h"
 
+#include "EventCount.hpp"
+#include "InlineCallable.hpp"
+#include "ThreadCachingPool.hpp"
+#include "WorkStealingDeque.hpp"
+
 namespace Thrive
 {
 /// \brief Handles multithreaded execution of native module code
@@ -25,13 +29,19 @@ public:
 
     using SimpleCallable = void (*)();
 
+    /// \brief Max size of the captured data of task lambdas, this is sized so that QueuedTask fits in a cache line
+    static constexpr std::size_t TASK_CALLABLE_SIZE = 48;
+
+    /// \brief Callable with captures that can be queued as a task without allocating memory
+    using TaskCallable = InlineCallable<TASK_CALLABLE_SIZE>;
+
 private:
     enum class TaskType : uint8_t
     {
         Cleared = 0,
         Quit,
         Simple,
-        StdFunction,
+        Callable,
         JoltJob,
     };
 
@@ -43,16 +53,12 @@ private:
     {
     public:
     public:
-#ifdef USE_LOCK_FREE_QUEUE
         /// \brief Creates an empty task, for use to dequeue items
         explicit QueuedTask();
-#endif
 
         explicit QueuedTask(SimpleCallable callable);
 
-        explicit QueuedTask(std::function<void()> callable);
-
-        // explicit QueuedTask(std::function<void()>&& callable);
+        explicit QueuedTask(TaskCallable&& callable);
 
         explicit QueuedTask(Job* callable);
 
@@ -81,7 +87,7 @@ private:
         {
             SimpleCallable Simple;
 
-            std::function<void()> Function;
+            TaskCallable Function;
 
             Job* Jolt;
         };
@@ -93,6 +99,24 @@ private:
         void MoveDataFromOther(QueuedTask&& other);
     };
 
+    /// \brief Max number of worker threads that get their own local job queue. Threads over this limit only use the
+    /// global queue and stealing.
+    static constexpr int MAX_LOCAL_QUEUES = 64;
+
+    /// \brief Size of the per-thread Jolt job queues. If a thread has more jobs than this, they go to the global queue.
+    static constexpr int64_t LOCAL_QUEUE_CAPACITY = 1024;
+
+    using LocalJobQueue = WorkStealingDeque<Job*, LOCAL_QUEUE_CAPACITY>;
+
+#ifdef TASK_QUEUE_USES_POINTERS
+    /// \brief How many task nodes are allocated at once when the pool runs out
+    static constexpr int TASK_NODE_BLOCK_SIZE = 256;
+
+    using GlobalQueueEntry = QueuedTask*;
+#else
+    using GlobalQueueEntry = QueuedTask;
+#endif
+
 private:
     TaskSystem();
     ~TaskSystem() override;
@@ -116,7 +140,7 @@ public:
 
     void QueueTask(QueuedTask&& task);
 
-    void QueueTask(std::function<void()> callable)
+    void QueueTask(TaskCallable callable)
     {
         QueueTask(QueuedTask(std::move(callable)));
     }
@@ -129,7 +153,7 @@ public:
 
     void QueueTaskFromBackgroundThread(QueuedTask&& task);
 
-    void QueueTaskFromBackgroundThread(std::function<void()>&& callable)
+    void QueueTaskFromBackgroundThread(TaskCallable&& callable)
     {
         QueueTaskFromBackgroundThread(QueuedTask(std::move(callable)));
     }
@@ -157,6 +181,29 @@ public:
     /// \brief Shuts down all threads and doesn't allow starting more
     void Shutdown();
 
+    /// \brief Usage statistics of the Jolt job pool, all zero if object pools are not in use
+    [[nodiscard]] PoolStatistics GetJobPoolStatistics() const noexcept
+    {
+#ifdef USE_OBJECT_POOLS
+        return jobPool.GetStatistics();
+#else
+        return {};
+#endif
+    }
+
+    /// \brief Marks latency sensitive work (like a physics step) as running. While there is such work idle worker
+    /// threads spin for a short while before sleeping to be able to pick up new jobs with less delay.
+    /// Must be paired with EndLatencyCriticalWork.
+    void BeginLatencyCriticalWork() noexcept
+    {
+        latencyCriticalWork.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void EndLatencyCriticalWork() noexcept
+    {
+        latencyCriticalWork.fetch_sub(1, std::memory_order_relaxed);
+    }
+
 protected:
     virtual void FreeJob(Job* inJob) override;
 
@@ -166,42 +213,92 @@ protected:
 
 private:
 #ifdef USE_LOCK_FREE_QUEUE
-    FORCE_INLINE void TryEnqueueTask(QueuedTask&& task);
+    FORCE_INLINE void TryEnqueueTask(GlobalQueueEntry&& entry);
+#endif
+
+    /// \brief Adds a task to the global queue, callable from any thread
+    void PushGlobalTask(QueuedTask&& task);
+
+#ifdef TASK_QUEUE_USES_POINTERS
+    /// \brief Takes a task node from the pool and moves the task data into it
+    QueuedTask* AllocateTaskNode(QueuedTask&& task);
+    void FreeTaskNode(QueuedTask* node);
+
+    /// \brief Allocates a new block of task nodes and adds them to the free nodes
+    /// \returns One node from the new block for the caller to use
+    QueuedTask* AllocateTaskNodeBlock();
 #endif
 
+    /// \brief Puts a job in the calling worker thread's local queue
+    /// \returns False if this is not a worker thread or the local queue is full
+    bool TryQueueLocalJob(Job* job);
+
+    bool TryPopLocalJob(Job*& job);
+
+    /// \brief Tries to steal a job from the local queue of another thread starting from a random one
+    bool TryStealJob(Job*& job);
+
+    bool TryDequeueGlobalTask(QueuedTask& task);
+
+    /// \brief Moves all jobs in the current thread's local queue to the global queue and gives up the queue slot.
+    /// Called when a thread quits.
+    void ReleaseLocalQueue();
+
+    /// \brief Takes the next job or task to run from any of the queues
+    /// \returns True if something was found, job is set when it was a job, otherwise task contains the found task
+    bool TryGetWork(Job*& job, QueuedTask& task);
+
+    /// \brief Waits until new work is available, may return the work directly if found while preparing to wait
+    bool WaitForWork(Job*& job, QueuedTask& task);
+
+    static void RunJob(Job* job);
+
     void StartTaskThread();
     void EndTaskThread();
 
-    void RunTaskThread(int id);
+    void RunTaskThread(int id, int localQueueSlot);
 
 private:
 #ifdef USE_OBJECT_POOLS
-    boost::object_pool<Job> jobPool;
+    ThreadCachingPool<Job> jobPool;
 #endif
 
     std::vector<std::thread> taskThreads;
 
-    // || !defined(TASK_QUEUE_USES_POINTERS)
-#if defined(USE_LOCK_FREE_QUEUE)
-    moodycamel::ConcurrentQueue<QueuedTask> taskQueue;
+#ifdef TASK_QUEUE_USES_POINTERS
+    /// \brief Storage of all task nodes, these are only freed when the task system is destroyed
+    std::vector<std::unique_ptr<QueuedTask[]>> taskNodeBlocks;
 
-    // #ifdef TASK_QUEUE_USES_POINTERS
+    std::mutex taskNodeBlockMutex;
 
-#else
-    std::queue<QueuedTask> taskQueue;
+    moodycamel::ConcurrentQueue<QueuedTask*> freeTaskNodes;
 #endif
 
-#ifdef USE_OBJECT_POOLS
-    std::mutex jobPoolMutex;
+#if defined(USE_LOCK_FREE_QUEUE)
+    moodycamel::ConcurrentQueue<GlobalQueueEntry> taskQueue;
+#else
+    std::queue<GlobalQueueEntry> taskQueue;
 #endif
 
+    /// \brief Local work stealing queues for Jolt jobs created on worker threads. These are only allocated and never
+    /// freed while the task system exists so that stealing threads can safely look at any of them.
+    std::array<std::unique_ptr<LocalJobQueue>, MAX_LOCAL_QUEUES> localQueues;
+
+    /// \brief Set when a running thread owns the local queue in the same slot
+    std::array<std::atomic<bool>, MAX_LOCAL_QUEUES> localQueueInUse{};
+
+    /// \brief Number of slots in localQueues that have been allocated
+    std::atomic<int> localQueueCount{0};
+
     /// When USE_LOCK_FREE_QUEUE is defined this should not be locked to write to the queue
     std::mutex queueMutex;
 
-    std::condition_variable queueNotify;
+    /// \brief Idle worker threads sleep on this until new work is queued
+    EventCount workAvailable;
 
-    /// Lock used on the main thread to enqueue tasks
-    std::unique_lock<std::mutex> queueLock;
+    /// \brief Count of currently running latency critical operations, while non-zero idle workers spin for a bit
+    /// before sleeping
+    std::atomic<int> latencyCriticalWork{0};
 
     int targetThreadCount = 0;
 
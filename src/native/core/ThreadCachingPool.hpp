@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "concurrentqueue.h"
+
+#include "NonCopyable.hpp"
+
+namespace Thrive
+{
+
+struct PoolStatistics
+{
+    int Capacity = 0;
+
+    /// \brief Slots that are not in the shared depot. Includes slots cached in thread magazines so this is an upper
+    /// bound of the number of live objects.
+    int SlotsInUse = 0;
+
+    int SlotsInUseHighWaterMark = 0;
+
+    /// \brief Number of times the pool was exhausted and an object was allocated from the heap instead
+    int OverflowAllocations = 0;
+};
+
+/// \brief Fixed capacity object pool where each thread caches a small magazine of free slots
+///
+/// Threads allocate from and free to their own magazine without any synchronization. Only when a magazine runs out
+/// (or gets too full) a batch of slots is moved from (or to) the shared lock-free depot. If the whole pool is in use
+/// allocations fall back to the heap. The per-thread magazine is shared by all pools of the same type, so it moves
+/// over to whichever pool the thread used last. Objects must not be freed after the pool is destroyed, and threads
+/// that used the pool must end (or use a different pool of the same type) before the pool is destroyed.
+template<typename T, int MagazineSize = 16>
+class ThreadCachingPool final : NonCopyable
+{
+    struct Magazine
+    {
+        ~Magazine()
+        {
+            if (Owner != nullptr)
+                Owner->ReturnToDepot(*this, Count);
+        }
+
+        ThreadCachingPool* Owner = nullptr;
+
+        int Count = 0;
+
+        /// \brief Has room for two batches to not move slots back and forth when right at the batch boundary
+        void* Items[MagazineSize * 2];
+    };
+
+public:
+    explicit ThreadCachingPool(int capacity) : depot(static_cast<size_t>(capacity)), capacity(capacity)
+    {
+        slab = static_cast<std::byte*>(::operator new(sizeof(T) * capacity, std::align_val_t(alignof(T))));
+        slabEnd = slab + sizeof(T) * capacity;
+
+        for (int i = 0; i < capacity; ++i)
+        {
+            depot.enqueue(slab + sizeof(T) * i);
+        }
+    }
+
+    ~ThreadCachingPool()
+    {
+        auto& magazine = threadMagazine;
+
+        if (magazine.Owner == this)
+        {
+            magazine.Owner = nullptr;
+            magazine.Count = 0;
+        }
+
+        ::operator delete(slab, std::align_val_t(alignof(T)));
+    }
+
+    template<typename... Args>
+    T* Create(Args&&... args)
+    {
+        void* memory = Allocate();
+        return ::new (memory) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object)
+    {
+        object->~T();
+        Free(object);
+    }
+
+    [[nodiscard]] PoolStatistics GetStatistics() const noexcept
+    {
+        return PoolStatistics{capacity, slotsInUse.load(std::memory_order_relaxed),
+            slotsInUseHighWaterMark.load(std::memory_order_relaxed),
+            overflowAllocations.load(std::memory_order_relaxed)};
+    }
+
+private:
+    void* Allocate()
+    {
+        auto& magazine = AcquireMagazine();
+
+        if (magazine.Count < 1) [[unlikely]]
+        {
+            const auto received = static_cast<int>(depot.try_dequeue_bulk(magazine.Items, MagazineSize));
+
+            if (received < 1)
+            {
+                overflowAllocations.fetch_add(1, std::memory_order_relaxed);
+                return ::operator new(sizeof(T), std::align_val_t(alignof(T)));
+            }
+
+            magazine.Count = received;
+            UpdateSlotsInUse(received);
+        }
+
+        return magazine.Items[--magazine.Count];
+    }
+
+    void Free(void* memory)
+    {
+        if (memory < slab || memory >= slabEnd) [[unlikely]]
+        {
+            // Overflow allocation
+            ::operator delete(memory, std::align_val_t(alignof(T)));
+            return;
+        }
+
+        auto& magazine = AcquireMagazine();
+
+        if (magazine.Count >= MagazineSize * 2) [[unlikely]]
+        {
+            // Give the older half back to let other threads use them
+            ReturnToDepot(magazine, MagazineSize);
+        }
+
+        magazine.Items[magazine.Count++] = memory;
+    }
+
+    Magazine& AcquireMagazine()
+    {
+        auto& magazine = threadMagazine;
+
+        if (magazine.Owner != this) [[unlikely]]
+        {
+            if (magazine.Owner != nullptr)
+                magazine.Owner->ReturnToDepot(magazine, magazine.Count);
+
+            magazine.Owner = this;
+        }
+
+        return magazine;
+    }
+
+    /// \brief Moves the first count slots of a magazine to the depot
+    void ReturnToDepot(Magazine& magazine, int count)
+    {
+        if (count < 1)
+            return;
+
+        depot.enqueue_bulk(magazine.Items, count);
+
+        for (int i = count; i < magazine.Count; ++i)
+        {
+            magazine.Items[i - count] = magazine.Items[i];
+        }
+
+        magazine.Count -= count;
+        UpdateSlotsInUse(-count);
+    }
+
+    void UpdateSlotsInUse(int change) noexcept
+    {
+        const auto newValue = slotsInUse.fetch_add(change, std::memory_order_relaxed) + change;
+
+        auto highWater = slotsInUseHighWaterMark.load(std::memory_order_relaxed);
+        while (newValue > highWater &&
+            !slotsInUseHighWaterMark.compare_exchange_weak(highWater, newValue, std::memory_order_relaxed))
+        {
+        }
+    }
+
+private:
+    static inline thread_local Magazine threadMagazine;
+
+    moodycamel::ConcurrentQueue<void*> depot;
+
+    std::byte* slab = nullptr;
+    std::byte* slabEnd = nullptr;
+
+    const int capacity;
+
+    // Statistics, these are only updated when moving slots to or from the depot to keep the normal operations fast
+    std::atomic<int> slotsInUse{0};
+    std::atomic<int> slotsInUseHighWaterMark{0};
+    std::atomic<int> overflowAllocations{0};
+};
+
+} // namespace Thrive
@@ -0,0 +1,280 @@
+// ------------------------------------ //
+#include "Tracing.hpp"
+
+#include <string>
+
+#ifdef THRIVE_NATIVE_TRACING
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "Mutex.hpp"
+#endif
+
+#include "Logger.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Tracing
+{
+
+#ifdef THRIVE_NATIVE_TRACING
+
+std::atomic<bool> Recording{false};
+
+namespace
+{
+
+struct TraceEvent
+{
+    const char* Name;
+    int64_t Start;
+    int64_t End;
+};
+
+/// \brief Events recorded by a single thread. Only the owning thread writes events, readers only look at the events
+/// below Count and only when Session matches the current session.
+struct ThreadBuffer
+{
+    std::unique_ptr<TraceEvent[]> Events;
+    int Capacity = 0;
+
+    std::atomic<int> Count{0};
+    std::atomic<int> Dropped{0};
+
+    /// \brief The session the events are from, the owning thread resets the buffer when it sees a newer session
+    std::atomic<uint32_t> Session{0};
+
+    int ThreadId = 0;
+
+    /// \brief Only accessed with the registry mutex locked
+    std::string Name;
+};
+
+/// \brief Protects the buffer list and session changes. Not used when recording events.
+Mutex registryMutex;
+
+std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+std::atomic<uint32_t> currentSession{0};
+std::atomic<int> sessionEventsPerThread{DEFAULT_EVENTS_PER_THREAD};
+int64_t sessionStart = 0;
+
+thread_local ThreadBuffer* currentThreadBuffer = nullptr;
+
+/// \brief Name given before the thread had a buffer
+thread_local std::string currentThreadName;
+
+ThreadBuffer* CreateThreadBuffer()
+{
+    Lock lock(registryMutex);
+
+    auto& buffer = threadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+    buffer->ThreadId = static_cast<int>(threadBuffers.size());
+
+    if (currentThreadName.empty())
+    {
+        buffer->Name = "Thread " + std::to_string(buffer->ThreadId);
+    }
+    else
+    {
+        buffer->Name = currentThreadName;
+    }
+
+    return buffer.get();
+}
+
+void ResetBuffer(ThreadBuffer& buffer, uint32_t session)
+{
+    const auto capacity = sessionEventsPerThread.load(std::memory_order_relaxed);
+
+    if (buffer.Capacity != capacity)
+    {
+        buffer.Events = std::make_unique<TraceEvent[]>(capacity);
+        buffer.Capacity = capacity;
+    }
+
+    buffer.Count.store(0, std::memory_order_relaxed);
+    buffer.Dropped.store(0, std::memory_order_relaxed);
+
+    // Released last so that readers that see the new session also see the reset count
+    buffer.Session.store(session, std::memory_order_release);
+}
+
+void WriteEscaped(std::ostream& stream, std::string_view text)
+{
+    for (const auto character : text)
+    {
+        if (character == '"' || character == '\\')
+        {
+            stream << '\\' << character;
+        }
+        else if (static_cast<unsigned char>(character) >= 0x20)
+        {
+            stream << character;
+        }
+    }
+}
+
+} // namespace
+
+// ------------------------------------ //
+void RecordEvent(const char* name, int64_t start, int64_t end)
+{
+    auto* buffer = currentThreadBuffer;
+
+    if (buffer == nullptr) [[unlikely]]
+    {
+        buffer = CreateThreadBuffer();
+        currentThreadBuffer = buffer;
+    }
+
+    const auto session = currentSession.load(std::memory_order_acquire);
+
+    if (buffer->Session.load(std::memory_order_relaxed) != session) [[unlikely]]
+        ResetBuffer(*buffer, session);
+
+    const auto index = buffer->Count.load(std::memory_order_relaxed);
+
+    if (index >= buffer->Capacity) [[unlikely]]
+    {
+        buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->Events[index] = TraceEvent{name, start, end};
+    buffer->Count.store(index + 1, std::memory_order_release);
+}
+
+void SetCurrentThreadName(std::string_view name)
+{
+    currentThreadName = name;
+
+    if (currentThreadBuffer != nullptr)
+    {
+        Lock lock(registryMutex);
+        currentThreadBuffer->Name = currentThreadName;
+    }
+}
+
+bool Start(int eventsPerThread)
+{
+    if (eventsPerThread < 1)
+    {
+        LOG_ERROR("Invalid trace event count per thread");
+        return false;
+    }
+
+    Lock lock(registryMutex);
+
+    sessionEventsPerThread.store(eventsPerThread, std::memory_order_relaxed);
+    sessionStart = Now();
+
+    // Threads reset their buffers when they notice the session change
+    currentSession.fetch_add(1, std::memory_order_release);
+    Recording.store(true, std::memory_order_release);
+
+    LOG_INFO("Native tracing started");
+    return true;
+}
+
+void Stop()
+{
+    Recording.store(false, std::memory_order_release);
+}
+
+bool WriteChromeTrace(std::string_view path)
+{
+    Lock lock(registryMutex);
+
+    std::ofstream file{std::string(path)};
+
+    if (!file.good())
+    {
+        LOG_ERROR("Cannot open trace file for writing: " + std::string(path));
+        return false;
+    }
+
+    const auto session = currentSession.load(std::memory_order_acquire);
+
+    file.precision(3);
+    file << std::fixed;
+    file << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    int dropped = 0;
+
+    for (const auto& buffer : threadBuffers)
+    {
+        file << (first ? "" : ",\n");
+        first = false;
+
+        file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->ThreadId << R"(,"args":{"name":")";
+        WriteEscaped(file, buffer->Name);
+        file << "\"}}";
+
+        // Buffers that haven't recorded anything in this session still have old data
+        if (buffer->Session.load(std::memory_order_acquire) != session)
+            continue;
+
+        const auto count = buffer->Count.load(std::memory_order_acquire);
+        dropped += buffer->Dropped.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& event = buffer->Events[i];
+
+            // Scopes that started before this session
+            if (event.Start < sessionStart)
+                continue;
+
+            file << ",\n{\"name\":\"";
+            WriteEscaped(file, event.Name);
+            file << R"(","ph":"X","pid":1,"tid":)" << buffer->ThreadId
+                 << ",\"ts\":" << static_cast<double>(event.Start - sessionStart) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(event.End - event.Start) / 1000.0 << "}";
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file.good())
+    {
+        LOG_ERROR("Failed to write trace file: " + std::string(path));
+        return false;
+    }
+
+    if (dropped > 0)
+    {
+        LOG_WARNING("Trace buffers ran out of space, " + std::to_string(dropped) +
+            " events were dropped. Use a bigger per thread event count.");
+    }
+
+    return true;
+}
+
+#else
+
+// ------------------------------------ //
+bool Start(int eventsPerThread)
+{
+    UNUSED(eventsPerThread);
+
+    LOG_WARNING("Native tracing is not available as the library was compiled without THRIVE_NATIVE_TRACING");
+    return false;
+}
+
+void Stop()
+{
+}
+
+bool WriteChromeTrace(std::string_view path)
+{
+    UNUSED(path);
+
+    LOG_ERROR("Cannot write a trace file as the library was compiled without THRIVE_NATIVE_TRACING");
+    return false;
+}
+
+#endif // THRIVE_NATIVE_TRACING
+
+} // namespace Thrive::Tracing
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string_view>
+
+#include "Include.h"
+
+// Tracing of the native threads' work for viewing in Chrome's trace viewer or Perfetto. When the library is built
+// without THRIVE_NATIVE_TRACING the macros compile to nothing and starting tracing just fails.
+
+#ifdef THRIVE_NATIVE_TRACING
+
+#include <atomic>
+#include <cstdint>
+
+#include "Time.hpp"
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+
+/// \brief Records the time from this point to the end of the current scope as an event. The name must be a string
+/// that lives for the duration of the program (for example a string literal).
+#define TRACE_SCOPE(name) const Thrive::Tracing::TraceScope TRACE_SCOPE_CONCAT(traceScope, __LINE__)(name)
+
+/// \brief Sets the name the current thread is shown with in the written traces
+#define TRACE_THREAD_NAME(name) Thrive::Tracing::SetCurrentThreadName(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_THREAD_NAME(name)
+
+#endif // THRIVE_NATIVE_TRACING
+
+namespace Thrive::Tracing
+{
+
+/// \brief Default for how many events each thread can hold before new events are dropped
+constexpr int DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+/// \brief Starts a new trace session. Clears any previously recorded events.
+/// \returns False if tracing support is not compiled in
+bool Start(int eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+/// \brief Stops recording new events, the recorded events are kept until the next Start
+void Stop();
+
+/// \brief Writes the recorded events of the current (or last) session in the Chrome JSON trace format
+/// \returns False on failure
+bool WriteChromeTrace(std::string_view path);
+
+#ifdef THRIVE_NATIVE_TRACING
+
+void SetCurrentThreadName(std::string_view name);
+
+/// \brief Whether recording is enabled, checked before doing anything else when recording events
+extern std::atomic<bool> Recording;
+
+/// \brief Adds a single complete event to the current thread's buffer
+void RecordEvent(const char* name, int64_t start, int64_t end);
+
+/// \brief Current time in nanoseconds in the timebase the trace events use
+[[nodiscard]] inline int64_t Now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count();
+}
+
+/// \brief Records an event covering the lifetime of this object
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name) noexcept :
+        name(name), start(Recording.load(std::memory_order_relaxed) ? Now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (start != 0) [[unlikely]]
+            RecordEvent(name, start, Now());
+    }
+
+    TraceScope(const TraceScope& other) = delete;
+    TraceScope& operator=(const TraceScope& other) = delete;
+
+private:
+    const char* const name;
+    const int64_t start;
+};
+
+#endif // THRIVE_NATIVE_TRACING
+
+} // namespace Thrive::Tracing
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "NonCopyable.hpp"
+
+namespace Thrive
+{
+
+/// \brief Fixed capacity Chase-Lev work stealing deque
+///
+/// The owning thread pushes and pops items at the bottom (LIFO order to keep recently created work in the cache)
+/// and other threads steal from the top. Based on the C11 version in "Correct and Efficient Work-Stealing for Weak
+/// Memory Models" by Lê et al. The buffer is not grown, instead Push fails when full and the caller needs to put the
+/// item somewhere else.
+template<typename T, int64_t Capacity>
+class WorkStealingDeque final : NonCopyable
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Items are accessed atomically so they must be simple");
+
+public:
+    WorkStealingDeque() = default;
+
+    /// \brief Adds an item to the bottom. May only be called by the owning thread.
+    /// \returns False if the deque is full
+    bool Push(T item) noexcept
+    {
+        const auto currentBottom = bottom.load(std::memory_order_relaxed);
+        const auto currentTop = top.load(std::memory_order_acquire);
+
+        if (currentBottom - currentTop >= Capacity) [[unlikely]]
+            return false;
+
+        buffer[currentBottom & Mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(currentBottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// \brief Takes the most recently pushed item. May only be called by the owning thread.
+    bool Pop(T& item) noexcept
+    {
+        const auto newBottom = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(newBottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto currentTop = top.load(std::memory_order_relaxed);
+
+        if (currentTop > newBottom)
+        {
+            // Was empty
+            bottom.store(newBottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = buffer[newBottom & Mask].load(std::memory_order_relaxed);
+
+        if (currentTop != newBottom)
+            return true;
+
+        // Last item, need to race against the thieves for it
+        const bool won = top.compare_exchange_strong(
+            currentTop, currentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+
+        bottom.store(newBottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    /// \brief Takes the oldest item. Can be called from any thread.
+    /// \returns False if empty or another thread took the item at the same time
+    bool Steal(T& item) noexcept
+    {
+        auto currentTop = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto currentBottom = bottom.load(std::memory_order_acquire);
+
+        if (currentTop >= currentBottom)
+            return false;
+
+        item = buffer[currentTop & Mask].load(std::memory_order_relaxed);
+
+        return top.compare_exchange_strong(
+            currentTop, currentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /// \brief Approximate check for emptiness, can be used from any thread to skip stealing attempts
+    [[nodiscard]] bool LooksEmpty() const noexcept
+    {
+        return top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int64_t Mask = Capacity - 1;
+
+    // Top and bottom are on separate cache lines as the thieves and the owner mostly write different ones
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+
+    alignas(64) std::array<std::atomic<T>, Capacity> buffer{};
+};
+
+} // namespace Thrive
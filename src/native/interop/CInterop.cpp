@@ -1,6 +1,7 @@
 // ------------------------------------ //
 #include "CInterop.h"
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstring>
 
@@ -11,13 +12,19 @@
 
 #include "core/IntercommunicationManager.hpp"
 #include "core/TaskSystem.hpp"
+#include "core/Tracing.hpp"
 #include "physics/DebugDrawForwarder.hpp"
 #include "physics/PhysicalWorld.hpp"
 #include "physics/PhysicsBody.hpp"
+#include "physics/ShapeBuildTask.hpp"
+#include "physics/ShapeCache.hpp"
 #include "physics/ShapeCreator.hpp"
 #include "physics/ShapeWrapper.hpp"
 #include "physics/SimpleShapes.hpp"
 #include "physics/TrackedConstraint.hpp"
+#include "simulation/CompoundCloudSimulation.hpp"
+#include "simulation/FluidCurrents.hpp"
+#include "simulation/MembraneGenerator.hpp"
 
 #include "JoltTypeConversions.hpp"
 
@@ -77,6 +84,9 @@ void ShutdownThriveLibrary()
 {
     Thrive::TaskSystem::AssertIsMainThread();
 
+    // Cached shapes need to be released while Jolt is still usable and not only when the static cache is destroyed
+    Thrive::Physics::ShapeCache::Get().Clear();
+
     // Unregister physics
     JPH::UnregisterTypes();
 
@@ -293,6 +303,23 @@ void ReadPhysicsBodyVelocity(
     *angularVelocityReceiver = Thrive::Vec3ToCAPI(readAngular);
 }
 
+int32_t PhysicalWorldReadBodyStatesBatch(PhysicalWorld* physicalWorld, PhysicsBody** bodies, int32_t count,
+    JVec3* positionsReceiver, JQuat* rotationsReceiver, JVecF3* velocitiesReceiver, JVecF3* angularVelocitiesReceiver,
+    uint8_t* stateFlagsReceiver)
+{
+#ifndef NDEBUG
+    if (physicalWorld == nullptr || (bodies == nullptr && count > 0))
+    {
+        LOG_ERROR("Physics body batch read call with invalid parameters");
+        return 0;
+    }
+#endif
+
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->ReadBodyStatesBatch(reinterpret_cast<Thrive::Physics::PhysicsBody* const*>(bodies), count, positionsReceiver,
+            rotationsReceiver, velocitiesReceiver, angularVelocitiesReceiver, stateFlagsReceiver);
+}
+
 #pragma clang diagnostic pop
 
 void GiveImpulse(PhysicalWorld* physicalWorld, PhysicsBody* body, JVecF3 impulse, bool autoActivate)
@@ -377,6 +404,18 @@ void SetBodyAllowSleep(PhysicalWorld* physicalWorld, PhysicsBody* body, bool all
         ->SetBodyAllowSleep(reinterpret_cast<Thrive::Physics::PhysicsBody*>(body)->GetId(), allowSleep);
 }
 
+void SetBodyContinuousCollision(PhysicalWorld* physicalWorld, PhysicsBody* body, bool enabled)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->SetBodyContinuousCollision(reinterpret_cast<Thrive::Physics::PhysicsBody*>(body)->GetId(), enabled);
+}
+
+int32_t PhysicalWorldApplyBodyCommands(
+    PhysicalWorld* physicalWorld, const PhysicsBodyCommand* commands, int32_t count)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->ApplyBodyCommands(commands, count);
+}
+
 bool FixBodyYCoordinateToZero(PhysicalWorld* physicalWorld, PhysicsBody* body)
 {
     return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
@@ -432,7 +471,7 @@ void PhysicsBodySetCollisionIgnores(
 {
     reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
         ->SetCollisionIgnores(*reinterpret_cast<Thrive::Physics::PhysicsBody*>(body),
-            reinterpret_cast<Thrive::Physics::PhysicsBody*&>(ignoredBodies), count);
+            reinterpret_cast<Thrive::Physics::PhysicsBody* const*>(ignoredBodies), count);
 }
 
 void PhysicsBodyClearAndSetSingleIgnore(PhysicalWorld* physicalWorld, PhysicsBody* body, PhysicsBody* onlyIgnoredBody)
@@ -495,6 +534,53 @@ int32_t PhysicalWorldCastRayGetAll(
             reinterpret_cast<Thrive::Physics::PhysicsRayWithUserData*>(dataReceiver), maxHits);
 }
 
+int32_t PhysicalWorldCollideSphere(PhysicalWorld* physicalWorld, JVec3 center, float radius,
+    PhysicsRayWithUserData* dataReceiver, int32_t maxHits, const PhysicsBodyQueryFilter* filter)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->CollideSphere(Thrive::DVec3FromCAPI(center), radius,
+            reinterpret_cast<Thrive::Physics::PhysicsRayWithUserData*>(dataReceiver), maxHits, filter);
+}
+
+int32_t PhysicalWorldCollideAABox(PhysicalWorld* physicalWorld, JVec3 min, JVec3 max,
+    PhysicsRayWithUserData* dataReceiver, int32_t maxHits, const PhysicsBodyQueryFilter* filter)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->CollideAABox(Thrive::DVec3FromCAPI(min), Thrive::DVec3FromCAPI(max),
+            reinterpret_cast<Thrive::Physics::PhysicsRayWithUserData*>(dataReceiver), maxHits, filter);
+}
+
+int32_t PhysicalWorldFindNearestBodies(PhysicalWorld* physicalWorld, JVec3 position, float maxDistance,
+    PhysicsRayWithUserData* dataReceiver, int32_t maxCount, const PhysicsBodyQueryFilter* filter)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->FindNearestBodies(Thrive::DVec3FromCAPI(position), maxDistance,
+            reinterpret_cast<Thrive::Physics::PhysicsRayWithUserData*>(dataReceiver), maxCount, filter);
+}
+
+int32_t PhysicalWorldRunQueryBatch(PhysicalWorld* physicalWorld, PhysicsQuery* queries, int32_t queryCount,
+    PhysicsRayWithUserData* results, int32_t resultCapacity)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->RunQueryBatch(queries, queryCount, reinterpret_cast<Thrive::Physics::PhysicsRayWithUserData*>(results),
+            resultCapacity);
+}
+
+int32_t PhysicalWorldCastShape(PhysicalWorld* physicalWorld, PhysicsShape* shape, JVec3 start, JQuat rotation,
+    JVecF3 directionAndLength, PhysicsShapeCastHit* dataReceiver, int32_t maxHits, const PhysicsBodyQueryFilter* filter)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->CastShape(*reinterpret_cast<Thrive::Physics::ShapeWrapper*>(shape)->GetShape(), Thrive::DVec3FromCAPI(start),
+            Thrive::QuatFromCAPI(rotation), Thrive::Vec3FromCAPI(directionAndLength), dataReceiver, maxHits, filter);
+}
+
+int32_t PhysicalWorldCastShapeBatch(PhysicalWorld* physicalWorld, PhysicsQuery* queries, int32_t queryCount,
+    PhysicsShapeCastHit* results, int32_t resultCapacity)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->CastShapeBatch(queries, queryCount, results, resultCapacity);
+}
+
 // ------------------------------------ //
 float PhysicalWorldGetPhysicsLatestTime(PhysicalWorld* physicalWorld)
 {
@@ -506,11 +592,44 @@ float PhysicalWorldGetPhysicsAverageTime(PhysicalWorld* physicalWorld)
     return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->GetAveragePhysicsTime();
 }
 
+float PhysicalWorldGetPhysicsDroppedTime(PhysicalWorld* physicalWorld)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->GetDroppedPhysicsTime();
+}
+
+int32_t PhysicalWorldGetStepStatistics(PhysicalWorld* physicalWorld, PhysicsStepStatistics* receiver, int32_t maxCount)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->GetStepStatistics(receiver, maxCount);
+}
+
+void PhysicalWorldSetContactStatisticsEnabled(PhysicalWorld* physicalWorld, bool enabled)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->SetContactStatisticsEnabled(enabled);
+}
+
+void PhysicalWorldSetSteppingPolicy(
+    PhysicalWorld* physicalWorld, int32_t maxStepsPerProcess, bool mergeExcessSteps, int32_t maxMergedSteps)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->SetSteppingPolicy(maxStepsPerProcess, mergeExcessSteps, maxMergedSteps);
+}
+
 bool PhysicalWorldDumpPhysicsState(PhysicalWorld* physicalWorld, const char* path)
 {
     return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->DumpSystemState(path);
 }
 
+bool PhysicalWorldStartReplayRecording(PhysicalWorld* physicalWorld, const char* dumpPath, const char* recordingPath)
+{
+    return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->StartReplayRecording(dumpPath, recordingPath);
+}
+
+void PhysicalWorldStopReplayRecording(PhysicalWorld* physicalWorld)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->StopReplayRecording();
+}
+
 void PhysicalWorldSetDebugDrawLevel(PhysicalWorld* physicalWorld, int32_t level)
 {
     return reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->SetDebugLevel(level);
@@ -574,6 +693,32 @@ inline Thrive::Physics::ShapeWrapper* CreateShapeWrapper(ArgsT&&... args)
     return result;
 }
 
+/// \brief Gives the caller its own reference to a shape from the shape cache or a shape build task
+inline PhysicsShape* ReturnCachedShape(Thrive::Ref<Thrive::Physics::ShapeWrapper>&& shape)
+{
+    // Detaching keeps the reference that the Ref had, which is then released by the caller with ReleaseShape
+    return reinterpret_cast<PhysicsShape*>(shape.detach());
+}
+
+/// \brief Shape cache creation callbacks shared by the synchronous and asynchronous shape creation
+static JPH::RefConst<JPH::Shape> CreateCachedMicrobeShapeConvex(
+    const JVecF3* points, uint32_t pointCount, float density, float scale, float thickness)
+{
+    return Thrive::Physics::ShapeCreator::CreateMicrobeShapeConvex(points, pointCount, density, scale, thickness);
+}
+
+static JPH::RefConst<JPH::Shape> CreateCachedConvexShape(
+    const JVecF3* points, uint32_t pointCount, float density, float scale, float convexRadius)
+{
+    return Thrive::Physics::ShapeCreator::CreateConvex(points, pointCount, density, scale, convexRadius);
+}
+
+/// \brief Gives the caller its own reference to a shape build task
+inline PhysicsShapeBuildTask* ReturnShapeBuildTask(Thrive::Ref<Thrive::Physics::ShapeBuildTask>&& task)
+{
+    return reinterpret_cast<PhysicsShapeBuildTask*>(task.detach());
+}
+
 PhysicsShape* CreateBoxShape(float halfSideLength, float density)
 {
     return reinterpret_cast<PhysicsShape*>(
@@ -609,8 +754,9 @@ PhysicsShape* CreateMicrobeShapeConvex(JVecF3* points, uint32_t pointCount, floa
     // We don't want to do any extra data copies here (as the C# marshalling already copies stuff) so this API takes
     // in the JVecF3 pointer
 
-    return reinterpret_cast<PhysicsShape*>(CreateShapeWrapper(
-        Thrive::Physics::ShapeCreator::CreateMicrobeShapeConvex(points, pointCount, density, scale, thickness)));
+    return ReturnCachedShape(Thrive::Physics::ShapeCache::Get().GetOrCreate(
+        Thrive::Physics::CachedShapeKind::MicrobeConvex, points, pointCount, density, scale, thickness,
+        &CreateCachedMicrobeShapeConvex));
 }
 
 PhysicsShape* CreateMicrobeShapeSpheres(JVecF3* points, uint32_t pointCount, float density, float scale)
@@ -618,14 +764,19 @@ PhysicsShape* CreateMicrobeShapeSpheres(JVecF3* points, uint32_t pointCount, flo
     // We don't want to do any extra data copies here (as the C# marshalling already copies stuff) so this API takes
     // in the JVecF3 pointer
 
-    return reinterpret_cast<PhysicsShape*>(CreateShapeWrapper(
-        Thrive::Physics::ShapeCreator::CreateMicrobeShapeSpheres(points, pointCount, density, scale)));
+    return ReturnCachedShape(Thrive::Physics::ShapeCache::Get().GetOrCreate(
+        Thrive::Physics::CachedShapeKind::MicrobeSpheres, points, pointCount, density, scale, 0,
+        [](const JVecF3* shapePoints, uint32_t count, float shapeDensity, float shapeScale, float)
+        {
+            return Thrive::Physics::ShapeCreator::CreateMicrobeShapeSpheres(
+                shapePoints, count, shapeDensity, shapeScale);
+        }));
 }
 
 PhysicsShape* CreateConvexShape(JVecF3* points, uint32_t pointCount, float density, float scale, float convexRadius)
 {
-    return reinterpret_cast<PhysicsShape*>(CreateShapeWrapper(
-        Thrive::Physics::ShapeCreator::CreateConvex(points, pointCount, density, scale, convexRadius)));
+    return ReturnCachedShape(Thrive::Physics::ShapeCache::Get().GetOrCreate(Thrive::Physics::CachedShapeKind::Convex,
+        points, pointCount, density, scale, convexRadius, &CreateCachedConvexShape));
 }
 
 PhysicsShape* CreateStaticCompoundShape(SubShapeDefinition* subShapes, uint32_t shapeCount)
@@ -643,6 +794,72 @@ void ReleaseShape(PhysicsShape* shape)
     reinterpret_cast<Thrive::Physics::ShapeWrapper*>(shape)->Release();
 }
 
+void SetShapeCacheMaxEntries(int32_t maxEntries)
+{
+    Thrive::Physics::ShapeCache::Get().SetMaxEntries(static_cast<size_t>(std::max(maxEntries, 0)));
+}
+
+void ClearUnusedCachedShapes()
+{
+    Thrive::Physics::ShapeCache::Get().ClearUnused();
+}
+
+void GetShapeCacheStatistics(ShapeCacheStatistics* statistics)
+{
+    if (statistics == nullptr) [[unlikely]]
+    {
+        LOG_ERROR("GetShapeCacheStatistics called with null receiver");
+        return;
+    }
+
+    *statistics = Thrive::Physics::ShapeCache::Get().GetStatistics();
+}
+
+// ------------------------------------ //
+PhysicsShapeBuildTask* StartMicrobeShapeConvexBuild(
+    JVecF3* points, uint32_t pointCount, float density, float scale, float thickness)
+{
+    return ReturnShapeBuildTask(Thrive::Physics::ShapeBuildTask::StartCached(
+        Thrive::Physics::CachedShapeKind::MicrobeConvex, points, pointCount, density, scale, thickness,
+        &CreateCachedMicrobeShapeConvex));
+}
+
+PhysicsShapeBuildTask* StartConvexShapeBuild(
+    JVecF3* points, uint32_t pointCount, float density, float scale, float convexRadius)
+{
+    return ReturnShapeBuildTask(Thrive::Physics::ShapeBuildTask::StartCached(Thrive::Physics::CachedShapeKind::Convex,
+        points, pointCount, density, scale, convexRadius, &CreateCachedConvexShape));
+}
+
+PhysicsShapeBuildTask* StartStaticCompoundShapeBuild(SubShapeDefinition* subShapes, uint32_t shapeCount)
+{
+    return ReturnShapeBuildTask(Thrive::Physics::ShapeBuildTask::StartStaticCompound(
+        reinterpret_cast<Thrive::Physics::SubShapeDefinition*>(subShapes), shapeCount));
+}
+
+ShapeBuildTaskState ShapeBuildTaskGetState(PhysicsShapeBuildTask* task)
+{
+    return reinterpret_cast<Thrive::Physics::ShapeBuildTask*>(task)->GetState();
+}
+
+PhysicsShape* ShapeBuildTaskTakeResult(PhysicsShapeBuildTask* task)
+{
+    return ReturnCachedShape(reinterpret_cast<Thrive::Physics::ShapeBuildTask*>(task)->TakeResult());
+}
+
+PhysicsShape* ShapeBuildTaskWait(PhysicsShapeBuildTask* task)
+{
+    return ReturnCachedShape(reinterpret_cast<Thrive::Physics::ShapeBuildTask*>(task)->Wait());
+}
+
+void ReleaseShapeBuildTask(PhysicsShapeBuildTask* task)
+{
+    if (task == nullptr)
+        return;
+
+    reinterpret_cast<Thrive::Physics::ShapeBuildTask*>(task)->Release();
+}
+
 // ------------------------------------ //
 float ShapeGetMass(PhysicsShape* shape)
 {
@@ -688,6 +905,177 @@ JVecF3 ShapeCalculateResultingAngularVelocity(PhysicsShape* shape, JVecF3 applie
     return Thrive::Vec3ToCAPI(deltaTime * result);
 }
 
+// ------------------------------------ //
+CompoundCloudSimulation* CreateCompoundCloudSimulation(
+    int32_t size, int32_t rowStride, float* density, float* oldDensity, float diffusionRate, float viscosity)
+{
+    using SimulationType = Thrive::Simulation::CompoundCloudSimulation;
+
+    // Each square needs to have room for the edges
+    constexpr int32_t minimumSize = SimulationType::SQUARES_PER_SIDE * SimulationType::EDGE_WIDTH * 2;
+
+    if (density == nullptr || oldDensity == nullptr || size < minimumSize || rowStride < size) [[unlikely]]
+    {
+        LOG_ERROR("Invalid compound cloud simulation parameters");
+        return nullptr;
+    }
+
+    Thrive::Ref<SimulationType> simulation(
+        new SimulationType(size, rowStride, density, oldDensity, diffusionRate, viscosity));
+
+    return reinterpret_cast<CompoundCloudSimulation*>(simulation.detach());
+}
+
+void ReleaseCompoundCloudSimulation(CompoundCloudSimulation* simulation)
+{
+    if (simulation == nullptr)
+        return;
+
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->Release();
+}
+
+int32_t CompoundCloudSimulationRowStride(int32_t size)
+{
+    return Thrive::Simulation::CompoundCloudSimulation::CalculateRowStride(size);
+}
+
+void CompoundCloudSimulationSetDecayRates(
+    CompoundCloudSimulation* simulation, float decay1, float decay2, float decay3, float decay4)
+{
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->SetDecayRates(
+        {decay1, decay2, decay3, decay4});
+}
+
+void CompoundCloudSimulationSetPlanePosition(CompoundCloudSimulation* simulation, int32_t x, int32_t y)
+{
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->SetPlanePosition(x, y);
+}
+
+void CompoundCloudSimulationSetVelocityGrid(
+    CompoundCloudSimulation* simulation, const float* velocities, int32_t width, int32_t height, float spacing)
+{
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->SetVelocityGrid(
+        velocities, width, height, spacing);
+}
+
+void CompoundCloudSimulationSetVelocityGridFromCurrents(CompoundCloudSimulation* simulation, FluidCurrents* currents,
+    float originX, float originY, float cellSize, int32_t spacing)
+{
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->SetVelocityGridFromCurrents(
+        *reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents), originX, originY, cellSize, spacing);
+}
+
+void CompoundCloudSimulationSetTextureOutput(
+    CompoundCloudSimulation* simulation, uint8_t* pixels, float intensityScale)
+{
+    reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation*>(simulation)->SetTextureOutput(
+        pixels, intensityScale);
+}
+
+void UpdateCompoundCloudSimulations(CompoundCloudSimulation** simulations, int32_t count, float delta)
+{
+    Thrive::Simulation::CompoundCloudSimulation::UpdateClouds(
+        reinterpret_cast<Thrive::Simulation::CompoundCloudSimulation* const*>(simulations), count, delta);
+}
+
+// ------------------------------------ //
+FluidCurrents* CreateFluidCurrents()
+{
+    Thrive::Ref<Thrive::Simulation::FluidCurrents> currents(new Thrive::Simulation::FluidCurrents());
+
+    return reinterpret_cast<FluidCurrents*>(currents.detach());
+}
+
+void ReleaseFluidCurrents(FluidCurrents* currents)
+{
+    if (currents == nullptr)
+        return;
+
+    reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents)->Release();
+}
+
+void FluidCurrentsSetTime(FluidCurrents* currents, float time)
+{
+    reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents)->SetTime(time);
+}
+
+void FluidCurrentsUpdateGrid(
+    FluidCurrents* currents, float originX, float originY, float spacing, int32_t width, int32_t height)
+{
+    reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents)->UpdateGrid(
+        originX, originY, spacing, width, height);
+}
+
+void FluidCurrentsSampleVelocities(FluidCurrents* currents, const float* positionsX, const float* positionsY,
+    int32_t count, float* resultX, float* resultY)
+{
+    if (count < 1)
+        return;
+
+    reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents)->SampleVelocities(
+        positionsX, positionsY, static_cast<size_t>(count), resultX, resultY);
+}
+
+void PhysicalWorldSetFlowFieldCurrents(PhysicalWorld* physicalWorld, FluidCurrents* currents)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->SetFlowFieldCurrents(reinterpret_cast<Thrive::Simulation::FluidCurrents*>(currents));
+}
+
+void PhysicalWorldSetFlowFieldGrid(PhysicalWorld* physicalWorld, const float* velocities, int32_t width,
+    int32_t height, float originX, float originZ, float spacing)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->SetFlowFieldGrid(velocities, width, height, originX, originZ, spacing);
+}
+
+void PhysicalWorldSetFlowFieldTime(PhysicalWorld* physicalWorld, float time)
+{
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)->SetFlowFieldTime(time);
+}
+
+void SetBodyFlowResponse(PhysicalWorld* physicalWorld, PhysicsBody* body, float forceMultiplier, float drag)
+{
+    if (physicalWorld == nullptr || body == nullptr)
+    {
+        LOG_ERROR("Invalid call to setting body flow response");
+        return;
+    }
+
+    reinterpret_cast<Thrive::Physics::PhysicalWorld*>(physicalWorld)
+        ->SetBodyFlowResponse(*reinterpret_cast<Thrive::Physics::PhysicsBody*>(body), forceMultiplier, drag);
+}
+
+// ------------------------------------ //
+int32_t MembraneGeneratePoints(
+    const float* hexPositions, int32_t hexCount, bool cellWall, float* pointsResult, int32_t maxPoints)
+{
+    if (maxPoints < Thrive::Simulation::MembraneGenerator::MAX_POINTS)
+    {
+        LOG_ERROR("Too small membrane point buffer given");
+        return 0;
+    }
+
+    return Thrive::Simulation::MembraneGenerator::GeneratePoints(hexPositions, hexCount, cellWall, pointsResult);
+}
+
+void MembraneGetMeshBufferSizes(int32_t pointCount, int32_t* vertexCount, int32_t* indexCount)
+{
+    *vertexCount = Thrive::Simulation::MembraneGenerator::GetMeshVertexCount(pointCount);
+    *indexCount = Thrive::Simulation::MembraneGenerator::GetMeshIndexCount(pointCount);
+}
+
+void MembraneBuildMesh(const float* points, int32_t pointCount, float height, float* vertices, float* normals,
+    float* uvs, int32_t* indices)
+{
+    Thrive::Simulation::MembraneGenerator::BuildMesh(points, pointCount, height, vertices, normals, uvs, indices);
+}
+
+void MembraneBuildEngulfMesh(const float* points, int32_t pointCount, float* vertices, float* uvs, int32_t* indices)
+{
+    Thrive::Simulation::MembraneGenerator::BuildEngulfMesh(points, pointCount, vertices, uvs, indices);
+}
+
 // ------------------------------------ //
 void SetNativeExecutorThreads(int32_t count)
 {
@@ -700,6 +1088,39 @@ int32_t GetNativeExecutorThreads()
     return Thrive::TaskSystem::Get().GetThreads();
 }
 
+void GetNativeExecutorJobPoolStatistics(
+    int32_t* capacity, int32_t* slotsInUse, int32_t* highWaterMark, int32_t* overflowAllocations)
+{
+    const auto statistics = Thrive::TaskSystem::Get().GetJobPoolStatistics();
+
+    if (capacity != nullptr)
+        *capacity = statistics.Capacity;
+
+    if (slotsInUse != nullptr)
+        *slotsInUse = statistics.SlotsInUse;
+
+    if (highWaterMark != nullptr)
+        *highWaterMark = statistics.SlotsInUseHighWaterMark;
+
+    if (overflowAllocations != nullptr)
+        *overflowAllocations = statistics.OverflowAllocations;
+}
+
+bool StartNativeTracing(int32_t eventsPerThread)
+{
+    return Thrive::Tracing::Start(eventsPerThread);
+}
+
+void StopNativeTracing()
+{
+    Thrive::Tracing::Stop();
+}
+
+bool WriteNativeTraceFile(const char* path)
+{
+    return Thrive::Tracing::WriteChromeTrace(path);
+}
+
 // ------------------------------------ //
 
 #pragma clang diagnostic pop
@@ -83,6 +83,14 @@ extern "C"
     [[maybe_unused]] THRIVE_NATIVE_API void ReadPhysicsBodyVelocity(
         PhysicalWorld* physicalWorld, PhysicsBody* body, JVecF3* velocityReceiver, JVecF3* angularVelocityReceiver);
 
+    /// Reads the state of count bodies with a single call. Each receiver array (any of which may be null to skip that
+    /// data) needs space for count elements. The state flags receive PhysicsBodyStateFlag values, bodies that could
+    /// not be read have no flags set. May only be called when physics is not currently running.
+    /// \returns The number of bodies that could be read
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldReadBodyStatesBatch(PhysicalWorld* physicalWorld,
+        PhysicsBody** bodies, int32_t count, JVec3* positionsReceiver, JQuat* rotationsReceiver,
+        JVecF3* velocitiesReceiver, JVecF3* angularVelocitiesReceiver, uint8_t* stateFlagsReceiver);
+
     [[maybe_unused]] THRIVE_NATIVE_API void GiveImpulse(
         PhysicalWorld* physicalWorld, PhysicsBody* body, JVecF3 impulse, bool autoActivate);
 
@@ -114,6 +122,15 @@ extern "C"
     [[maybe_unused]] THRIVE_NATIVE_API void SetBodyAllowSleep(
         PhysicalWorld* physicalWorld, PhysicsBody* body, bool allowSleep);
 
+    /// Enables continuous collision detection for a fast moving body so that it doesn't pass through other bodies
+    [[maybe_unused]] THRIVE_NATIVE_API void SetBodyContinuousCollision(
+        PhysicalWorld* physicalWorld, PhysicsBody* body, bool enabled);
+
+    /// Applies a whole buffer of body modifications with one call. Must not be called while physics is running.
+    /// \returns The number of successfully applied commands
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldApplyBodyCommands(
+        PhysicalWorld* physicalWorld, const PhysicsBodyCommand* commands, int32_t count);
+
     [[maybe_unused]] THRIVE_NATIVE_API bool FixBodyYCoordinateToZero(PhysicalWorld* physicalWorld, PhysicsBody* body);
 
     [[maybe_unused]] THRIVE_NATIVE_API void ChangeBodyShape(
@@ -160,12 +177,63 @@ extern "C"
     [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldCastRayGetAll(PhysicalWorld* physicalWorld, JVec3 start,
         JVecF3 endOffset, PhysicsRayWithUserData* dataReceiver, int32_t maxHits);
 
+    /// Finds bodies that have their bounding box overlap the sphere. filter may be null.
+    /// \returns The number of found bodies, the hit fraction of the results is the distance from the center
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldCollideSphere(PhysicalWorld* physicalWorld, JVec3 center,
+        float radius, PhysicsRayWithUserData* dataReceiver, int32_t maxHits, const PhysicsBodyQueryFilter* filter);
+
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldCollideAABox(PhysicalWorld* physicalWorld, JVec3 min,
+        JVec3 max, PhysicsRayWithUserData* dataReceiver, int32_t maxHits, const PhysicsBodyQueryFilter* filter);
+
+    /// Finds up to maxCount nearest bodies (by their position) within maxDistance. Results are sorted by the distance.
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldFindNearestBodies(PhysicalWorld* physicalWorld,
+        JVec3 position, float maxDistance, PhysicsRayWithUserData* dataReceiver, int32_t maxCount,
+        const PhysicsBodyQueryFilter* filter);
+
+    /// Runs all queries (spread over the task threads if there are many) and returns once they are done. Each query
+    /// writes to its own slice of results and has its ResultCount set.
+    /// \returns The total number of results
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldRunQueryBatch(PhysicalWorld* physicalWorld,
+        PhysicsQuery* queries, int32_t queryCount, PhysicsRayWithUserData* results, int32_t resultCapacity);
+
+    /// Casts a shape from start along directionAndLength. filter may be null.
+    /// \returns The number of hits, sorted so that the closest hit is first
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldCastShape(PhysicalWorld* physicalWorld,
+        PhysicsShape* shape, JVec3 start, JQuat rotation, JVecF3 directionAndLength, PhysicsShapeCastHit* dataReceiver,
+        int32_t maxHits, const PhysicsBodyQueryFilter* filter);
+
+    /// Variant of PhysicalWorldRunQueryBatch for shape casts that returns the full hit info
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldCastShapeBatch(PhysicalWorld* physicalWorld,
+        PhysicsQuery* queries, int32_t queryCount, PhysicsShapeCastHit* results, int32_t resultCapacity);
+
     [[maybe_unused]] THRIVE_NATIVE_API float PhysicalWorldGetPhysicsLatestTime(PhysicalWorld* physicalWorld);
     [[maybe_unused]] THRIVE_NATIVE_API float PhysicalWorldGetPhysicsAverageTime(PhysicalWorld* physicalWorld);
 
+    /// \returns Total simulation time in seconds that has been dropped due to the stepping policy
+    [[maybe_unused]] THRIVE_NATIVE_API float PhysicalWorldGetPhysicsDroppedTime(PhysicalWorld* physicalWorld);
+
+    /// Copies the statistics of up to maxCount latest physics updates to receiver (newest first)
+    /// \returns The number of written entries
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t PhysicalWorldGetStepStatistics(
+        PhysicalWorld* physicalWorld, PhysicsStepStatistics* receiver, int32_t maxCount);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetContactStatisticsEnabled(
+        PhysicalWorld* physicalWorld, bool enabled);
+
+    /// Sets the limit of physics steps per process call (0 for unlimited). When mergeExcessSteps is true, time beyond
+    /// the limit is simulated as a single longer step (of at most maxMergedSteps normal steps)
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetSteppingPolicy(
+        PhysicalWorld* physicalWorld, int32_t maxStepsPerProcess, bool mergeExcessSteps, int32_t maxMergedSteps);
+
     [[maybe_unused]] THRIVE_NATIVE_API bool PhysicalWorldDumpPhysicsState(
         PhysicalWorld* physicalWorld, const char* path);
 
+    /// Dumps the current physics state to dumpPath and then records all following simulation affecting operations to
+    /// recordingPath. These can be replayed offline with the thrive_physics_replay tool.
+    [[maybe_unused]] THRIVE_NATIVE_API bool PhysicalWorldStartReplayRecording(
+        PhysicalWorld* physicalWorld, const char* dumpPath, const char* recordingPath);
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldStopReplayRecording(PhysicalWorld* physicalWorld);
+
     [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetDebugDrawLevel(
         PhysicalWorld* physicalWorld, int32_t level = 0);
     [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetDebugDrawCameraLocation(
@@ -195,6 +263,9 @@ extern "C"
     [[maybe_unused]] THRIVE_NATIVE_API PhysicsShape* CreateCapsuleShape(
         float halfHeight, float radius, float density = 1000);
 
+    // The point list based shapes are shared through the native shape cache, so calling these again with the same
+    // data returns the same shape
+
     [[maybe_unused]] THRIVE_NATIVE_API PhysicsShape* CreateMicrobeShapeConvex(
         JVecF3* points, uint32_t pointCount, float density, float scale, float thickness);
     [[maybe_unused]] THRIVE_NATIVE_API PhysicsShape* CreateMicrobeShapeSpheres(
@@ -208,6 +279,38 @@ extern "C"
 
     [[maybe_unused]] THRIVE_NATIVE_API void ReleaseShape(PhysicsShape* shape);
 
+    /// Sets how many shapes the shape cache can keep, 0 disables caching
+    [[maybe_unused]] THRIVE_NATIVE_API void SetShapeCacheMaxEntries(int32_t maxEntries);
+
+    /// Releases all cached shapes that are not in use
+    [[maybe_unused]] THRIVE_NATIVE_API void ClearUnusedCachedShapes();
+
+    [[maybe_unused]] THRIVE_NATIVE_API void GetShapeCacheStatistics(ShapeCacheStatistics* statistics);
+
+    // Asynchronous shape building. These copy the input data and return immediately while the shape is built on the
+    // task system. The returned task needs to be released with ReleaseShapeBuildTask.
+
+    [[maybe_unused]] THRIVE_NATIVE_API PhysicsShapeBuildTask* StartMicrobeShapeConvexBuild(
+        JVecF3* points, uint32_t pointCount, float density, float scale, float thickness);
+
+    [[maybe_unused]] THRIVE_NATIVE_API PhysicsShapeBuildTask* StartConvexShapeBuild(
+        JVecF3* points, uint32_t pointCount, float density, float scale = 1, float convexRadius = 0.01f);
+
+    [[maybe_unused]] THRIVE_NATIVE_API PhysicsShapeBuildTask* StartStaticCompoundShapeBuild(
+        SubShapeDefinition* subShapes, uint32_t shapeCount);
+
+    [[maybe_unused]] THRIVE_NATIVE_API ShapeBuildTaskState ShapeBuildTaskGetState(PhysicsShapeBuildTask* task);
+
+    /// Returns the built shape (which must be released by the caller) or null if not completed yet. Only the first
+    /// call after completion returns the shape.
+    [[maybe_unused]] THRIVE_NATIVE_API PhysicsShape* ShapeBuildTaskTakeResult(PhysicsShapeBuildTask* task);
+
+    /// Blocks until the shape is built and then takes the result the same way as ShapeBuildTaskTakeResult
+    [[maybe_unused]] THRIVE_NATIVE_API PhysicsShape* ShapeBuildTaskWait(PhysicsShapeBuildTask* task);
+
+    /// Releasing a task that is not done yet is allowed, the built shape is then discarded
+    [[maybe_unused]] THRIVE_NATIVE_API void ReleaseShapeBuildTask(PhysicsShapeBuildTask* task);
+
     [[maybe_unused]] THRIVE_NATIVE_API float ShapeGetMass(PhysicsShape* shape);
 
     [[maybe_unused]] THRIVE_NATIVE_API JVecF3 ShapeCalculateResultingAngularVelocity(
@@ -218,8 +321,118 @@ extern "C"
     [[maybe_unused]] THRIVE_NATIVE_API uint32_t ShapeGetSubShapeIndexWithRemainder(
         PhysicsShape* shape, uint32_t subShapeData, uint32_t& remainder);
 
+    // ------------------------------------ //
+    // Compound clouds
+
+    /// Creates a simulation for one cloud plane. The density buffers are owned by the caller and need to stay valid
+    /// (and not move) until the simulation is released. Each buffer holds 4 channels of size * rowStride floats.
+    [[maybe_unused]] THRIVE_NATIVE_API CompoundCloudSimulation* CreateCompoundCloudSimulation(int32_t size,
+        int32_t rowStride, float* density, float* oldDensity, float diffusionRate, float viscosity);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void ReleaseCompoundCloudSimulation(CompoundCloudSimulation* simulation);
+
+    /// Returns the row stride (in floats) the density buffers need to use for a cloud of the given size
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t CompoundCloudSimulationRowStride(int32_t size);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void CompoundCloudSimulationSetDecayRates(
+        CompoundCloudSimulation* simulation, float decay1, float decay2, float decay3, float decay4);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void CompoundCloudSimulationSetPlanePosition(
+        CompoundCloudSimulation* simulation, int32_t x, int32_t y);
+
+    /// Copies a grid of fluid velocities (x, y pairs) used for moving the compounds
+    [[maybe_unused]] THRIVE_NATIVE_API void CompoundCloudSimulationSetVelocityGrid(
+        CompoundCloudSimulation* simulation, const float* velocities, int32_t width, int32_t height, float spacing);
+
+    /// Calculates the velocity grid of a cloud from fluid currents. Cloud cell (x, y) is at world position
+    /// (originX + x * cellSize, originY + y * cellSize) and the currents are sampled every spacing cells.
+    [[maybe_unused]] THRIVE_NATIVE_API void CompoundCloudSimulationSetVelocityGridFromCurrents(
+        CompoundCloudSimulation* simulation, FluidCurrents* currents, float originX, float originY, float cellSize,
+        int32_t spacing);
+
+    /// Sets where the cloud densities are written as RGBA8 image data (size * size pixels) after each update. The
+    /// memory needs to stay valid until the next update is done. Null disables the texture output.
+    [[maybe_unused]] THRIVE_NATIVE_API void CompoundCloudSimulationSetTextureOutput(
+        CompoundCloudSimulation* simulation, uint8_t* pixels, float intensityScale);
+
+    /// Runs one update of all of the given clouds in parallel. Returns once all are done.
+    [[maybe_unused]] THRIVE_NATIVE_API void UpdateCompoundCloudSimulations(
+        CompoundCloudSimulation** simulations, int32_t count, float delta);
+
+    // ------------------------------------ //
+    // Fluid currents
+
+    [[maybe_unused]] THRIVE_NATIVE_API FluidCurrents* CreateFluidCurrents();
+
+    [[maybe_unused]] THRIVE_NATIVE_API void ReleaseFluidCurrents(FluidCurrents* currents);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void FluidCurrentsSetTime(FluidCurrents* currents, float time);
+
+    /// Calculates the noise grid that is used for sampling velocities inside it. Needs to be called again each time
+    /// the time changes. Width or height below 2 removes the grid.
+    [[maybe_unused]] THRIVE_NATIVE_API void FluidCurrentsUpdateGrid(
+        FluidCurrents* currents, float originX, float originY, float spacing, int32_t width, int32_t height);
+
+    /// Calculates the fluid velocities at count positions. Positions inside the grid are interpolated from it.
+    [[maybe_unused]] THRIVE_NATIVE_API void FluidCurrentsSampleVelocities(FluidCurrents* currents,
+        const float* positionsX, const float* positionsY, int32_t count, float* resultX, float* resultY);
+
+    /// Makes the currents push the bodies of a physical world that have a flow response set. Null disables the flow.
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetFlowFieldCurrents(
+        PhysicalWorld* physicalWorld, FluidCurrents* currents);
+
+    /// Sets a grid of x, z velocity pairs as the flow field of a world instead of fluid currents. Point (i, j) is at
+    /// (originX + i * spacing, originZ + j * spacing) and has the index i * height + j.
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetFlowFieldGrid(PhysicalWorld* physicalWorld,
+        const float* velocities, int32_t width, int32_t height, float originX, float originZ, float spacing);
+
+    /// Sets the time the currents are calculated at by the physics. Safe to call while physics is running.
+    [[maybe_unused]] THRIVE_NATIVE_API void PhysicalWorldSetFlowFieldTime(PhysicalWorld* physicalWorld, float time);
+
+    /// Sets how much the flow field pushes a body. Both values as 0 disables the flow for the body.
+    [[maybe_unused]] THRIVE_NATIVE_API void SetBodyFlowResponse(
+        PhysicalWorld* physicalWorld, PhysicsBody* body, float forceMultiplier, float drag);
+
+    // ------------------------------------ //
+    // Membranes
+
+    /// Generates the outline points of a membrane from organelle hex positions (x, y pairs). The result receives the
+    /// points as x, y pairs and needs space for maxPoints points. Returns the number of points generated.
+    [[maybe_unused]] THRIVE_NATIVE_API int32_t MembraneGeneratePoints(
+        const float* hexPositions, int32_t hexCount, bool cellWall, float* pointsResult, int32_t maxPoints);
+
+    /// Tells how large the buffers given to MembraneBuildMesh need to be for pointCount outline points
+    [[maybe_unused]] THRIVE_NATIVE_API void MembraneGetMeshBufferSizes(
+        int32_t pointCount, int32_t* vertexCount, int32_t* indexCount);
+
+    /// Builds the layered membrane mesh (a triangle list) from outline points. Vertices and normals are x, y, z
+    /// triples and UVs x, y pairs.
+    [[maybe_unused]] THRIVE_NATIVE_API void MembraneBuildMesh(const float* points, int32_t pointCount, float height,
+        float* vertices, float* normals, float* uvs, int32_t* indices);
+
+    /// Builds the engulf animation mesh (a triangle strip) from outline points. Needs 2 * pointCount vertices and
+    /// 2 * pointCount + 2 indices.
+    [[maybe_unused]] THRIVE_NATIVE_API void MembraneBuildEngulfMesh(
+        const float* points, int32_t pointCount, float* vertices, float* uvs, int32_t* indices);
+
     // ------------------------------------ //
     // Misc
     [[maybe_unused]] THRIVE_NATIVE_API void SetNativeExecutorThreads(int32_t count);
     [[maybe_unused]] THRIVE_NATIVE_API int32_t GetNativeExecutorThreads();
+
+    /// \brief Reads the usage statistics of the native job object pool (all are zero if pools are disabled)
+    [[maybe_unused]] THRIVE_NATIVE_API void GetNativeExecutorJobPoolStatistics(
+        int32_t* capacity, int32_t* slotsInUse, int32_t* highWaterMark, int32_t* overflowAllocations);
+
+    /// \brief Starts recording what the native threads do (task system jobs, physics updates etc.). Only works when
+    /// the library is compiled with THRIVE_NATIVE_TRACING.
+    /// \param eventsPerThread How many events each thread can record before new events are dropped
+    /// \returns False if tracing is not available
+    [[maybe_unused]] THRIVE_NATIVE_API bool StartNativeTracing(int32_t eventsPerThread);
+
+    [[maybe_unused]] THRIVE_NATIVE_API void StopNativeTracing();
+
+    /// \brief Writes the events of the current (or last) trace session as a Chrome JSON trace file (which can also be
+    /// opened in Perfetto)
+    [[maybe_unused]] THRIVE_NATIVE_API bool WriteNativeTraceFile(const char* path);
 }
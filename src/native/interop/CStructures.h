@@ -10,6 +10,9 @@ extern "C"
     typedef struct PhysicalWorld PhysicalWorld;
     typedef struct PhysicsBody PhysicsBody;
     typedef struct PhysicsShape PhysicsShape;
+    typedef struct PhysicsShapeBuildTask PhysicsShapeBuildTask;
+    typedef struct CompoundCloudSimulation CompoundCloudSimulation;
+    typedef struct FluidCurrents FluidCurrents;
     typedef struct ThriveConfig ThriveConfig;
     typedef struct DebugDrawer DebugDrawer;
     typedef struct GodotVariant GodotVariant;
@@ -57,8 +60,168 @@ extern "C"
 
     END_PACKED_STRUCT;
 
+    /// Type of a single body modification stored in a PhysicsBodyCommand
+    typedef enum PhysicsBodyCommandType : int32_t
+    {
+        PhysicsBodyCommandNone = 0,
+        /// Uses Vector as the impulse
+        PhysicsBodyCommandGiveImpulse = 1,
+        /// Uses Vector as the angular impulse
+        PhysicsBodyCommandGiveAngularImpulse = 2,
+        /// Uses Vector as the velocity
+        PhysicsBodyCommandSetVelocity = 3,
+        /// Uses Vector as the angular velocity
+        PhysicsBodyCommandSetAngularVelocity = 4,
+        /// Uses Vector as the velocity and SecondVector as the angular velocity
+        PhysicsBodyCommandSetVelocityAndAngularVelocity = 5,
+        /// Uses Position
+        PhysicsBodyCommandSetPosition = 6,
+        /// Uses Position and Rotation
+        PhysicsBodyCommandSetPositionAndRotation = 7,
+        /// Uses Value as the linear damping
+        PhysicsBodyCommandSetLinearDamping = 8,
+        /// Uses Value as the linear damping and SecondValue as the angular damping
+        PhysicsBodyCommandSetLinearAndAngularDamping = 9,
+    } PhysicsBodyCommandType;
+
+    /// When set in PhysicsBodyCommand flags the body is activated if the command made it move (position setting
+    /// commands always activate with this flag)
+    static inline const int32_t PhysicsBodyCommandFlagActivate = 1;
+
+    /// A queued modification to a physics body. Multiple of these are submitted at once to apply a lot of changes
+    /// with a single call. Only the fields specified by the type are used, the rest are ignored.
+    typedef struct PhysicsBodyCommand
+    {
+        PhysicsBody* Body;
+        JVec3 Position;
+        JQuat Rotation;
+        JVecF3 Vector;
+        float Value;
+        JVecF3 SecondVector;
+        float SecondValue;
+        PhysicsBodyCommandType Type;
+        int32_t Flags;
+    } PhysicsBodyCommand;
+
+    /// Filtering for body queries. All zero values mean no filtering.
+    typedef struct PhysicsBodyQueryFilter
+    {
+        /// Only bodies where (user data & UserDataMask) == UserDataValue are included. The user data bytes are
+        /// treated as a single 64-bit number.
+        uint64_t UserDataMask;
+        uint64_t UserDataValue;
+        /// This body is never included in the results (for example for a body querying its surroundings)
+        PhysicsBody* IgnoredBody;
+        /// Bit for each object layer that should be included, 0 includes all layers
+        uint32_t LayerMask;
+        int32_t Padding;
+    } PhysicsBodyQueryFilter;
+
+    /// Timing and counters of a single physics update (which may run multiple collision steps). Times are in seconds.
+    /// Body control and collision record clearing run inside the Jolt update so they are also part of its time.
+    typedef struct PhysicsStepStatistics
+    {
+        float BroadPhaseOptimizationTime;
+        float BodyControlTime;
+        float CollisionRecordClearTime;
+        float JoltUpdateTime;
+        /// Summed over all threads so this can be more than the update time. Only measured when contact statistics
+        /// are enabled.
+        float ContactCallbackTime;
+        /// Length of the simulated step
+        float SimulatedTime;
+        /// Increases by one for each update, can be used to detect new entries
+        uint32_t UpdateNumber;
+        int32_t CollisionSteps;
+        int32_t Bodies;
+        int32_t ActiveBodies;
+        /// Contact counters are only collected when contact statistics are enabled
+        int32_t BodyPairsValidated;
+        int32_t ContactsAdded;
+        int32_t ContactsPersisted;
+        int32_t ContactsRemoved;
+        /// Collisions that were not recorded as a body ran out of collision recording slots
+        int32_t RecordedCollisionOverflows;
+    } PhysicsStepStatistics;
+
+    /// Kind of a single query in a query batch
+    typedef enum PhysicsQueryType : int32_t
+    {
+        /// Ray from Position to Position + Vector
+        PhysicsQueryTypeRay = 0,
+        /// Bodies with their shape overlapping a sphere at Position with Radius. The hit fraction of the results is
+        /// the penetration depth.
+        PhysicsQueryTypeSphereOverlap = 1,
+        /// Shape placed at Position with Rotation moved along Vector
+        PhysicsQueryTypeShapeCast = 2,
+    } PhysicsQueryType;
+
+    /// A single query in a batch. All queries of a batch share one result array, each query writes its results to a
+    /// separate slice of it starting at ResultOffset.
+    typedef struct PhysicsQuery
+    {
+        JVec3 Position;
+        JQuat Rotation;
+        JVecF3 Vector;
+        float Radius;
+        /// Only used by shape casts
+        PhysicsShape* Shape;
+        PhysicsBodyQueryFilter Filter;
+        int32_t ResultOffset;
+        int32_t MaxResults;
+        PhysicsQueryType Type;
+        /// Set to the number of results written once the batch is done
+        int32_t ResultCount;
+    } PhysicsQuery;
+
+    /// A shape cast hit with the full contact info
+    typedef struct PhysicsShapeCastHit
+    {
+        /// Contact point on the surface of the hit body in world space
+        JVec3 ContactPoint;
+        /// Surface normal of the hit body at the contact point, points towards the cast shape
+        JVecF3 Normal;
+        /// Fraction of the cast movement when the hit happened, 0 if the shape already overlapped the body at the
+        /// start
+        float Fraction;
+        PhysicsBody* Body;
+        char BodyUserData[PHYSICS_USER_DATA_SIZE];
+        uint32_t SubShapeData;
+        int32_t Padding;
+    } PhysicsShapeCastHit;
+
+    /// Usage info of the native shape cache
+    typedef struct ShapeCacheStatistics
+    {
+        int64_t Hits;
+        int64_t Misses;
+        int64_t Evictions;
+        int32_t Entries;
+        /// Entries that are only kept alive by the cache and can be evicted
+        int32_t UnusedEntries;
+        /// Total time spent creating shapes on cache misses in seconds
+        float CreationTime;
+        int32_t Padding;
+    } ShapeCacheStatistics;
+
+    /// State of a shape being built in the background
+    typedef enum ShapeBuildTaskState : int32_t
+    {
+        ShapeBuildTaskStateQueued = 0,
+        ShapeBuildTaskStateBuilding = 1,
+        /// The shape is ready to be taken
+        ShapeBuildTaskStateCompleted = 2,
+        ShapeBuildTaskStateFailed = 3,
+    } ShapeBuildTaskState;
+
     static inline const JQuat QuatIdentity = JQuat{0, 0, 0, 1};
 
+    /// Set in the state flags filled by PhysicalWorldReadBodyStatesBatch when the body state was read
+    static inline const uint8_t PhysicsBodyStateFlagRead = 1;
+
+    /// Set in the body state flags when the body is active (not sleeping)
+    static inline const uint8_t PhysicsBodyStateFlagActive = 2;
+
     /// Opaque type for passing through info on Thrive::NativeLibIntercommunication instances on the C# side
     typedef struct NativeLibIntercommunicationOpaque
     {
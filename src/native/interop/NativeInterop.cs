@@ -243,6 +243,64 @@ public static class NativeInterop
         NativeMethods.SetNativeExecutorThreads(threads);
     }
 
+    /// <summary>
+    ///   Reads how much of the native physics job pool has been used. Useful for checking whether the pool size is
+    ///   enough as overflowing allocations fall back to slower heap allocations.
+    /// </summary>
+    /// <param name="capacity">Total number of pooled job slots</param>
+    /// <param name="slotsInUse">Slots currently in use (including ones cached by threads)</param>
+    /// <param name="highWaterMark">The highest value of <paramref name="slotsInUse"/> so far</param>
+    /// <param name="overflowAllocations">How many times a job had to be allocated outside the pool</param>
+    public static void GetJobPoolStatistics(out int capacity, out int slotsInUse, out int highWaterMark,
+        out int overflowAllocations)
+    {
+        if (!nativeLoadSucceeded)
+        {
+            capacity = 0;
+            slotsInUse = 0;
+            highWaterMark = 0;
+            overflowAllocations = 0;
+            return;
+        }
+
+        NativeMethods.GetNativeExecutorJobPoolStatistics(out capacity, out slotsInUse, out highWaterMark,
+            out overflowAllocations);
+    }
+
+    /// <summary>
+    ///   Starts recording a trace of the work done by the native threads. Only available when the native library is
+    ///   compiled with tracing support.
+    /// </summary>
+    /// <param name="eventsPerThread">How many events each thread can record before new events are dropped</param>
+    /// <returns>True if tracing started</returns>
+    public static bool StartTracing(int eventsPerThread = 65536)
+    {
+        if (!nativeLoadSucceeded)
+            return false;
+
+        return NativeMethods.StartNativeTracing(eventsPerThread);
+    }
+
+    public static void StopTracing()
+    {
+        if (!nativeLoadSucceeded)
+            return;
+
+        NativeMethods.StopNativeTracing();
+    }
+
+    /// <summary>
+    ///   Writes the recorded trace as a Chrome JSON trace file, which can be viewed with chrome://tracing or Perfetto
+    /// </summary>
+    /// <returns>True on success</returns>
+    public static bool WriteTraceFile(string path)
+    {
+        if (!nativeLoadSucceeded)
+            return false;
+
+        return NativeMethods.WriteNativeTraceFile(path);
+    }
+
     private static CPUCheckResult CheckCPUFeaturesFull()
     {
         var result = CPUCheckResult.CPUCheckSuccess;
@@ -391,6 +449,7 @@ public static class NativeInterop
 
         CheckSizeOfType<PhysicsCollision>(48);
         CheckSizeOfType<SubShapeDefinition>(40);
+        CheckSizeOfType<PhysicsBodyCommand>(88);
     }
 
     private static void CheckSizeOfType<T>(int expected)
@@ -805,5 +864,18 @@ internal static partial class NativeMethods
     [DllImport("thrive_native")]
     internal static extern int GetNativeExecutorThreads();
 
+    [DllImport("thrive_native")]
+    internal static extern void GetNativeExecutorJobPoolStatistics(out int capacity, out int slotsInUse,
+        out int highWaterMark, out int overflowAllocations);
+
+    [DllImport("thrive_native")]
+    internal static extern bool StartNativeTracing(int eventsPerThread);
+
+    [DllImport("thrive_native")]
+    internal static extern void StopNativeTracing();
+
+    [DllImport("thrive_native", CharSet = CharSet.Ansi, BestFitMapping = false)]
+    internal static extern bool WriteNativeTraceFile(string path);
+
     // The wrapper-specific methods are in their respective files like PhysicalWorld.cs etc.
 }
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "Jolt/Physics/Body/BodyFilter.h"
+#include "Jolt/Physics/Body/BodyLock.h"
+#include "Jolt/Physics/Body/BodyLockInterface.h"
+#include "Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h"
+#include "Jolt/Physics/Collision/ObjectLayer.h"
+
+#include "interop/CStructures.h"
+
+#include "PhysicsBody.hpp"
+#include "PhysicsRayWithUserData.hpp"
+
+namespace Thrive::Physics
+{
+
+/// \brief Only lets through the object layers that have their bit set in a mask (a zero mask allows all layers)
+class ObjectLayerMaskFilter final : public JPH::ObjectLayerFilter
+{
+public:
+    explicit ObjectLayerMaskFilter(uint32_t layerMask) : layerMask(layerMask)
+    {
+    }
+
+    [[nodiscard]] bool ShouldCollide(JPH::ObjectLayer layer) const override
+    {
+        return layerMask == 0 || (layerMask & (1u << layer)) != 0;
+    }
+
+private:
+    const uint32_t layerMask;
+};
+
+/// \brief Applies the body part of a PhysicsBodyQueryFilter (ignored body and user data) to narrowphase queries
+class QueryBodyFilter final : public JPH::BodyFilter
+{
+public:
+    explicit QueryBodyFilter(const PhysicsBodyQueryFilter* filter)
+    {
+        if (filter != nullptr)
+        {
+            userDataMask = filter->UserDataMask;
+            userDataValue = filter->UserDataValue;
+            ignoredBody = reinterpret_cast<const PhysicsBody*>(filter->IgnoredBody);
+        }
+    }
+
+    [[nodiscard]] bool ShouldCollideLocked(const JPH::Body& body) const override
+    {
+        const auto* bodyWrapper = PhysicsBody::FromJoltBody(body.GetUserData());
+
+        if (bodyWrapper != nullptr && bodyWrapper == ignoredBody)
+            return false;
+
+        // User data filtering treats the user data bytes as a single number like ArrayBodyCollector
+        uint64_t userData = 0;
+
+        if (bodyWrapper != nullptr && bodyWrapper->HasUserData())
+            std::memcpy(&userData, bodyWrapper->GetUserData().data(), sizeof(userData));
+
+        return (userData & userDataMask) == userDataValue;
+    }
+
+private:
+    uint64_t userDataMask = 0;
+    uint64_t userDataValue = 0;
+    const PhysicsBody* ignoredBody = nullptr;
+};
+
+/// \brief Helper class to collect bodies found by broadphase queries into a PhysicsRayWithUserData array
+///
+/// The hit fraction of the results is the distance from the query position to the body position. Sub-shape data is
+/// always unknown as the broadphase only deals with whole bodies.
+class ArrayBodyCollector final : public JPH::CollideShapeBodyCollector,
+                                 public NonCopyable
+{
+public:
+    /// \param collectAll When true all hits are kept in an internal list to be sorted with WriteNearest instead of
+    /// writing them directly to dataReceiver
+    /// \param maxDistance Bodies that have their position further than this from the query position are skipped
+    ArrayBodyCollector(PhysicsRayWithUserData dataReceiver[], int maxHits, const PhysicsBodyQueryFilter* filter,
+        JPH::RVec3Arg queryPosition, const JPH::BodyLockInterface& bodyLockInterface, bool collectAll = false,
+        float maxDistance = std::numeric_limits<float>::max()) :
+        bodyInterface(bodyLockInterface),
+        queryPosition(queryPosition), maxDistance(maxDistance), hitStorage(dataReceiver),
+        hitStorageSpaceLeft(maxHits), collectAll(collectAll)
+    {
+        if (filter != nullptr)
+        {
+            userDataMask = filter->UserDataMask;
+            userDataValue = filter->UserDataValue;
+            ignoredBody = reinterpret_cast<const PhysicsBody*>(filter->IgnoredBody);
+        }
+
+        if (hitStorage == nullptr)
+        {
+            using namespace JPH;
+
+            JPH_ASSERT(hitStorage);
+
+            hitStorageSpaceLeft = 0;
+        }
+    }
+
+    void AddHit(const ResultType& inResult) final
+    {
+        if (hitStorageSpaceLeft < 1 && !collectAll)
+        {
+            ForceEarlyOut();
+            return;
+        }
+
+        JPH::BodyLockRead lock(bodyInterface, inResult);
+        if (!lock.Succeeded()) [[unlikely]]
+            return;
+
+        const JPH::Body& body = lock.GetBody();
+
+        const auto* bodyWrapper = PhysicsBody::FromJoltBody(body.GetUserData());
+
+        if (bodyWrapper != nullptr && bodyWrapper == ignoredBody)
+            return;
+
+        // User data filtering treats the user data bytes as a single number
+        uint64_t userData = 0;
+
+        if (bodyWrapper != nullptr && bodyWrapper->HasUserData())
+        {
+            static_assert(sizeof(userData) == PHYSICS_USER_DATA_SIZE);
+            std::memcpy(&userData, bodyWrapper->GetUserData().data(), sizeof(userData));
+        }
+
+        if ((userData & userDataMask) != userDataValue)
+            return;
+
+        const auto distance = static_cast<float>((body.GetPosition() - queryPosition).Length());
+
+        if (distance > maxDistance)
+            return;
+
+        PhysicsRayWithUserData* target;
+
+        if (collectAll)
+        {
+            target = &collectedHits.emplace_back();
+        }
+        else
+        {
+            target = hitStorage++;
+            --hitStorageSpaceLeft;
+        }
+
+        target->Body = bodyWrapper;
+        std::memcpy(target->BodyUserData.data(), &userData, target->BodyUserData.size());
+        target->SubShapeData = COLLISION_UNKNOWN_SUB_SHAPE;
+        target->HitFraction = distance;
+
+        ++hitCount;
+    }
+
+    /// \brief Writes the nearest collected hits (when collecting all hits) sorted by distance
+    /// \returns The number of written hits
+    int WriteNearest()
+    {
+        const auto count = std::min(static_cast<int>(collectedHits.size()), hitStorageSpaceLeft);
+
+        if (count < 1)
+            return 0;
+
+        const auto compare = [](const PhysicsRayWithUserData& first, const PhysicsRayWithUserData& second)
+        { return first.HitFraction < second.HitFraction; };
+
+        std::partial_sort(collectedHits.begin(), collectedHits.begin() + count, collectedHits.end(), compare);
+        std::copy(collectedHits.begin(), collectedHits.begin() + count, hitStorage);
+
+        return count;
+    }
+
+    [[nodiscard]] inline int GetHitCount() const noexcept
+    {
+        return hitCount;
+    }
+
+private:
+    const JPH::BodyLockInterface& bodyInterface;
+
+    const JPH::RVec3 queryPosition;
+    const float maxDistance;
+
+    uint64_t userDataMask = 0;
+    uint64_t userDataValue = 0;
+    const PhysicsBody* ignoredBody = nullptr;
+
+    PhysicsRayWithUserData* hitStorage;
+    int hitStorageSpaceLeft;
+    int hitCount = 0;
+
+    const bool collectAll;
+    std::vector<PhysicsRayWithUserData> collectedHits;
+};
+
+} // namespace Thrive::Physics
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "Jolt/Physics/Body/BodyLock.h"
+#include "Jolt/Physics/Body/BodyLockInterface.h"
+#include "Jolt/Physics/Collision/CollideShape.h"
+#include "Jolt/Physics/Collision/ShapeCast.h"
+
+#include "interop/CStructures.h"
+
+#include "PhysicsBody.hpp"
+#include "PhysicsRayWithUserData.hpp"
+
+namespace Thrive::Physics
+{
+
+/// \brief Helper class to collect shape overlap or shape cast hits into a PhysicsRayWithUserData array
+///
+/// For shape casts the hit fraction is the fraction along the cast direction, for overlaps it is the penetration
+/// depth.
+template<class ResultTypeArg, class TraitsType>
+class ArrayShapeCollector final : public JPH::CollisionCollector<ResultTypeArg, TraitsType>,
+                                  public NonCopyable
+{
+public:
+    using ResultType = ResultTypeArg;
+
+    ArrayShapeCollector(
+        PhysicsRayWithUserData dataReceiver[], int maxHits, const JPH::BodyLockInterface& bodyLockInterface) :
+        bodyInterface(bodyLockInterface),
+        hitStorage(dataReceiver), hitStorageSpaceLeft(maxHits)
+    {
+        if (hitStorage == nullptr)
+        {
+            using namespace JPH;
+
+            JPH_ASSERT(hitStorage);
+
+            hitStorageSpaceLeft = 0;
+        }
+    }
+
+    void AddHit(const ResultType& inResult) final
+    {
+        if (hitStorageSpaceLeft < 1)
+        {
+            this->ForceEarlyOut();
+            return;
+        }
+
+        JPH::BodyLockRead lock(bodyInterface, inResult.mBodyID2);
+        if (!lock.Succeeded()) [[unlikely]]
+            return;
+
+        const auto* bodyWrapper = PhysicsBody::FromJoltBody(lock.GetBody().GetUserData());
+        hitStorage->Body = bodyWrapper;
+
+        if (bodyWrapper != nullptr)
+        {
+            std::memcpy(
+                hitStorage->BodyUserData.data(), bodyWrapper->GetUserData().data(), hitStorage->BodyUserData.size());
+        }
+        else
+        {
+            std::memset(hitStorage->BodyUserData.data(), 0, hitStorage->BodyUserData.size());
+        }
+
+        if constexpr (std::is_same_v<ResultType, JPH::ShapeCastResult>)
+        {
+            hitStorage->HitFraction = inResult.mFraction;
+        }
+        else
+        {
+            hitStorage->HitFraction = inResult.mPenetrationDepth;
+        }
+
+        hitStorage->SubShapeData = inResult.mSubShapeID2.GetValue();
+
+        ++hitCount;
+        ++hitStorage;
+        --hitStorageSpaceLeft;
+    }
+
+    [[nodiscard]] inline int GetHitCount() const noexcept
+    {
+        return hitCount;
+    }
+
+private:
+    const JPH::BodyLockInterface& bodyInterface;
+
+    PhysicsRayWithUserData* hitStorage;
+    int hitStorageSpaceLeft;
+    int hitCount = 0;
+};
+
+/// \brief Collects shape cast hits with the full contact info. When there are more hits than space the furthest
+/// stored hit is replaced, so the closest hits are always kept.
+class ArrayShapeCastHitCollector final : public JPH::CastShapeCollector,
+                                         public NonCopyable
+{
+public:
+    /// \param baseOffset The base offset given to the query, contact points are relative to it
+    ArrayShapeCastHitCollector(PhysicsShapeCastHit dataReceiver[], int maxHits, JPH::RVec3Arg baseOffset,
+        const JPH::BodyLockInterface& bodyLockInterface) :
+        bodyInterface(bodyLockInterface),
+        baseOffset(baseOffset), hitStorage(dataReceiver), maxHits(maxHits)
+    {
+        if (hitStorage == nullptr)
+        {
+            using namespace JPH;
+
+            JPH_ASSERT(hitStorage);
+
+            this->maxHits = 0;
+        }
+    }
+
+    void AddHit(const ResultType& inResult) final
+    {
+        if (maxHits < 1)
+        {
+            ForceEarlyOut();
+            return;
+        }
+
+        PhysicsShapeCastHit* target;
+
+        if (hitCount < maxHits)
+        {
+            target = hitStorage + hitCount;
+        }
+        else
+        {
+            target = FindFurthestHit();
+
+            // Jolt only reports hits closer than the early out fraction but hits at the same fraction can still come
+            if (inResult.mFraction >= target->Fraction)
+                return;
+        }
+
+        JPH::BodyLockRead lock(bodyInterface, inResult.mBodyID2);
+        if (!lock.Succeeded()) [[unlikely]]
+            return;
+
+        const auto* bodyWrapper = PhysicsBody::FromJoltBody(lock.GetBody().GetUserData());
+
+        // The C structure uses the opaque C API body type
+        target->Body = reinterpret_cast<::PhysicsBody*>(const_cast<PhysicsBody*>(bodyWrapper));
+
+        if (bodyWrapper != nullptr)
+        {
+            std::memcpy(target->BodyUserData, bodyWrapper->GetUserData().data(), sizeof(target->BodyUserData));
+        }
+        else
+        {
+            std::memset(target->BodyUserData, 0, sizeof(target->BodyUserData));
+        }
+
+        const JPH::RVec3 contactPoint = baseOffset + inResult.mContactPointOn2;
+        target->ContactPoint = JVec3{contactPoint.GetX(), contactPoint.GetY(), contactPoint.GetZ()};
+
+        // The penetration axis points from the cast shape into the hit body
+        const auto normal = -inResult.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero());
+        target->Normal = JVecF3{normal.GetX(), normal.GetY(), normal.GetZ()};
+
+        target->Fraction = inResult.mFraction;
+        target->SubShapeData = inResult.mSubShapeID2.GetValue();
+        target->Padding = 0;
+
+        if (hitCount < maxHits)
+            ++hitCount;
+
+        // Once full only hits closer than the current furthest one are useful
+        if (hitCount >= maxHits)
+            UpdateEarlyOutFraction(FindFurthestHit()->Fraction);
+    }
+
+    /// \brief Sorts the collected hits so that the closest hit is first
+    void SortHits()
+    {
+        std::sort(hitStorage, hitStorage + hitCount,
+            [](const PhysicsShapeCastHit& first, const PhysicsShapeCastHit& second)
+            { return first.Fraction < second.Fraction; });
+    }
+
+    [[nodiscard]] inline int GetHitCount() const noexcept
+    {
+        return hitCount;
+    }
+
+private:
+    [[nodiscard]] PhysicsShapeCastHit* FindFurthestHit() const
+    {
+        return std::max_element(hitStorage, hitStorage + hitCount,
+            [](const PhysicsShapeCastHit& first, const PhysicsShapeCastHit& second)
+            { return first.Fraction < second.Fraction; });
+    }
+
+private:
+    const JPH::BodyLockInterface& bodyInterface;
+
+    const JPH::RVec3 baseOffset;
+
+    PhysicsShapeCastHit* hitStorage;
+    int maxHits;
+    int hitCount = 0;
+};
+
+using ArrayOverlapCollector = ArrayShapeCollector<JPH::CollideShapeResult, JPH::CollisionCollectorTraitsCollideShape>;
+using ArrayShapeCastCollector = ArrayShapeCollector<JPH::ShapeCastResult, JPH::CollisionCollectorTraitsCastShape>;
+
+} // namespace Thrive::Physics
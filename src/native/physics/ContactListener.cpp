@@ -158,6 +158,9 @@ inline void UpdateCollisionInfoFromManifold(
 JPH::ValidateResult ContactListener::OnContactValidate(const JPH::Body& body1, const JPH::Body& body2,
     JPH::RVec3Arg baseOffset, const JPH::CollideShapeResult& collisionResult)
 {
+    const bool timeCallback = IsCollectingStatistics();
+    const auto callbackStart = timeCallback ? TimingClock::now() : TimingClock::time_point();
+
     JPH::ValidateResult result = JPH::ContactListener::OnContactValidate(body1, body2, baseOffset, collisionResult);
 
     // Body-specific filtering. Likely is used here as the base method always allows contact, and we don't use chained
@@ -273,12 +276,18 @@ JPH::ValidateResult ContactListener::OnContactValidate(const JPH::Body& body1, c
     }
 #endif
 
+    if (timeCallback) [[unlikely]]
+        ReportCallback(bodyPairsValidated, callbackStart);
+
     return result;
 }
 
 void ContactListener::OnContactAdded(const JPH::Body& body1, const JPH::Body& body2,
     const JPH::ContactManifold& manifold, JPH::ContactSettings& settings)
 {
+    const bool timeCallback = IsCollectingStatistics();
+    const auto callbackStart = timeCallback ? TimingClock::now() : TimingClock::time_point();
+
     // Note the bodies are sorted (`body1.GetID() < body2.GetID()`)
     UNUSED(settings);
 
@@ -339,6 +348,10 @@ void ContactListener::OnContactAdded(const JPH::Body& body1, const JPH::Body& bo
             PrepareCollisionInfoFromManifold(*writeTarget, body1Object, body2Object, manifold, true, false);
 #endif
         }
+        else
+        {
+            ReportRecordingOverflow();
+        }
     }
 
 object1HandlingEnd:
@@ -376,6 +389,10 @@ object1HandlingEnd:
             PrepareCollisionInfoFromManifold(*writeTarget, body1Object, body2Object, manifold, true, true);
 #endif
         }
+        else
+        {
+            ReportRecordingOverflow();
+        }
     }
 
     // This needs to immediately end as otherwise this doesn't compile as apparently that is a C++20 extension to have
@@ -393,11 +410,17 @@ object2HandlingEnd:;
             manifold.GetWorldSpaceContactPointOn1(0) + manifold.mWorldSpaceNormal, JPH::Color::sGreen, 0.05f);
     }
 #endif
+
+    if (timeCallback) [[unlikely]]
+        ReportCallback(contactsAdded, callbackStart);
 }
 
 void ContactListener::OnContactPersisted(const JPH::Body& body1, const JPH::Body& body2,
     const JPH::ContactManifold& manifold, JPH::ContactSettings& settings)
 {
+    const bool timeCallback = IsCollectingStatistics();
+    const auto callbackStart = timeCallback ? TimingClock::now() : TimingClock::time_point();
+
     UNUSED(settings);
 
 #ifdef JPH_DEBUG_RENDERER
@@ -453,6 +476,10 @@ void ContactListener::OnContactPersisted(const JPH::Body& body1, const JPH::Body
             PrepareCollisionInfoFromManifold(*writeTarget, body1Object, body2Object, manifold, false, false);
 #endif
         }
+        else
+        {
+            ReportRecordingOverflow();
+        }
     }
 
 object1HandlingEnd:
@@ -490,6 +517,10 @@ object1HandlingEnd:
             PrepareCollisionInfoFromManifold(*writeTarget, body1Object, body2Object, manifold, false, true);
 #endif
         }
+        else
+        {
+            ReportRecordingOverflow();
+        }
     }
 
 object2HandlingEnd:;
@@ -505,10 +536,16 @@ object2HandlingEnd:;
             manifold.GetWorldSpaceContactPointOn1(0) + manifold.mWorldSpaceNormal, JPH::Color::sYellow, 0.05f);
     }
 #endif
+
+    if (timeCallback) [[unlikely]]
+        ReportCallback(contactsPersisted, callbackStart);
 }
 
 void ContactListener::OnContactRemoved(const JPH::SubShapeIDPair& subShapePair)
 {
+    const bool timeCallback = IsCollectingStatistics();
+    const auto callbackStart = timeCallback ? TimingClock::now() : TimingClock::time_point();
+
 #ifdef JPH_DEBUG_RENDERER
     // Remove the contact
     {
@@ -521,9 +558,28 @@ void ContactListener::OnContactRemoved(const JPH::SubShapeIDPair& subShapePair)
 #else
     UNUSED(subShapePair);
 #endif
+
+    if (timeCallback) [[unlikely]]
+        ReportCallback(contactsRemoved, callbackStart);
 }
 
 // ------------------------------------ //
+ContactListenerStatistics ContactListener::TakeStatistics() noexcept
+{
+    ContactListenerStatistics result;
+
+    result.BodyPairsValidated = bodyPairsValidated.exchange(0, std::memory_order_relaxed);
+    result.ContactsAdded = contactsAdded.exchange(0, std::memory_order_relaxed);
+    result.ContactsPersisted = contactsPersisted.exchange(0, std::memory_order_relaxed);
+    result.ContactsRemoved = contactsRemoved.exchange(0, std::memory_order_relaxed);
+    result.RecordedCollisionOverflows = recordedCollisionOverflows.exchange(0, std::memory_order_relaxed);
+
+    const auto callbackTime = std::chrono::nanoseconds(callbackNanoseconds.exchange(0, std::memory_order_relaxed));
+    result.CallbackTime = std::chrono::duration_cast<SecondDuration>(callbackTime).count();
+
+    return result;
+}
+
 #ifdef JPH_DEBUG_RENDERER
 void ContactListener::DrawActiveContacts(JPH::DebugRenderer& debugRenderer)
 {
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
+
 #include "Jolt/Physics/Collision/ContactListener.h"
 
 #include "core/Mutex.hpp"
+#include "core/Time.hpp"
 
 namespace JPH
 {
@@ -18,6 +21,21 @@ namespace Thrive::Physics
 uint32_t ResolveTopLevelSubShapeId(const JPH::Body* body, JPH::SubShapeID subShapeId);
 uint32_t ResolveSubShapeId(const JPH::Shape* shape, JPH::SubShapeID subShapeId, JPH::SubShapeID& remainder);
 
+/// \brief Counts of what the contact listener has done since the statistics were last taken
+struct ContactListenerStatistics
+{
+    int32_t BodyPairsValidated = 0;
+    int32_t ContactsAdded = 0;
+    int32_t ContactsPersisted = 0;
+    int32_t ContactsRemoved = 0;
+
+    /// \brief How many collisions were not recorded as the body didn't have free recording slots
+    int32_t RecordedCollisionOverflows = 0;
+
+    /// \brief Summed time of all callbacks (over all threads) in seconds
+    float CallbackTime = 0;
+};
+
 /// \brief Contact listener implementation
 class ContactListener : public JPH::ContactListener
 {
@@ -43,6 +61,21 @@ public:
         persistCollisions = persistExistingCollisions;
     }
 
+    /// \brief Enables the callback counters and timing. Recorded collision overflows are always counted.
+    inline void SetCollectStatistics(bool collect) noexcept
+    {
+        collectStatistics.store(collect, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline bool IsCollectingStatistics() const noexcept
+    {
+        return collectStatistics.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Returns the statistics collected since the last call and resets them. Should only be called while no
+    /// physics update is running.
+    ContactListenerStatistics TakeStatistics() noexcept;
+
 #ifdef JPH_DEBUG_RENDERER
     void DrawActiveContacts(JPH::DebugRenderer& debugRenderer);
 
@@ -59,6 +92,21 @@ public:
     }
 #endif
 
+private:
+    /// \brief Adds the time of a single callback to the statistics
+    inline void ReportCallback(std::atomic<int32_t>& counter, TimingClock::time_point start) noexcept
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+        callbackNanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(TimingClock::now() - start).count(),
+            std::memory_order_relaxed);
+    }
+
+    inline void ReportRecordingOverflow() noexcept
+    {
+        recordedCollisionOverflows.fetch_add(1, std::memory_order_relaxed);
+    }
+
 private:
     Mutex currentCollisionsMutex;
 
@@ -73,6 +121,15 @@ private:
     /// When this is true the listener keeps the previous physics data and only combines new data into the physics
     bool persistCollisions = false;
 
+    std::atomic<bool> collectStatistics{false};
+
+    std::atomic<int32_t> bodyPairsValidated{0};
+    std::atomic<int32_t> contactsAdded{0};
+    std::atomic<int32_t> contactsPersisted{0};
+    std::atomic<int32_t> contactsRemoved{0};
+    std::atomic<int32_t> recordedCollisionOverflows{0};
+    std::atomic<int64_t> callbackNanoseconds{0};
+
 #ifdef JPH_DEBUG_RENDERER
     JPH::DebugRenderer* debugDrawer = nullptr;
     bool drawOnlyNew = false;
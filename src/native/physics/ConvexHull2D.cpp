@@ -0,0 +1,345 @@
+// ------------------------------------ //
+#include "ConvexHull2D.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef THRIVE_USE_AVX2
+#include <immintrin.h>
+#endif
+
+// ------------------------------------ //
+namespace Thrive::Physics
+{
+
+static_assert(sizeof(JVecF3) == sizeof(float) * 3, "point data is read as a packed float array");
+
+/// \brief Cross product of (b - a) and (c - a), positive when c is on the left side of the line from a to b
+static FORCE_INLINE float CrossXZ(const HullPoint2D& a, const HullPoint2D& b, const HullPoint2D& c)
+{
+    return (b.X - a.X) * (c.Z - a.Z) - (b.Z - a.Z) * (c.X - a.X);
+}
+
+bool ConvexHull2D::IsPlanarInY(const JVecF3* points, uint32_t pointCount, float tolerance /*= 0.0001f*/)
+{
+    if (pointCount < 1)
+        return true;
+
+    const auto y = points[0].Y;
+
+    for (uint32_t i = 1; i < pointCount; ++i)
+    {
+        if (std::abs(points[i].Y - y) > tolerance)
+            return false;
+    }
+
+    return true;
+}
+
+bool ConvexHull2D::Compute(const JVecF3* points, uint32_t pointCount, float scale, std::vector<HullPoint2D>& hull)
+{
+    hull.clear();
+
+    if (pointCount < 3)
+        return false;
+
+    std::vector<float> xs;
+    std::vector<float> zs;
+    ProjectPoints(points, pointCount, scale, xs, zs);
+
+    const auto octagon = FindExtremePoints(xs, zs);
+
+    std::vector<HullPoint2D> candidates;
+    CollectPossibleHullPoints(xs, zs, octagon, candidates);
+
+    MonotoneChain(candidates, hull);
+
+    return hull.size() >= 3;
+}
+
+// ------------------------------------ //
+void ConvexHull2D::ProjectPoints(
+    const JVecF3* points, uint32_t pointCount, float scale, std::vector<float>& xs, std::vector<float>& zs)
+{
+    xs.resize(pointCount);
+    zs.resize(pointCount);
+
+    uint32_t i = 0;
+
+#ifdef THRIVE_USE_AVX2
+    const auto* rawData = reinterpret_cast<const float*>(points);
+    const auto strideIndices = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const auto scaleVector = _mm256_set1_ps(scale);
+
+    for (; i + 8 <= pointCount; i += 8)
+    {
+        const float* base = rawData + static_cast<size_t>(i) * 3;
+
+        const auto x = _mm256_i32gather_ps(base, strideIndices, sizeof(float));
+        const auto z = _mm256_i32gather_ps(base + 2, strideIndices, sizeof(float));
+
+        _mm256_storeu_ps(xs.data() + i, _mm256_mul_ps(x, scaleVector));
+        _mm256_storeu_ps(zs.data() + i, _mm256_mul_ps(z, scaleVector));
+    }
+#endif
+
+    for (; i < pointCount; ++i)
+    {
+        xs[i] = points[i].X * scale;
+        zs[i] = points[i].Z * scale;
+    }
+}
+
+ConvexHull2D::Octagon ConvexHull2D::FindExtremePoints(const std::vector<float>& xs, const std::vector<float>& zs)
+{
+    // The extremes are tracked for x, z, x + z and x - z, the maximums and minimums of those give the 8 directions
+    constexpr int valueCount = 4;
+
+    float maxValues[valueCount] = {xs[0], zs[0], xs[0] + zs[0], xs[0] - zs[0]};
+    float minValues[valueCount] = {maxValues[0], maxValues[1], maxValues[2], maxValues[3]};
+    uint32_t maxIndices[valueCount] = {0, 0, 0, 0};
+    uint32_t minIndices[valueCount] = {0, 0, 0, 0};
+
+    const auto count = static_cast<uint32_t>(xs.size());
+    uint32_t i = 0;
+
+#ifdef THRIVE_USE_AVX2
+    if (count >= 8)
+    {
+        __m256 maxVectors[valueCount];
+        __m256 minVectors[valueCount];
+        __m256i maxIndexVectors[valueCount];
+        __m256i minIndexVectors[valueCount];
+
+        for (int value = 0; value < valueCount; ++value)
+        {
+            maxVectors[value] = _mm256_set1_ps(maxValues[value]);
+            minVectors[value] = maxVectors[value];
+            maxIndexVectors[value] = _mm256_setzero_si256();
+            minIndexVectors[value] = _mm256_setzero_si256();
+        }
+
+        auto indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const auto indexStep = _mm256_set1_epi32(8);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto x = _mm256_loadu_ps(xs.data() + i);
+            const auto z = _mm256_loadu_ps(zs.data() + i);
+
+            const __m256 values[valueCount] = {x, z, _mm256_add_ps(x, z), _mm256_sub_ps(x, z)};
+
+            for (int value = 0; value < valueCount; ++value)
+            {
+                const auto greater = _mm256_cmp_ps(values[value], maxVectors[value], _CMP_GT_OQ);
+                maxVectors[value] = _mm256_blendv_ps(maxVectors[value], values[value], greater);
+                maxIndexVectors[value] =
+                    _mm256_blendv_epi8(maxIndexVectors[value], indices, _mm256_castps_si256(greater));
+
+                const auto less = _mm256_cmp_ps(values[value], minVectors[value], _CMP_LT_OQ);
+                minVectors[value] = _mm256_blendv_ps(minVectors[value], values[value], less);
+                minIndexVectors[value] = _mm256_blendv_epi8(minIndexVectors[value], indices, _mm256_castps_si256(less));
+            }
+
+            indices = _mm256_add_epi32(indices, indexStep);
+        }
+
+        // Combine the per-lane results
+        alignas(32) float laneValues[8];
+        alignas(32) uint32_t laneIndices[8];
+
+        for (int value = 0; value < valueCount; ++value)
+        {
+            _mm256_store_ps(laneValues, maxVectors[value]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), maxIndexVectors[value]);
+
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (laneValues[lane] > maxValues[value])
+                {
+                    maxValues[value] = laneValues[lane];
+                    maxIndices[value] = laneIndices[lane];
+                }
+            }
+
+            _mm256_store_ps(laneValues, minVectors[value]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), minIndexVectors[value]);
+
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (laneValues[lane] < minValues[value])
+                {
+                    minValues[value] = laneValues[lane];
+                    minIndices[value] = laneIndices[lane];
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const float values[valueCount] = {xs[i], zs[i], xs[i] + zs[i], xs[i] - zs[i]};
+
+        for (int value = 0; value < valueCount; ++value)
+        {
+            if (values[value] > maxValues[value])
+            {
+                maxValues[value] = values[value];
+                maxIndices[value] = i;
+            }
+
+            if (values[value] < minValues[value])
+            {
+                minValues[value] = values[value];
+                minIndices[value] = i;
+            }
+        }
+    }
+
+    const auto point = [&xs, &zs](uint32_t index) { return HullPoint2D{xs[index], zs[index]}; };
+
+    // Counter-clockwise from -Z: -Z, +X-Z, +X, +X+Z, +Z, -X+Z, -X, -X-Z
+    return Octagon{point(minIndices[1]), point(maxIndices[3]), point(maxIndices[0]), point(maxIndices[2]),
+        point(maxIndices[1]), point(minIndices[3]), point(minIndices[0]), point(minIndices[2])};
+}
+
+void ConvexHull2D::CollectPossibleHullPoints(const std::vector<float>& xs, const std::vector<float>& zs,
+    const Octagon& octagon, std::vector<HullPoint2D>& result)
+{
+    const auto count = static_cast<uint32_t>(xs.size());
+
+    result.clear();
+    result.reserve(count);
+
+    // Multiple extremes can be the same point, those don't form edges
+    float edgeStartX[8];
+    float edgeStartZ[8];
+    float edgeDirectionX[8];
+    float edgeDirectionZ[8];
+    int edgeCount = 0;
+
+    for (size_t i = 0; i < octagon.size(); ++i)
+    {
+        const auto& start = octagon[i];
+        const auto& end = octagon[(i + 1) % octagon.size()];
+
+        if (start.X == end.X && start.Z == end.Z)
+            continue;
+
+        edgeStartX[edgeCount] = start.X;
+        edgeStartZ[edgeCount] = start.Z;
+        edgeDirectionX[edgeCount] = end.X - start.X;
+        edgeDirectionZ[edgeCount] = end.Z - start.Z;
+        ++edgeCount;
+    }
+
+    uint32_t i = 0;
+
+    // Without at least a triangle nothing can be inside
+    if (edgeCount >= 3)
+    {
+#ifdef THRIVE_USE_AVX2
+        const auto zero = _mm256_setzero_ps();
+        const auto allSet = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto x = _mm256_loadu_ps(xs.data() + i);
+            const auto z = _mm256_loadu_ps(zs.data() + i);
+
+            auto inside = allSet;
+
+            for (int edge = 0; edge < edgeCount; ++edge)
+            {
+                const auto relativeX = _mm256_sub_ps(x, _mm256_set1_ps(edgeStartX[edge]));
+                const auto relativeZ = _mm256_sub_ps(z, _mm256_set1_ps(edgeStartZ[edge]));
+
+                const auto cross = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(edgeDirectionX[edge]), relativeZ),
+                    _mm256_mul_ps(_mm256_set1_ps(edgeDirectionZ[edge]), relativeX));
+
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(cross, zero, _CMP_GT_OQ));
+            }
+
+            const auto insideMask = _mm256_movemask_ps(inside);
+
+            // Most points are usually inside so this skips the per point checks for whole blocks of them
+            if (insideMask == 0xFF)
+                continue;
+
+            for (uint32_t lane = 0; lane < 8; ++lane)
+            {
+                if ((insideMask & (1 << lane)) == 0)
+                    result.push_back(HullPoint2D{xs[i + lane], zs[i + lane]});
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            bool inside = true;
+
+            for (int edge = 0; edge < edgeCount; ++edge)
+            {
+                const auto cross = edgeDirectionX[edge] * (zs[i] - edgeStartZ[edge]) -
+                    edgeDirectionZ[edge] * (xs[i] - edgeStartX[edge]);
+
+                if (cross <= 0)
+                {
+                    inside = false;
+                    break;
+                }
+            }
+
+            if (!inside)
+                result.push_back(HullPoint2D{xs[i], zs[i]});
+        }
+    }
+    else
+    {
+        for (; i < count; ++i)
+            result.push_back(HullPoint2D{xs[i], zs[i]});
+    }
+}
+
+void ConvexHull2D::MonotoneChain(std::vector<HullPoint2D>& points, std::vector<HullPoint2D>& hull)
+{
+    hull.clear();
+
+    const auto count = points.size();
+
+    if (count < 3)
+        return;
+
+    std::sort(points.begin(), points.end(),
+        [](const HullPoint2D& first, const HullPoint2D& second)
+        { return first.X < second.X || (first.X == second.X && first.Z < second.Z); });
+
+    hull.resize(count * 2);
+    size_t hullSize = 0;
+
+    // Lower hull, points not making a left turn (including collinear and duplicate points) are removed
+    for (size_t i = 0; i < count; ++i)
+    {
+        while (hullSize >= 2 && CrossXZ(hull[hullSize - 2], hull[hullSize - 1], points[i]) <= 0)
+            --hullSize;
+
+        hull[hullSize++] = points[i];
+    }
+
+    // Upper hull
+    const auto lowerSize = hullSize + 1;
+
+    for (size_t i = count - 1; i-- > 0;)
+    {
+        while (hullSize >= lowerSize && CrossXZ(hull[hullSize - 2], hull[hullSize - 1], points[i]) <= 0)
+            --hullSize;
+
+        hull[hullSize++] = points[i];
+    }
+
+    // The last point is the same as the first
+    hull.resize(hullSize - 1);
+}
+
+} // namespace Thrive::Physics
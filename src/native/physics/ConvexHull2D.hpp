@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "interop/CStructures.h"
+
+namespace Thrive::Physics
+{
+
+/// \brief Point on the XZ plane used by the 2D hull calculation
+struct HullPoint2D
+{
+    float X;
+    float Z;
+};
+
+/// \brief Calculates convex hulls of point sets that lie on a plane of constant Y
+///
+/// Used to reduce extruded polygons (like microbe membranes) to just their outline before creating a 3D hull shape.
+/// Before the hull is calculated with the monotone chain algorithm points that are inside the octagon formed by the
+/// extreme points are discarded, which is done with AVX2 when available.
+class ConvexHull2D
+{
+public:
+    ConvexHull2D() = delete;
+
+    /// \brief Checks if all points have the same Y coordinate within the tolerance
+    [[nodiscard]] static bool IsPlanarInY(const JVecF3* points, uint32_t pointCount, float tolerance = 0.0001f);
+
+    /// \brief Calculates the convex hull of points projected on the XZ plane
+    /// \param scale Multiplier applied to the point coordinates
+    /// \param hull Receives the hull in counter-clockwise order (when looking down from +Y) without collinear points
+    /// \returns False if the points don't form a hull with an area (for example when they are all on one line)
+    static bool Compute(const JVecF3* points, uint32_t pointCount, float scale, std::vector<HullPoint2D>& hull);
+
+private:
+    /// \brief Extreme points in 8 directions at 45-degree steps, in counter-clockwise order starting from -Z
+    using Octagon = std::array<HullPoint2D, 8>;
+
+    static void ProjectPoints(
+        const JVecF3* points, uint32_t pointCount, float scale, std::vector<float>& xs, std::vector<float>& zs);
+
+    static Octagon FindExtremePoints(const std::vector<float>& xs, const std::vector<float>& zs);
+
+    /// \brief Collects the points not strictly inside the octagon, as those can't be hull vertices
+    static void CollectPossibleHullPoints(const std::vector<float>& xs, const std::vector<float>& zs,
+        const Octagon& octagon, std::vector<HullPoint2D>& result);
+
+    static void MonotoneChain(std::vector<HullPoint2D>& points, std::vector<HullPoint2D>& hull);
+};
+
+} // namespace Thrive::Physics
@@ -5,6 +5,7 @@
 
 #include "core/Logger.hpp"
 #include "core/Time.hpp"
+#include "core/Tracing.hpp"
 
 // #define ENSURE_NO_COLOUR_OVER_SATURATION
 
@@ -85,6 +86,8 @@ DebugDrawForwarder::DebugDrawForwarder()
 // ------------------------------------ //
 void DebugDrawForwarder::FlushOutput()
 {
+    TRACE_SCOPE("DebugDrawFlush");
+
     const auto startTime = TimingClock::now();
 
     Lock lock(mutex);
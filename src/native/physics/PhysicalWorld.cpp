@@ -1,6 +1,9 @@
 // ------------------------------------ //
 #include "PhysicalWorld.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 
@@ -8,23 +11,35 @@
 #include "Jolt/Core/StreamWrapper.h"
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "Jolt/Physics/Collision/CastResult.h"
+#include "Jolt/Physics/Collision/CollideShape.h"
 #include "Jolt/Physics/Collision/RayCast.h"
+#include "Jolt/Physics/Collision/Shape/SphereShape.h"
+#include "Jolt/Physics/Collision/ShapeCast.h"
 #include "Jolt/Physics/Constraints/SixDOFConstraint.h"
 #include "Jolt/Physics/PhysicsScene.h"
 #include "Jolt/Physics/PhysicsSettings.h"
 #include "Jolt/Physics/PhysicsSystem.h"
 
 #include "core/Math.hpp"
+#include "core/HybridLock.hpp"
 #include "core/Mutex.hpp"
+#include "core/ParallelFor.hpp"
 #include "core/Spinlock.hpp"
 #include "core/TaskSystem.hpp"
 #include "core/Time.hpp"
+#include "core/Tracing.hpp"
+#include "interop/JoltTypeConversions.hpp"
+#include "simulation/FluidCurrents.hpp"
 
+#include "ArrayBodyCollector.hpp"
 #include "ArrayRayCollector.hpp"
+#include "ArrayShapeCollector.hpp"
 #include "BodyActivationListener.hpp"
 #include "BodyControlState.hpp"
 #include "ContactListener.hpp"
 #include "PhysicsBody.hpp"
+#include "PhysicsReplay.hpp"
+#include "ShapeWrapper.hpp"
 #include "StepListener.hpp"
 #include "TrackedConstraint.hpp"
 
@@ -43,6 +58,59 @@ namespace Thrive::Physics
 
 // #define CHECK_ROTATION_PROBLEMS
 
+/// \brief When there are fewer bodies than this with per-step control, the control is applied on the physics thread
+/// without splitting it into background tasks as the task overhead would be more than the gained time
+constexpr size_t BodyControlInlineThreshold = 192;
+
+/// \brief How many bodies are processed by a single task when applying body control in parallel
+constexpr size_t BodyControlChunkSize = 64;
+
+/// \brief How many bodies are processed by a single task when applying the flow field. Each task calculates the flow
+/// velocities of its bodies in blocks of FlowFieldBlockSize.
+constexpr size_t FlowFieldChunkSize = 128;
+
+constexpr size_t FlowFieldBlockSize = 64;
+
+/// \brief Query batches smaller than this are ran directly on the calling thread
+constexpr size_t QueryBatchInlineThreshold = 8;
+
+/// \brief How many queries are processed at once by a single task when running a query batch in parallel
+constexpr size_t QueryBatchChunkSize = 4;
+
+/// \brief How many of the latest updates the step statistics are kept for
+constexpr uint32_t StepStatisticsHistorySize = 64;
+
+/// \brief Checks that a query's result slice fits in the batch result array
+static bool IsQuerySliceValid(const PhysicsQuery& query, int resultCapacity)
+{
+    if (query.MaxResults < 1)
+        return false;
+
+    if (query.ResultOffset < 0 || query.ResultOffset > resultCapacity - query.MaxResults) [[unlikely]]
+    {
+        LOG_ERROR("Physics query result slice doesn't fit in the result array");
+        return false;
+    }
+
+    return true;
+}
+
+/// \brief Activates the bodies whose slot in activations is not invalid with a single call
+static void ActivateMarkedBodies(JPH::BodyInterface& bodyInterface, std::vector<JPH::BodyID>& activations)
+{
+    // Compacted in place as the vector is cleared before it is used again anyway
+    size_t toActivate = 0;
+
+    for (const auto& bodyId : activations)
+    {
+        if (!bodyId.IsInvalid())
+            activations[toActivate++] = bodyId;
+    }
+
+    if (toActivate > 0)
+        bodyInterface.ActivateBodies(activations.data(), static_cast<int>(toActivate));
+}
+
 class PhysicalWorld::Pimpl
 {
 public:
@@ -64,6 +132,12 @@ public:
         activeBodiesWithCollisions.reserve(50);
     }
 
+    /// \returns The active replay recorder or null when not recording
+    [[nodiscard]] PhysicsReplayRecorder* GetReplayRecorder() const noexcept
+    {
+        return replayRecorder.load(std::memory_order_acquire);
+    }
+
     void AddPerStepControlBody(PhysicsBody& body)
     {
         bodiesStepControlLock.Lock();
@@ -94,6 +168,72 @@ public:
         LOG_ERROR("Didn't find body in internal vector of bodies needing operations each step");
     }
 
+    /// \brief Adds a body to be moved by the flow field. bodiesStepControlLock must be held when calling this.
+    void AddFlowFieldBody(PhysicsBody& body)
+    {
+        bodiesInFlowField.emplace_back(&body);
+    }
+
+    /// \brief Removes a body from the flow field. bodiesStepControlLock must be held when calling this.
+    void RemoveFlowFieldBody(PhysicsBody& body)
+    {
+        const auto size = bodiesInFlowField.size();
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (bodiesInFlowField[i].get() != &body)
+                continue;
+
+            // The order doesn't matter so the last body is moved to the removed slot
+            if (i + 1 < size)
+                std::swap(bodiesInFlowField[i], bodiesInFlowField[size - 1]);
+
+            bodiesInFlowField.pop_back();
+            return;
+        }
+
+        LOG_ERROR("Didn't find body in internal vector of bodies in the flow field");
+    }
+
+    [[nodiscard]] bool HasFlowField() const noexcept
+    {
+        return flowCurrents != nullptr || (flowGridWidth > 1 && flowGridHeight > 1);
+    }
+
+    /// \brief Interpolates the flow grid velocity at a position, positions outside the grid have no flow
+    void SampleFlowGrid(float x, float z, float& resultX, float& resultZ) const noexcept
+    {
+        const auto gridX = (x - flowGridOriginX) / flowGridSpacing;
+        const auto gridZ = (z - flowGridOriginZ) / flowGridSpacing;
+
+        if (!(gridX >= 0 && gridZ >= 0 && gridX <= static_cast<float>(flowGridWidth - 1) &&
+                gridZ <= static_cast<float>(flowGridHeight - 1))) [[unlikely]]
+        {
+            resultX = 0;
+            resultZ = 0;
+            return;
+        }
+
+        const auto x0 = std::min(static_cast<int>(gridX), flowGridWidth - 2);
+        const auto z0 = std::min(static_cast<int>(gridZ), flowGridHeight - 2);
+
+        const auto tx = gridX - static_cast<float>(x0);
+        const auto tz = gridZ - static_cast<float>(z0);
+
+        const auto index00 = static_cast<size_t>(x0) * flowGridHeight + z0;
+        const auto index10 = index00 + flowGridHeight;
+
+        const auto interpolate = [tx, tz, index00, index10](const std::vector<float>& values)
+        {
+            const auto first = values[index00] + (values[index00 + 1] - values[index00]) * tz;
+            const auto second = values[index10] + (values[index10 + 1] - values[index10]) * tz;
+            return first + (second - first) * tx;
+        };
+
+        resultX = interpolate(flowGridX);
+        resultZ = interpolate(flowGridZ);
+    }
+
     float AddAndCalculateAverageTime(float duration)
     {
         durationBuffer.push_back(duration);
@@ -178,6 +318,22 @@ public:
         }
     }
 
+    /// \brief Makes currentStepStatistics readable by GetStepStatistics. Only the thread running the physics update
+    /// calls this.
+    void PublishStepStatistics() noexcept
+    {
+        const auto index = stepStatisticsWritten.load(std::memory_order_relaxed);
+
+        // Readers check this after copying entries to detect if an entry was overwritten while they were copying it
+        stepStatisticsWritesStarted.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        currentStepStatistics.UpdateNumber = index + 1;
+        stepStatistics[index % StepStatisticsHistorySize] = currentStepStatistics;
+
+        stepStatisticsWritten.store(index + 1, std::memory_order_release);
+    }
+
     inline void IncrementStepCounter() noexcept
     {
         ++stepCounter;
@@ -200,16 +356,62 @@ public:
 
     std::vector<Ref<PhysicsBody>> bodiesWithPerStepControl;
 
-    Spinlock bodiesStepControlLock;
+    /// \brief Bodies that need activating after body control is applied. Each body in bodiesWithPerStepControl has a
+    /// slot here at the same index which is left as invalid if the body doesn't need activating.
+    std::vector<JPH::BodyID> bodyControlActivations;
+
+    HybridLock bodiesStepControlLock;
+
+    /// \brief Bodies in this world (and not detached) that have a flow response. Protected by bodiesStepControlLock
+    /// like the flow field source below.
+    std::vector<Ref<PhysicsBody>> bodiesInFlowField;
+
+    /// \brief Same as bodyControlActivations but for the bodies in the flow field
+    std::vector<JPH::BodyID> flowFieldActivations;
+
+    /// \brief Source of the flow field velocities. Only one of the currents or the grid is set at once.
+    Ref<Simulation::FluidCurrents> flowCurrents;
+
+    std::vector<float> flowGridX;
+    std::vector<float> flowGridZ;
+    float flowGridOriginX = 0;
+    float flowGridOriginZ = 0;
+    float flowGridSpacing = 1;
+    int flowGridWidth = 0;
+    int flowGridHeight = 0;
+
+    /// \brief Time the flow currents are calculated at, this is allowed to change while physics is running
+    std::atomic<float> flowFieldTime{0};
 
     JPH::Vec3 gravity = JPH::Vec3(0, -9.81f, 0);
 
     std::vector<PhysicsBody*> activeBodiesWithCollisions;
 
-    Spinlock activeBodyWriteLock;
+    HybridLock activeBodyWriteLock;
 
     uint32_t stepCounter = 0;
 
+    /// \brief Signaled when no background physics run is in progress
+    HybridEvent backgroundRunCompleted{true};
+
+    /// \brief When set all operations that affect the simulation are recorded for replaying later. This is read
+    /// from any thread that modifies the world so this is atomic and owned by ownedReplayRecorder.
+    std::atomic<PhysicsReplayRecorder*> replayRecorder{nullptr};
+    std::unique_ptr<PhysicsReplayRecorder> ownedReplayRecorder;
+
+    /// \brief A stopped recorder that other threads may still be writing to. Released when the next physics run
+    /// starts.
+    std::unique_ptr<PhysicsReplayRecorder> retiredReplayRecorder;
+
+    /// \brief Ring of the statistics of the latest updates. This is read without locking, readers instead check
+    /// through the write counters that the entries they copied were not overwritten during the copy.
+    std::array<PhysicsStepStatistics, StepStatisticsHistorySize> stepStatistics{};
+    std::atomic<uint32_t> stepStatisticsWritesStarted{0};
+    std::atomic<uint32_t> stepStatisticsWritten{0};
+
+    /// \brief Statistics of the currently running update, the step listener adds to this during the update
+    PhysicsStepStatistics currentStepStatistics{};
+
 #ifdef JPH_DEBUG_RENDERER
     JPH::BodyManager::DrawSettings bodyDrawSettings;
 
@@ -233,10 +435,7 @@ PhysicalWorld::~PhysicalWorld()
     if (runningBackgroundSimulation)
     {
         LOG_ERROR("World is being destroyed while a background operation is in progress");
-        while (runningBackgroundSimulation)
-        {
-            HYPER_THREAD_YIELD;
-        }
+        WaitForBackgroundRunEnd();
     }
 
     if (bodyCount != 0)
@@ -279,27 +478,18 @@ bool PhysicalWorld::Process(float delta)
         return false;
     }
 
-    nextStepIsFresh = true;
+    pimpl->retiredReplayRecorder.reset();
 
-    elapsedSinceUpdate += delta;
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordProcess(delta);
 
-    const auto singlePhysicsFrame = 1 / physicsFrameRate;
+    nextStepIsFresh = true;
 
-    bool simulatedPhysics = false;
-    float simulatedTime = 0;
+    elapsedSinceUpdate += delta;
 
-    // TODO: limit max steps per frame to avoid massive potential for lag spikes
-    // TODO: alternatively to this it is possible to use a bigger timestep at once but then collision steps and
-    // integration steps should be incremented
-    while (elapsedSinceUpdate > singlePhysicsFrame)
-    {
-        elapsedSinceUpdate -= singlePhysicsFrame;
-        simulatedTime += singlePhysicsFrame;
-        StepPhysics(singlePhysicsFrame);
-        simulatedPhysics = true;
-    }
+    const float simulatedTime = StepPendingPhysics();
 
-    if (!simulatedPhysics)
+    if (simulatedTime <= 0)
         return false;
 
     DrawPhysics(simulatedTime);
@@ -316,6 +506,14 @@ void PhysicalWorld::ProcessInBackground(float delta)
         return;
     }
 
+    pimpl->backgroundRunCompleted.Reset();
+
+    // The game has finished its world modifications for this frame so a stopped recorder is no longer used
+    pimpl->retiredReplayRecorder.reset();
+
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordProcess(delta);
+
     nextStepIsFresh = true;
     backgroundSimulatedTime = 0;
 
@@ -326,6 +524,8 @@ void PhysicalWorld::ProcessInBackground(float delta)
     if (elapsedSinceUpdate < singlePhysicsFrame)
     {
         // We can just early exit if there's nothing to do
+        pimpl->backgroundRunCompleted.Set();
+
         previous = true;
         if (!runningBackgroundSimulation.compare_exchange_strong(previous, false))
         {
@@ -341,12 +541,9 @@ void PhysicalWorld::ProcessInBackground(float delta)
 
 bool PhysicalWorld::WaitForPhysicsToComplete()
 {
-    // For now this never sleep as it is assumed the physics should be done by the time the main thread gets here
-    // or very close to done
-    while (runningBackgroundSimulation)
-    {
-        HYPER_THREAD_YIELD;
-    }
+    // Physics is usually done (or very close to done) by the time the main thread gets here so this only spins a bit
+    // before sleeping
+    WaitForBackgroundRunEnd();
 
     if (nextStepIsFresh)
         return false;
@@ -525,6 +722,9 @@ void PhysicalWorld::DetachBody(PhysicsBody& body)
         return;
     }
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::DetachBody, body.GetId());
+
     auto& bodyInterface = physicsSystem->GetBodyInterface();
 
     OnBodyPreLeaveWorld(body);
@@ -547,6 +747,9 @@ void PhysicalWorld::DestroyBody(const Ref<PhysicsBody>& body)
         return;
     }
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::DestroyBody, body->GetId());
+
     auto& bodyInterface = physicsSystem->GetBodyInterface();
 
     // Special handling for bodies that are detached as part of their destruction logic has already been performed
@@ -574,6 +777,9 @@ void PhysicalWorld::DestroyBody(const Ref<PhysicsBody>& body)
 // ------------------------------------ //
 void PhysicalWorld::SetDamping(JPH::BodyID bodyId, float damping, const float* angularDamping /*= nullptr*/)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordDamping(bodyId, damping, angularDamping);
+
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
     if (!lock.Succeeded()) [[unlikely]]
     {
@@ -629,8 +835,83 @@ void PhysicalWorld::ReadBodyVelocity(
     }
 }
 
+int PhysicalWorld::ReadBodyStatesBatch(PhysicsBody* const* bodies, int count, JVec3* positionsReceiver,
+    JQuat* rotationsReceiver, JVecF3* velocitiesReceiver, JVecF3* angularVelocitiesReceiver,
+    uint8_t* stateFlagsReceiver) const
+{
+    if (bodies == nullptr || count < 1) [[unlikely]]
+        return 0;
+
+    if (runningBackgroundSimulation) [[unlikely]]
+    {
+        LOG_ERROR("Cannot batch read body states while physics is running");
+        return 0;
+    }
+
+    // Physics is not running so there's no one else who could be modifying the bodies, so the locks are skipped.
+    // This is the main point of this method as taking a lock per body and property is pretty expensive.
+    const auto& lockInterface = physicsSystem->GetBodyLockInterfaceNoLock();
+
+    int read = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto* bodyWrapper = bodies[i];
+
+        const JPH::Body* body = nullptr;
+
+        if (bodyWrapper != nullptr) [[likely]]
+            body = lockInterface.TryGetBody(bodyWrapper->GetId());
+
+        if (body == nullptr) [[unlikely]]
+        {
+            if (positionsReceiver != nullptr)
+                positionsReceiver[i] = JVec3{0, 0, 0};
+
+            if (rotationsReceiver != nullptr)
+                rotationsReceiver[i] = QuatIdentity;
+
+            if (velocitiesReceiver != nullptr)
+                velocitiesReceiver[i] = JVecF3{0, 0, 0};
+
+            if (angularVelocitiesReceiver != nullptr)
+                angularVelocitiesReceiver[i] = JVecF3{0, 0, 0};
+
+            if (stateFlagsReceiver != nullptr)
+                stateFlagsReceiver[i] = 0;
+
+            continue;
+        }
+
+        if (positionsReceiver != nullptr)
+            positionsReceiver[i] = DVec3ToCAPI(body->GetPosition());
+
+        if (rotationsReceiver != nullptr)
+            rotationsReceiver[i] = QuatToCAPI(body->GetRotation());
+
+        if (velocitiesReceiver != nullptr)
+            velocitiesReceiver[i] = Vec3ToCAPI(body->GetLinearVelocity());
+
+        if (angularVelocitiesReceiver != nullptr)
+            angularVelocitiesReceiver[i] = Vec3ToCAPI(body->GetAngularVelocity());
+
+        if (stateFlagsReceiver != nullptr)
+        {
+            stateFlagsReceiver[i] =
+                PhysicsBodyStateFlagRead | (body->IsActive() ? PhysicsBodyStateFlagActive : static_cast<uint8_t>(0));
+        }
+
+        ++read;
+    }
+
+    return read;
+}
+
 void PhysicalWorld::GiveImpulse(JPH::BodyID bodyId, JPH::Vec3Arg impulse, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordVectorEvent(ReplayEventType::GiveImpulse, bodyId, impulse, activate);
+
     {
         JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
         if (!lock.Succeeded()) [[unlikely]]
@@ -661,6 +942,9 @@ void PhysicalWorld::GiveImpulse(JPH::BodyID bodyId, JPH::Vec3Arg impulse, bool a
 
 void PhysicalWorld::SetVelocity(JPH::BodyID bodyId, JPH::Vec3Arg velocity, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordVectorEvent(ReplayEventType::SetVelocity, bodyId, velocity, activate);
+
     {
         JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
         if (!lock.Succeeded()) [[unlikely]]
@@ -689,6 +973,9 @@ void PhysicalWorld::SetVelocity(JPH::BodyID bodyId, JPH::Vec3Arg velocity, bool
 
 void PhysicalWorld::SetAngularVelocity(JPH::BodyID bodyId, JPH::Vec3Arg velocity, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordVectorEvent(ReplayEventType::SetAngularVelocity, bodyId, velocity, activate);
+
     {
         JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
         if (!lock.Succeeded()) [[unlikely]]
@@ -717,6 +1004,9 @@ void PhysicalWorld::SetAngularVelocity(JPH::BodyID bodyId, JPH::Vec3Arg velocity
 
 void PhysicalWorld::GiveAngularImpulse(JPH::BodyID bodyId, JPH::Vec3Arg impulse, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordVectorEvent(ReplayEventType::GiveAngularImpulse, bodyId, impulse, activate);
+
     {
         JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
         if (!lock.Succeeded()) [[unlikely]]
@@ -746,6 +1036,12 @@ void PhysicalWorld::GiveAngularImpulse(JPH::BodyID bodyId, JPH::Vec3Arg impulse,
 void PhysicalWorld::SetVelocityAndAngularVelocity(
     JPH::BodyID bodyId, JPH::Vec3Arg velocity, JPH::Vec3Arg angularVelocity, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordVectorEvent(ReplayEventType::SetVelocity, bodyId, velocity, activate);
+        recorder->RecordVectorEvent(ReplayEventType::SetAngularVelocity, bodyId, angularVelocity, activate);
+    }
+
     {
         JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
         if (!lock.Succeeded()) [[unlikely]]
@@ -776,6 +1072,177 @@ void PhysicalWorld::SetVelocityAndAngularVelocity(
     }
 }
 
+int PhysicalWorld::ApplyBodyCommands(const PhysicsBodyCommand* commands, int count)
+{
+    static_assert(sizeof(PhysicsBodyCommand) == 88, "Body command size must match the C# side");
+
+    if (commands == nullptr || count < 1) [[unlikely]]
+        return 0;
+
+    if (runningBackgroundSimulation) [[unlikely]]
+    {
+        LOG_ERROR("Cannot apply body commands while physics is running");
+        return 0;
+    }
+
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyCommands(commands, count);
+
+    // Scratch memory is per thread to allow different threads to apply their own command buffers at the same time
+    // without needing to allocate memory each time
+    thread_local std::vector<std::pair<const PhysicsBody*, int>> commandOrder;
+    thread_local std::vector<JPH::BodyID> bodiesToActivate;
+
+    commandOrder.clear();
+    bodiesToActivate.clear();
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (commands[i].Body == nullptr || commands[i].Type == PhysicsBodyCommandNone) [[unlikely]]
+            continue;
+
+        commandOrder.emplace_back(reinterpret_cast<const PhysicsBody*>(commands[i].Body), i);
+    }
+
+    // Sorting by the pairs groups the commands by body while keeping the submit order within each body
+    std::sort(commandOrder.begin(), commandOrder.end());
+
+    auto& bodyInterface = physicsSystem->GetBodyInterface();
+
+    const auto totalCommands = commandOrder.size();
+    int applied = 0;
+
+    size_t groupStart = 0;
+    while (groupStart < totalCommands)
+    {
+        const auto* bodyWrapper = commandOrder[groupStart].first;
+
+        size_t groupEnd = groupStart + 1;
+        while (groupEnd < totalCommands && commandOrder[groupEnd].first == bodyWrapper)
+            ++groupEnd;
+
+        const auto bodyId = bodyWrapper->GetId();
+
+        bool activate = false;
+        bool forceActivate = false;
+        bool positionChanged = false;
+
+        JPH::RVec3 newPosition = JPH::RVec3::sZero();
+        JPH::Quat newRotation = JPH::Quat::sIdentity();
+
+        {
+            JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
+            if (!lock.Succeeded()) [[unlikely]]
+            {
+                LOG_ERROR("Couldn't lock body for applying body commands");
+                groupStart = groupEnd;
+                continue;
+            }
+
+            JPH::Body& body = lock.GetBody();
+            auto* motionProperties = body.GetMotionProperties();
+
+            for (size_t i = groupStart; i < groupEnd; ++i)
+            {
+                const auto& command = commands[commandOrder[i].second];
+
+                const bool wantsActivation = (command.Flags & PhysicsBodyCommandFlagActivate) != 0;
+
+                switch (command.Type)
+                {
+                    case PhysicsBodyCommandGiveImpulse:
+                        body.AddImpulse(Vec3FromCAPI(command.Vector));
+                        break;
+                    case PhysicsBodyCommandGiveAngularImpulse:
+                        body.AddAngularImpulse(Vec3FromCAPI(command.Vector));
+                        break;
+                    case PhysicsBodyCommandSetVelocity:
+                        body.SetLinearVelocityClamped(Vec3FromCAPI(command.Vector));
+                        break;
+                    case PhysicsBodyCommandSetAngularVelocity:
+                        body.SetAngularVelocityClamped(Vec3FromCAPI(command.Vector));
+                        break;
+                    case PhysicsBodyCommandSetVelocityAndAngularVelocity:
+                        body.SetLinearVelocityClamped(Vec3FromCAPI(command.Vector));
+                        body.SetAngularVelocityClamped(Vec3FromCAPI(command.SecondVector));
+                        break;
+                    case PhysicsBodyCommandSetPosition:
+                        if (!positionChanged)
+                            newRotation = body.GetRotation();
+
+                        newPosition = DVec3FromCAPI(command.Position);
+                        positionChanged = true;
+                        forceActivate |= wantsActivation;
+                        break;
+                    case PhysicsBodyCommandSetPositionAndRotation:
+                        newPosition = DVec3FromCAPI(command.Position);
+                        newRotation = QuatFromCAPI(command.Rotation);
+                        positionChanged = true;
+                        forceActivate |= wantsActivation;
+                        break;
+                    case PhysicsBodyCommandSetLinearDamping:
+                        if (motionProperties == nullptr) [[unlikely]]
+                        {
+                            LOG_ERROR("Cannot set damping on a body without motion properties");
+                            continue;
+                        }
+
+                        motionProperties->SetLinearDamping(command.Value);
+                        break;
+                    case PhysicsBodyCommandSetLinearAndAngularDamping:
+                        if (motionProperties == nullptr) [[unlikely]]
+                        {
+                            LOG_ERROR("Cannot set damping on a body without motion properties");
+                            continue;
+                        }
+
+                        motionProperties->SetLinearDamping(command.Value);
+                        motionProperties->SetAngularDamping(command.SecondValue);
+                        break;
+                    default:
+                        LOG_ERROR("Unknown physics body command type: " + std::to_string(command.Type));
+                        continue;
+                }
+
+                activate |= wantsActivation;
+                ++applied;
+            }
+
+            // Same activation rules as the single operation methods, activate only if the body got enough velocity
+            if (body.IsStatic() || body.IsActive())
+            {
+                activate = false;
+            }
+            else if (activate && !forceActivate)
+            {
+                if (body.GetLinearVelocity().IsNearZero(BodyActivationMovementThreshold) &&
+                    body.GetAngularVelocity().IsNearZero(BodyActivationMovementThreshold))
+                {
+                    activate = false;
+                }
+            }
+        }
+
+        // Position changes need to notify the broadphase which requires going through the body interface which
+        // takes the body lock again
+        if (positionChanged)
+        {
+            bodyInterface.SetPositionAndRotationWhenChanged(
+                bodyId, newPosition, newRotation, JPH::EActivation::DontActivate);
+        }
+
+        if (activate)
+            bodiesToActivate.emplace_back(bodyId);
+
+        groupStart = groupEnd;
+    }
+
+    if (!bodiesToActivate.empty())
+        bodyInterface.ActivateBodies(bodiesToActivate.data(), static_cast<int>(bodiesToActivate.size()));
+
+    return applied;
+}
+
 void PhysicalWorld::SetBodyControl(
     PhysicsBody& bodyWrapper, JPH::Vec3Arg movementImpulse, JPH::Quat targetRotation, float rotationRate)
 {
@@ -808,6 +1275,9 @@ void PhysicalWorld::SetBodyControl(
         pimpl->AddPerStepControlBody(bodyWrapper);
     }
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyControl(bodyWrapper.GetId(), movementImpulse, targetRotation, rotationRate);
+
     state->targetRotation = targetRotation;
     state->movement = movementImpulse;
     state->rotationRate = rotationRate;
@@ -815,14 +1285,54 @@ void PhysicalWorld::SetBodyControl(
 
 void PhysicalWorld::DisableBodyControl(PhysicsBody& bodyWrapper)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::DisableBodyControl, bodyWrapper.GetId());
+
     if (bodyWrapper.DisableBodyControl())
     {
         pimpl->RemovePerStepControlBody(bodyWrapper);
     }
 }
 
+void PhysicalWorld::SetBodyFlowResponse(PhysicsBody& bodyWrapper, float forceMultiplier, float drag)
+{
+    if (drag < 0) [[unlikely]]
+    {
+        LOG_ERROR("Flow drag can't be negative");
+        return;
+    }
+
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordFlowResponse(bodyWrapper.GetId(), forceMultiplier, drag);
+
+    // The flow is applied with this lock held so the response values can't change in the middle of it
+    pimpl->bodiesStepControlLock.Lock();
+
+    const bool wasInFlow = bodyWrapper.HasFlowResponse();
+
+    bodyWrapper.SetFlowResponse(forceMultiplier, drag);
+
+    // Detached bodies are added when they are attached again
+    if (bodyWrapper.IsInSpecificWorld(this) && !bodyWrapper.IsDetached())
+    {
+        if (!wasInFlow && bodyWrapper.HasFlowResponse())
+        {
+            pimpl->AddFlowFieldBody(bodyWrapper);
+        }
+        else if (wasInFlow && !bodyWrapper.HasFlowResponse())
+        {
+            pimpl->RemoveFlowFieldBody(bodyWrapper);
+        }
+    }
+
+    pimpl->bodiesStepControlLock.Unlock();
+}
+
 void PhysicalWorld::SetPosition(JPH::BodyID bodyId, JPH::DVec3Arg position, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordPosition(bodyId, position, nullptr, activate);
+
     physicsSystem->GetBodyInterface().SetPosition(
         bodyId, position, activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
 }
@@ -830,6 +1340,12 @@ void PhysicalWorld::SetPosition(JPH::BodyID bodyId, JPH::DVec3Arg position, bool
 void PhysicalWorld::SetPositionAndRotation(
     JPH::BodyID bodyId, JPH::DVec3Arg position, JPH::QuatArg rotation, bool activate)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        const JPH::Quat recordedRotation = rotation;
+        recorder->RecordPosition(bodyId, position, &recordedRotation, activate);
+    }
+
     if (!activate)
     {
         physicsSystem->GetBodyInterface().SetPositionAndRotationWhenChanged(
@@ -844,6 +1360,9 @@ void PhysicalWorld::SetPositionAndRotation(
 
 void PhysicalWorld::SetBodyAllowSleep(JPH::BodyID bodyId, bool allowSleeping)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::SetAllowSleep, bodyId, allowSleeping);
+
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterface(), bodyId);
     if (!lock.Succeeded()) [[unlikely]]
     {
@@ -855,6 +1374,15 @@ void PhysicalWorld::SetBodyAllowSleep(JPH::BodyID bodyId, bool allowSleeping)
     body.SetAllowSleeping(allowSleeping);
 }
 
+void PhysicalWorld::SetBodyContinuousCollision(JPH::BodyID bodyId, bool enabled)
+{
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::SetContinuousCollision, bodyId, enabled);
+
+    physicsSystem->GetBodyInterface().SetMotionQuality(
+        bodyId, enabled ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete);
+}
+
 bool PhysicalWorld::FixBodyYCoordinateToZero(JPH::BodyID bodyId)
 {
     decltype(std::declval<JPH::Body>().GetPosition()) position;
@@ -889,6 +1417,9 @@ void PhysicalWorld::ChangeBodyShape(PhysicsBody& body, const JPH::RefConst<JPH::
     if (body.IsDetached())
         activate = false;
 
+    if (auto* recorder = pimpl->GetReplayRecorder(); recorder != nullptr && shape != nullptr) [[unlikely]]
+        recorder->RecordShapeChange(body.GetId(), *shape, activate);
+
     // For now this always recalculates mass and inertia
     physicsSystem->GetBodyInterface().SetShape(
         body.GetId(), shape, true, activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
@@ -927,6 +1458,12 @@ void PhysicalWorld::DisableCollisionRecording(PhysicsBody& body)
 
 void PhysicalWorld::AddCollisionIgnore(PhysicsBody& body, const PhysicsBody& ignoredBody, bool skipDuplicates)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordBodyReferenceEvent(ReplayEventType::AddCollisionIgnore, body.GetId(),
+            ignoredBody.GetId().GetIndexAndSequenceNumber(), skipDuplicates);
+    }
+
     body.AddCollisionIgnore(ignoredBody, skipDuplicates);
 
     if (body.MarkCollisionFilterEnabled())
@@ -937,6 +1474,12 @@ void PhysicalWorld::AddCollisionIgnore(PhysicsBody& body, const PhysicsBody& ign
 
 bool PhysicalWorld::RemoveCollisionIgnore(PhysicsBody& body, const PhysicsBody& noLongerIgnoredBody)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordBodyReferenceEvent(ReplayEventType::RemoveCollisionIgnore, body.GetId(),
+            noLongerIgnoredBody.GetId().GetIndexAndSequenceNumber());
+    }
+
     const auto changes = body.RemoveCollisionIgnore(noLongerIgnoredBody);
 
     if (body.MarkCollisionFilterEnabled())
@@ -947,8 +1490,11 @@ bool PhysicalWorld::RemoveCollisionIgnore(PhysicsBody& body, const PhysicsBody&
     return changes;
 }
 
-void PhysicalWorld::SetCollisionIgnores(PhysicsBody& body, PhysicsBody* const& ignoredBodies, int ignoreCount)
+void PhysicalWorld::SetCollisionIgnores(PhysicsBody& body, PhysicsBody* const* ignoredBodies, int ignoreCount)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordCollisionIgnores(body.GetId(), ignoredBodies, ignoreCount);
+
     body.SetCollisionIgnores(ignoredBodies, ignoreCount);
 
     if (body.MarkCollisionFilterEnabled())
@@ -959,6 +1505,12 @@ void PhysicalWorld::SetCollisionIgnores(PhysicsBody& body, PhysicsBody* const& i
 
 void PhysicalWorld::SetSingleCollisionIgnore(PhysicsBody& body, const PhysicsBody& onlyIgnoredBody)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordBodyReferenceEvent(ReplayEventType::SetSingleCollisionIgnore, body.GetId(),
+            onlyIgnoredBody.GetId().GetIndexAndSequenceNumber());
+    }
+
     body.SetSingleCollisionIgnore(onlyIgnoredBody);
 
     if (body.MarkCollisionFilterEnabled())
@@ -969,6 +1521,9 @@ void PhysicalWorld::SetSingleCollisionIgnore(PhysicsBody& body, const PhysicsBod
 
 void PhysicalWorld::ClearCollisionIgnores(PhysicsBody& body)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::ClearCollisionIgnores, body.GetId());
+
     body.ClearCollisionIgnores();
 
     if (body.MarkCollisionFilterDisabled())
@@ -985,6 +1540,11 @@ void PhysicalWorld::SetCollisionDisabledState(PhysicsBody& body, bool disableAll
         return;
     }
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordBodyEvent(ReplayEventType::SetCollisionDisabled, body.GetId(), disableAllCollisions);
+    }
+
     if (disableAllCollisions)
     {
         body.MarkCollisionDisableFlagEnabled();
@@ -999,6 +1559,9 @@ void PhysicalWorld::SetCollisionDisabledState(PhysicsBody& body, bool disableAll
 
 void PhysicalWorld::AddCollisionFilter(PhysicsBody& body, CollisionFilterCallback callback)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyEvent(ReplayEventType::CollisionFilterUsed, body.GetId());
+
     body.SetCollisionFilter(callback);
 
     if (body.MarkCollisionFilterCallbackUsed())
@@ -1085,11 +1648,26 @@ Ref<TrackedConstraint> PhysicalWorld::CreateAxisLockConstraint(PhysicsBody& body
         trackedConstraint->OnRegisteredToWorld(*this);
     }
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordVectorEvent(ReplayEventType::CreateAxisLockConstraint, body.GetId(), axis, lockRotation);
+
     return trackedConstraint;
 }
 
 void PhysicalWorld::DestroyConstraint(TrackedConstraint& constraint)
 {
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        // Constraints don't have IDs so they are identified by their position in the constraints of the first body
+        const auto& constraints = constraint.firstBody->GetConstraints();
+        const auto iter = std::find_if(constraints.begin(), constraints.end(),
+            [&constraint](const Ref<TrackedConstraint>& other) { return other.get() == &constraint; });
+        const auto index = std::distance(constraints.begin(), iter);
+
+        recorder->RecordBodyReferenceEvent(
+            ReplayEventType::DestroyConstraint, constraint.firstBody->GetId(), static_cast<uint32_t>(index));
+    }
+
     // TODO: allow multithreading
     physicsSystem->RemoveConstraint(constraint.GetConstraint().GetPtr());
     constraint.OnDestroyByWorld(*this);
@@ -1157,20 +1735,313 @@ int PhysicalWorld::CastRayGetAllUserData(
     return rayCollector.GetHitCount();
 }
 
-// ------------------------------------ //
-void PhysicalWorld::SetGravity(JPH::Vec3 newGravity)
+int PhysicalWorld::CollideSphere(JPH::RVec3Arg center, float radius, PhysicsRayWithUserData dataReceiver[],
+    int maxHits, const PhysicsBodyQueryFilter* filter)
 {
-    pimpl->gravity = newGravity;
+    if (maxHits < 1 || dataReceiver == nullptr)
+    {
+        LOG_ERROR("Physics body query given no storage space for results");
+        return 0;
+    }
 
-    physicsSystem->SetGravity(pimpl->gravity);
-}
+    ArrayBodyCollector collector{dataReceiver, maxHits, filter, center, physicsSystem->GetBodyLockInterface()};
+    const ObjectLayerMaskFilter layerFilter{filter != nullptr ? filter->LayerMask : 0};
 
-void PhysicalWorld::RemoveGravity()
-{
-    SetGravity(JPH::Vec3(0, 0, 0));
+    // The broadphase works in single precision
+    physicsSystem->GetBroadPhaseQuery().CollideSphere(JPH::Vec3(center), radius, collector, {}, layerFilter);
+
+    return collector.GetHitCount();
 }
 
-// ------------------------------------ //
+int PhysicalWorld::CollideAABox(JPH::RVec3Arg min, JPH::RVec3Arg max, PhysicsRayWithUserData dataReceiver[],
+    int maxHits, const PhysicsBodyQueryFilter* filter)
+{
+    if (maxHits < 1 || dataReceiver == nullptr)
+    {
+        LOG_ERROR("Physics body query given no storage space for results");
+        return 0;
+    }
+
+    const JPH::RVec3 center = (min + max) * 0.5;
+
+    ArrayBodyCollector collector{dataReceiver, maxHits, filter, center, physicsSystem->GetBodyLockInterface()};
+    const ObjectLayerMaskFilter layerFilter{filter != nullptr ? filter->LayerMask : 0};
+
+    physicsSystem->GetBroadPhaseQuery().CollideAABox(
+        JPH::AABox(JPH::Vec3(min), JPH::Vec3(max)), collector, {}, layerFilter);
+
+    return collector.GetHitCount();
+}
+
+int PhysicalWorld::FindNearestBodies(JPH::RVec3Arg position, float maxDistance,
+    PhysicsRayWithUserData dataReceiver[], int maxCount, const PhysicsBodyQueryFilter* filter)
+{
+    if (maxCount < 1 || dataReceiver == nullptr)
+    {
+        LOG_ERROR("Physics body query given no storage space for results");
+        return 0;
+    }
+
+    // All bodies in range are collected and then the nearest are picked from them
+    ArrayBodyCollector collector{
+        dataReceiver, maxCount, filter, position, physicsSystem->GetBodyLockInterface(), true, maxDistance};
+    const ObjectLayerMaskFilter layerFilter{filter != nullptr ? filter->LayerMask : 0};
+
+    physicsSystem->GetBroadPhaseQuery().CollideSphere(JPH::Vec3(position), maxDistance, collector, {}, layerFilter);
+
+    return collector.WriteNearest();
+}
+
+template<class ResultType>
+int PhysicalWorld::RunQueryBatchInChunks(
+    PhysicsQuery queries[], int queryCount, ResultType results[], int resultCapacity)
+{
+    if (queryCount < 1)
+        return 0;
+
+    if (queries == nullptr || results == nullptr || resultCapacity < 0)
+    {
+        LOG_ERROR("Physics query batch given no queries or storage space for results");
+        return 0;
+    }
+
+    const auto count = static_cast<size_t>(queryCount);
+
+    // Each query has its own result slice so the queries don't need to synchronize with each other
+    const auto runRange = [this, queries, results, resultCapacity](size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            queries[i].ResultCount = RunQuery(queries[i], results, resultCapacity);
+        }
+    };
+
+    if (count < QueryBatchInlineThreshold)
+    {
+        runRange(0, count);
+    }
+    else
+    {
+        ParallelFor(count, QueryBatchChunkSize, runRange);
+    }
+
+    int total = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += queries[i].ResultCount;
+    }
+
+    return total;
+}
+
+int PhysicalWorld::RunQueryBatch(
+    PhysicsQuery queries[], int queryCount, PhysicsRayWithUserData results[], int resultCapacity)
+{
+    return RunQueryBatchInChunks(queries, queryCount, results, resultCapacity);
+}
+
+int PhysicalWorld::CastShape(const JPH::Shape& shape, JPH::RVec3Arg start, JPH::QuatArg rotation,
+    JPH::Vec3Arg directionAndLength, PhysicsShapeCastHit dataReceiver[], int maxHits,
+    const PhysicsBodyQueryFilter* filter) const
+{
+    if (maxHits < 1 || dataReceiver == nullptr)
+    {
+        LOG_ERROR("Physics shape cast given no storage space for results");
+        return 0;
+    }
+
+    const auto shapeCast = JPH::RShapeCast::sFromWorldTransform(
+        &shape, JPH::Vec3::sReplicate(1), JPH::RMat44::sRotationTranslation(rotation, start), directionAndLength);
+
+    // Bodies that the shape already overlaps at the start are reported with their deepest point so that the contact
+    // info is usable for them as well
+    JPH::ShapeCastSettings settings;
+    settings.mReturnDeepestPoint = true;
+
+    const QueryBodyFilter bodyFilter{filter};
+    const ObjectLayerMaskFilter layerFilter{filter != nullptr ? filter->LayerMask : 0};
+
+    ArrayShapeCastHitCollector collector{dataReceiver, maxHits, start, physicsSystem->GetBodyLockInterface()};
+
+    physicsSystem->GetNarrowPhaseQuery().CastShape(shapeCast, settings, start, collector, {}, layerFilter, bodyFilter);
+
+    collector.SortHits();
+    return collector.GetHitCount();
+}
+
+int PhysicalWorld::CastShapeBatch(
+    PhysicsQuery queries[], int queryCount, PhysicsShapeCastHit results[], int resultCapacity)
+{
+    return RunQueryBatchInChunks(queries, queryCount, results, resultCapacity);
+}
+
+int PhysicalWorld::RunQuery(const PhysicsQuery& query, PhysicsRayWithUserData results[], int resultCapacity) const
+{
+    if (!IsQuerySliceValid(query, resultCapacity))
+        return 0;
+
+    auto* dataReceiver = results + query.ResultOffset;
+
+    const auto position = DVec3FromCAPI(query.Position);
+
+    const QueryBodyFilter bodyFilter{&query.Filter};
+    const ObjectLayerMaskFilter layerFilter{query.Filter.LayerMask};
+
+    const auto& narrowPhase = physicsSystem->GetNarrowPhaseQuery();
+    const auto& lockInterface = physicsSystem->GetBodyLockInterface();
+
+    switch (query.Type)
+    {
+        case PhysicsQueryTypeRay:
+        {
+            ArrayRayCollector collector{dataReceiver, query.MaxResults, lockInterface};
+
+            narrowPhase.CastRay(JPH::RRayCast{position, Vec3FromCAPI(query.Vector)}, JPH::RayCastSettings(),
+                collector, {}, layerFilter, bodyFilter);
+
+            return collector.GetHitCount();
+        }
+        case PhysicsQueryTypeSphereOverlap:
+        {
+            if (query.Radius <= 0) [[unlikely]]
+            {
+                LOG_ERROR("Physics sphere overlap query needs a positive radius");
+                return 0;
+            }
+
+            // Temporary shape only used by this query
+            JPH::SphereShape sphere{query.Radius};
+            sphere.SetEmbedded();
+
+            ArrayOverlapCollector collector{dataReceiver, query.MaxResults, lockInterface};
+
+            narrowPhase.CollideShape(&sphere, JPH::Vec3::sReplicate(1), JPH::RMat44::sTranslation(position),
+                JPH::CollideShapeSettings(), position, collector, {}, layerFilter, bodyFilter);
+
+            return collector.GetHitCount();
+        }
+        case PhysicsQueryTypeShapeCast:
+        {
+            if (query.Shape == nullptr) [[unlikely]]
+            {
+                LOG_ERROR("Physics shape cast query is missing the shape");
+                return 0;
+            }
+
+            const auto& shape = reinterpret_cast<const ShapeWrapper*>(query.Shape)->GetShape();
+
+            const auto shapeCast = JPH::RShapeCast::sFromWorldTransform(shape.GetPtr(), JPH::Vec3::sReplicate(1),
+                JPH::RMat44::sRotationTranslation(QuatFromCAPI(query.Rotation), position),
+                Vec3FromCAPI(query.Vector));
+
+            ArrayShapeCastCollector collector{dataReceiver, query.MaxResults, lockInterface};
+
+            narrowPhase.CastShape(
+                shapeCast, JPH::ShapeCastSettings(), position, collector, {}, layerFilter, bodyFilter);
+
+            return collector.GetHitCount();
+        }
+    }
+
+    LOG_ERROR("Unknown physics query type: " + std::to_string(query.Type));
+    return 0;
+}
+
+int PhysicalWorld::RunQuery(const PhysicsQuery& query, PhysicsShapeCastHit results[], int resultCapacity) const
+{
+    if (!IsQuerySliceValid(query, resultCapacity))
+        return 0;
+
+    if (query.Type != PhysicsQueryTypeShapeCast || query.Shape == nullptr) [[unlikely]]
+    {
+        LOG_ERROR("Shape cast batch can only contain shape cast queries with a shape");
+        return 0;
+    }
+
+    return CastShape(*reinterpret_cast<const ShapeWrapper*>(query.Shape)->GetShape(), DVec3FromCAPI(query.Position),
+        QuatFromCAPI(query.Rotation), Vec3FromCAPI(query.Vector), results + query.ResultOffset, query.MaxResults,
+        &query.Filter);
+}
+
+// ------------------------------------ //
+void PhysicalWorld::SetGravity(JPH::Vec3 newGravity)
+{
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordGravity(newGravity);
+
+    pimpl->gravity = newGravity;
+
+    physicsSystem->SetGravity(pimpl->gravity);
+}
+
+void PhysicalWorld::RemoveGravity()
+{
+    SetGravity(JPH::Vec3(0, 0, 0));
+}
+
+// ------------------------------------ //
+void PhysicalWorld::SetFlowFieldCurrents(Simulation::FluidCurrents* currents)
+{
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordWorldEvent(ReplayEventType::SetFlowFieldCurrents, 0, currents != nullptr);
+
+    pimpl->bodiesStepControlLock.Lock();
+
+    pimpl->flowCurrents = currents;
+
+    pimpl->flowGridWidth = 0;
+    pimpl->flowGridHeight = 0;
+
+    pimpl->bodiesStepControlLock.Unlock();
+}
+
+void PhysicalWorld::SetFlowFieldGrid(
+    const float* velocities, int width, int height, float originX, float originZ, float spacing)
+{
+    if (velocities == nullptr || width < 2 || height < 2 || spacing <= 0)
+    {
+        velocities = nullptr;
+        width = 0;
+        height = 0;
+    }
+
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordFlowFieldGrid(velocities, width, height, originX, originZ, spacing);
+
+    pimpl->bodiesStepControlLock.Lock();
+
+    pimpl->flowCurrents = nullptr;
+
+    const auto count = static_cast<size_t>(width) * height;
+
+    pimpl->flowGridX.resize(count);
+    pimpl->flowGridZ.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        pimpl->flowGridX[i] = velocities[i * 2];
+        pimpl->flowGridZ[i] = velocities[i * 2 + 1];
+    }
+
+    pimpl->flowGridOriginX = originX;
+    pimpl->flowGridOriginZ = originZ;
+    pimpl->flowGridSpacing = spacing;
+    pimpl->flowGridWidth = width;
+    pimpl->flowGridHeight = height;
+
+    pimpl->bodiesStepControlLock.Unlock();
+}
+
+void PhysicalWorld::SetFlowFieldTime(float time)
+{
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordWorldEvent(ReplayEventType::SetFlowFieldTime, time);
+
+    pimpl->flowFieldTime.store(time, std::memory_order_relaxed);
+}
+
+// ------------------------------------ //
 bool PhysicalWorld::DumpSystemState(std::string_view path)
 {
     // Dump a Jolt snapshot to the path
@@ -1182,6 +2053,12 @@ bool PhysicalWorld::DumpSystemState(std::string_view path)
 
     if (stream.is_open()) [[likely]]
     {
+        // Gravity is not part of the scene so it is written in a header before it
+        wrapper.Write(DUMP_WORLD_HEADER_MAGIC);
+        wrapper.Write(pimpl->gravity.GetX());
+        wrapper.Write(pimpl->gravity.GetY());
+        wrapper.Write(pimpl->gravity.GetZ());
+
         scene->SaveBinaryState(wrapper, true, true);
     }
     else
@@ -1190,27 +2067,437 @@ bool PhysicalWorld::DumpSystemState(std::string_view path)
         return false;
     }
 
+    // The scene doesn't contain body IDs so they are written after it (the scene has the bodies in the same order as
+    // this gets them). Restoring the IDs is needed for replays to find the right bodies.
+    JPH::BodyIDVector bodyIds;
+    physicsSystem->GetBodies(bodyIds);
+
+    wrapper.Write(DUMP_BODY_ID_MAGIC);
+    wrapper.Write(static_cast<uint32_t>(bodyIds.size()));
+
+    for (const auto bodyId : bodyIds)
+    {
+        wrapper.Write(bodyId.GetIndexAndSequenceNumber());
+    }
+
+    // Per step body control and flow response are not Jolt state so they need to be saved separately for replays
+    // that start in the middle of a game to not diverge
+    std::vector<std::pair<uint32_t, const PhysicsBody*>> bodiesWithState;
+
+    for (uint32_t i = 0; i < bodyIds.size(); ++i)
+    {
+        JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), bodyIds[i]);
+
+        if (!lock.Succeeded()) [[unlikely]]
+            continue;
+
+        const auto* bodyWrapper = PhysicsBody::FromJoltBody(&lock.GetBody());
+
+        if (bodyWrapper == nullptr)
+            continue;
+
+        if (bodyWrapper->GetBodyControlState() != nullptr || bodyWrapper->HasFlowResponse())
+            bodiesWithState.emplace_back(i, bodyWrapper);
+    }
+
+    wrapper.Write(DUMP_BODY_STATE_MAGIC);
+    wrapper.Write(static_cast<uint32_t>(bodiesWithState.size()));
+
+    for (const auto& [index, bodyWrapper] : bodiesWithState)
+    {
+        const auto* control = bodyWrapper->GetBodyControlState();
+
+        uint8_t flags = 0;
+
+        if (control != nullptr)
+            flags |= DUMP_BODY_STATE_CONTROL;
+
+        if (bodyWrapper->HasFlowResponse())
+            flags |= DUMP_BODY_STATE_FLOW;
+
+        wrapper.Write(index);
+        wrapper.Write(flags);
+
+        if (control != nullptr)
+        {
+            wrapper.Write(control->movement.GetX());
+            wrapper.Write(control->movement.GetY());
+            wrapper.Write(control->movement.GetZ());
+            wrapper.Write(control->targetRotation.GetX());
+            wrapper.Write(control->targetRotation.GetY());
+            wrapper.Write(control->targetRotation.GetZ());
+            wrapper.Write(control->targetRotation.GetW());
+            wrapper.Write(control->rotationRate);
+        }
+
+        if (flags & DUMP_BODY_STATE_FLOW)
+        {
+            wrapper.Write(bodyWrapper->GetFlowForceMultiplier());
+            wrapper.Write(bodyWrapper->GetFlowDrag());
+        }
+    }
+
     return true;
 }
 
+bool PhysicalWorld::LoadSystemState(std::string_view path, std::vector<Ref<PhysicsBody>>& restoredBodies)
+{
+    if (runningBackgroundSimulation) [[unlikely]]
+    {
+        LOG_ERROR("Cannot load physics state while physics is running");
+        return false;
+    }
+
+    std::ifstream stream(path.data(), std::ifstream::in | std::ifstream::binary);
+
+    if (!stream.is_open()) [[unlikely]]
+    {
+        LOG_ERROR(std::string("Can't read physics state dump at: ") + path.data());
+        return false;
+    }
+
+    // Older dumps don't have the world header and start directly with the scene
+    uint32_t headerMagic = 0;
+    stream.read(reinterpret_cast<char*>(&headerMagic), sizeof(headerMagic));
+
+    if (stream.good() && headerMagic == DUMP_WORLD_HEADER_MAGIC)
+    {
+        float gravity[3] = {};
+        stream.read(reinterpret_cast<char*>(gravity), sizeof(gravity));
+
+        if (!stream.good()) [[unlikely]]
+        {
+            LOG_ERROR("Physics state dump world header is truncated");
+            return false;
+        }
+
+        SetGravity(JPH::Vec3(gravity[0], gravity[1], gravity[2]));
+    }
+    else
+    {
+        stream.clear();
+        stream.seekg(0);
+    }
+
+    JPH::StreamInWrapper wrapper(stream);
+
+    const auto result = JPH::PhysicsScene::sRestoreFromBinaryState(wrapper);
+
+    if (result.HasError()) [[unlikely]]
+    {
+        LOG_ERROR("Failed to read physics state dump: " + std::string(result.GetError().c_str()));
+        return false;
+    }
+
+    const auto& scene = result.Get();
+    const auto& bodySettings = scene->GetBodies();
+
+    // Older dumps don't have the body IDs after the scene, in which case new IDs are used
+    std::vector<uint32_t> bodyIds;
+
+    // The body state after the IDs can only be read if the IDs were read fully
+    bool canReadBodyState = false;
+
+    uint32_t magic = 0;
+    wrapper.Read(magic);
+
+    if (!wrapper.IsEOF() && !wrapper.IsFailed() && magic == DUMP_BODY_ID_MAGIC)
+    {
+        uint32_t count = 0;
+        wrapper.Read(count);
+
+        if (count == bodySettings.size())
+        {
+            bodyIds.resize(count);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                wrapper.Read(bodyIds[i]);
+            }
+
+            canReadBodyState = true;
+        }
+        else
+        {
+            LOG_WARNING("Physics state dump has wrong number of body IDs, bodies will get new IDs");
+        }
+    }
+
+    if (!scene->GetConstraints().empty())
+        LOG_WARNING("Physics state dump has constraints which are not restored");
+
+    auto& bodyInterface = physicsSystem->GetBodyInterface();
+
+    restoredBodies.reserve(restoredBodies.size() + bodySettings.size());
+
+    // Bodies by their index in the dump for restoring the body state
+    std::vector<PhysicsBody*> bodiesByIndex(bodySettings.size(), nullptr);
+
+    for (size_t i = 0; i < bodySettings.size(); ++i)
+    {
+        const auto& settings = bodySettings[i];
+
+        auto body = CreateBodyFromSettings(settings, bodyIds.empty() ? JPH::BodyID() : JPH::BodyID(bodyIds[i]));
+
+        if (body == nullptr) [[unlikely]]
+            continue;
+
+        bodyInterface.AddBody(body->GetId(),
+            settings.mMotionType == JPH::EMotionType::Static ? JPH::EActivation::DontActivate :
+                                                               JPH::EActivation::Activate);
+        OnPostBodyAdded(*body);
+
+        bodiesByIndex[i] = body.get();
+        restoredBodies.emplace_back(std::move(body));
+    }
+
+    if (canReadBodyState)
+        LoadDumpedBodyState(wrapper, bodiesByIndex);
+
+    return true;
+}
+
+void PhysicalWorld::LoadDumpedBodyState(JPH::StreamIn& stream, const std::vector<PhysicsBody*>& bodiesByIndex)
+{
+    // Dumps made before the body state was added end after the IDs
+    uint32_t magic = 0;
+    stream.Read(magic);
+
+    if (stream.IsEOF() || stream.IsFailed() || magic != DUMP_BODY_STATE_MAGIC)
+        return;
+
+    uint32_t count = 0;
+    stream.Read(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t index = 0;
+        uint8_t flags = 0;
+
+        stream.Read(index);
+        stream.Read(flags);
+
+        float movement[3] = {};
+        float rotation[4] = {};
+        float rotationRate = 1;
+        float flowForceMultiplier = 0;
+        float flowDrag = 0;
+
+        if (flags & DUMP_BODY_STATE_CONTROL)
+        {
+            for (auto& value : movement)
+                stream.Read(value);
+
+            for (auto& value : rotation)
+                stream.Read(value);
+
+            stream.Read(rotationRate);
+        }
+
+        if (flags & DUMP_BODY_STATE_FLOW)
+        {
+            stream.Read(flowForceMultiplier);
+            stream.Read(flowDrag);
+        }
+
+        if (stream.IsEOF() || stream.IsFailed()) [[unlikely]]
+        {
+            LOG_WARNING("Physics state dump body state is truncated");
+            return;
+        }
+
+        if (index >= bodiesByIndex.size() || bodiesByIndex[index] == nullptr) [[unlikely]]
+            continue;
+
+        auto& body = *bodiesByIndex[index];
+
+        if (flags & DUMP_BODY_STATE_CONTROL)
+        {
+            SetBodyControl(body, JPH::Vec3(movement[0], movement[1], movement[2]),
+                JPH::Quat(rotation[0], rotation[1], rotation[2], rotation[3]), rotationRate);
+        }
+
+        if (flags & DUMP_BODY_STATE_FLOW)
+            SetBodyFlowResponse(body, flowForceMultiplier, flowDrag);
+    }
+}
+
+bool PhysicalWorld::StartReplayRecording(std::string_view dumpPath, std::string_view recordingPath)
+{
+    if (pimpl->ownedReplayRecorder) [[unlikely]]
+    {
+        LOG_ERROR("Physics replay recording is already in progress");
+        return false;
+    }
+
+    // The dump needs to be of a state between steps
+    if (runningBackgroundSimulation)
+        WaitForPhysicsToComplete();
+
+    if (!DumpSystemState(dumpPath))
+        return false;
+
+    pimpl->ownedReplayRecorder = PhysicsReplayRecorder::Create(recordingPath);
+
+    if (!pimpl->ownedReplayRecorder) [[unlikely]]
+        return false;
+
+    // Published only once fully created as other threads may start recording events right away
+    pimpl->replayRecorder.store(pimpl->ownedReplayRecorder.get(), std::memory_order_release);
+
+    LOG_INFO(std::string("Started physics replay recording to: ") + recordingPath.data());
+    return true;
+}
+
+void PhysicalWorld::StopReplayRecording()
+{
+    if (!pimpl->ownedReplayRecorder)
+        return;
+
+    if (runningBackgroundSimulation)
+        WaitForPhysicsToComplete();
+
+    pimpl->replayRecorder.store(nullptr, std::memory_order_release);
+
+    // Threads that loaded the recorder just before it was cleared may still be writing to it, so it is only
+    // released when the next physics run starts
+    pimpl->retiredReplayRecorder = std::move(pimpl->ownedReplayRecorder);
+    LOG_INFO("Stopped physics replay recording");
+}
+
 // ------------------------------------ //
 void PhysicalWorld::StepAllPhysicsStepsInBackground()
+{
+    backgroundSimulatedTime += StepPendingPhysics();
+
+    pimpl->backgroundRunCompleted.Set();
+
+    // This must be the last access to this object as the waiting thread may destroy the world right after this
+    runningBackgroundSimulation = false;
+}
+
+void PhysicalWorld::WaitForBackgroundRunEnd()
+{
+    pimpl->backgroundRunCompleted.Wait();
+
+    // The event is set just before the running flag is cleared, so this only needs to spin for a moment. This makes
+    // sure the background thread no longer touches the event when this returns.
+    while (runningBackgroundSimulation)
+    {
+        HYPER_THREAD_YIELD;
+    }
+}
+
+void PhysicalWorld::SetSteppingPolicy(int maxSteps, bool mergeExcess, int mergedStepLimit)
+{
+    if (maxSteps < 0 || mergedStepLimit < 1)
+    {
+        LOG_ERROR("Invalid physics stepping policy parameters");
+        return;
+    }
+
+    maxStepsPerProcess.store(maxSteps, std::memory_order_relaxed);
+    mergeExcessSteps.store(mergeExcess, std::memory_order_relaxed);
+    maxMergedSteps.store(mergedStepLimit, std::memory_order_relaxed);
+}
+
+int PhysicalWorld::GetStepStatistics(PhysicsStepStatistics receiver[], int maxCount) const noexcept
+{
+    if (maxCount < 1)
+        return 0;
+
+    while (true)
+    {
+        const auto written = pimpl->stepStatisticsWritten.load(std::memory_order_acquire);
+        const auto count = std::min({written, static_cast<uint32_t>(maxCount), StepStatisticsHistorySize});
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            receiver[i] = pimpl->stepStatistics[(written - 1 - i) % StepStatisticsHistorySize];
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // If the physics thread started writing over any of the copied entries, the copy may be partial and needs to
+        // be redone
+        const auto started = pimpl->stepStatisticsWritesStarted.load(std::memory_order_relaxed);
+
+        if (started - written + count <= StepStatisticsHistorySize) [[likely]]
+            return static_cast<int>(count);
+    }
+}
+
+void PhysicalWorld::SetContactStatisticsEnabled(bool enabled) noexcept
+{
+    contactListener->SetCollectStatistics(enabled);
+}
+
+float PhysicalWorld::StepPendingPhysics()
 {
     const auto singlePhysicsFrame = 1 / physicsFrameRate;
 
+    // The policy is read once so that a concurrent change doesn't apply halfway through
+    const int maxSteps = maxStepsPerProcess.load(std::memory_order_relaxed);
+    const bool mergeExcess = mergeExcessSteps.load(std::memory_order_relaxed);
+    const int mergedStepLimit = maxMergedSteps.load(std::memory_order_relaxed);
+
+    float simulatedTime = 0;
+    int steps = 0;
+
     while (elapsedSinceUpdate > singlePhysicsFrame)
     {
+        if (maxSteps > 0 && steps + 1 >= maxSteps) [[unlikely]]
+        {
+            // Last allowed step, which can take in more time if allowed to merge steps
+            int mergedFrames = 1;
+
+            if (mergeExcess)
+            {
+                mergedFrames =
+                    std::clamp(static_cast<int>(elapsedSinceUpdate / singlePhysicsFrame), 1, mergedStepLimit);
+            }
+
+            const float stepTime = singlePhysicsFrame * static_cast<float>(mergedFrames);
+
+            elapsedSinceUpdate -= stepTime;
+            simulatedTime += stepTime;
+
+            // Collision steps are increased to keep the collision detection accuracy the same as with normal steps
+            StepPhysics(stepTime, collisionStepsPerUpdate * mergedFrames);
+
+            // Anything still remaining (except the part of time not yet enough for a full step) is dropped
+            if (elapsedSinceUpdate > singlePhysicsFrame)
+            {
+                const float dropped = std::floor(elapsedSinceUpdate / singlePhysicsFrame) * singlePhysicsFrame;
+
+                elapsedSinceUpdate -= dropped;
+
+                // Only the physics thread writes this so a separate load and store is fine (atomic float fetch_add
+                // is not yet supported by all the used standard libraries)
+                droppedPhysicsTime.store(
+                    droppedPhysicsTime.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+            }
+
+            break;
+        }
+
         elapsedSinceUpdate -= singlePhysicsFrame;
-        backgroundSimulatedTime += singlePhysicsFrame;
-        StepPhysics(singlePhysicsFrame);
+        simulatedTime += singlePhysicsFrame;
+        StepPhysics(singlePhysicsFrame, collisionStepsPerUpdate);
+        ++steps;
     }
 
-    runningBackgroundSimulation = false;
+    return simulatedTime;
 }
 
 // ------------------------------------ //
-void PhysicalWorld::StepPhysics(float time)
+void PhysicalWorld::StepPhysics(float time, int collisionSteps)
 {
+    TRACE_SCOPE("PhysicsUpdate");
+
+    auto& statistics = pimpl->currentStepStatistics;
+    statistics = PhysicsStepStatistics{};
+
     if (changesToBodies) [[unlikely]]
     {
         if (simulationsToNextOptimization <= 0)
@@ -1230,7 +2517,14 @@ void PhysicalWorld::StepPhysics(float time)
             simulationsToNextOptimization = 0;
 
             // Time to optimize
+            TRACE_SCOPE("OptimizeBroadPhase");
+
+            const auto optimizeStart = TimingClock::now();
+
             physicsSystem->OptimizeBroadPhase();
+
+            statistics.BroadPhaseOptimizationTime =
+                std::chrono::duration_cast<SecondDuration>(TimingClock::now() - optimizeStart).count();
         }
     }
 
@@ -1243,7 +2537,11 @@ void PhysicalWorld::StepPhysics(float time)
     // TODO: ensure that our custom task system is not (much) slower than the Jolt inbuilt one
     auto& jobExecutor = TaskSystem::Get();
 
-    const auto result = physicsSystem->Update(time, collisionStepsPerUpdate, tempAllocator.get(), &jobExecutor);
+    jobExecutor.BeginLatencyCriticalWork();
+
+    const auto result = physicsSystem->Update(time, collisionSteps, tempAllocator.get(), &jobExecutor);
+
+    jobExecutor.EndLatencyCriticalWork();
 
     nextStepIsFresh = false;
 
@@ -1269,6 +2567,22 @@ void PhysicalWorld::StepPhysics(float time)
     latestPhysicsTime = elapsed;
 
     averagePhysicsTime = pimpl->AddAndCalculateAverageTime(elapsed);
+
+    const auto contactStatistics = contactListener->TakeStatistics();
+
+    statistics.JoltUpdateTime = elapsed;
+    statistics.ContactCallbackTime = contactStatistics.CallbackTime;
+    statistics.SimulatedTime = time;
+    statistics.CollisionSteps = collisionSteps;
+    statistics.Bodies = bodyCount;
+    statistics.ActiveBodies = static_cast<int32_t>(physicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody));
+    statistics.BodyPairsValidated = contactStatistics.BodyPairsValidated;
+    statistics.ContactsAdded = contactStatistics.ContactsAdded;
+    statistics.ContactsPersisted = contactStatistics.ContactsPersisted;
+    statistics.ContactsRemoved = contactStatistics.ContactsRemoved;
+    statistics.RecordedCollisionOverflows = contactStatistics.RecordedCollisionOverflows;
+
+    pimpl->PublishStepStatistics();
 }
 
 void PhysicalWorld::ReportBodyWithActiveCollisions(PhysicsBody& body)
@@ -1285,26 +2599,37 @@ void PhysicalWorld::PerformPhysicsStepOperations(float delta)
     // Collision setup
     contactListener->ReportStepNumber(pimpl->stepCounter, !nextStepIsFresh);
 
+    auto& statistics = pimpl->currentStepStatistics;
+
     if (nextStepIsFresh)
+    {
+        TRACE_SCOPE("ClearCollisionRecords");
+
+        const auto clearStart = TimingClock::now();
+
         pimpl->HandleExpiringBodyCollisions();
 
+        statistics.CollisionRecordClearTime +=
+            std::chrono::duration_cast<SecondDuration>(TimingClock::now() - clearStart).count();
+    }
+
     // Apply per-step physics body state
+    TRACE_SCOPE("BodyControl");
+
+    const auto controlStart = TimingClock::now();
 
     // This is locked just for safety, but it should be the case that no physics modify operations should be allowed
     // once physics runs have started
     pimpl->bodiesStepControlLock.Lock();
 
-    // TODO: multithreading if there's a ton of bodies using this
-    for (const auto& bodyPtr : pimpl->bodiesWithPerStepControl)
-    {
-        auto& body = *bodyPtr;
+    ApplyAllBodyControl(delta);
 
-        if (body.GetBodyControlState() != nullptr) [[likely]]
-            ApplyBodyControl(body, delta);
-    }
+    ApplyFlowField(delta);
 
     pimpl->bodiesStepControlLock.Unlock();
 
+    statistics.BodyControlTime += std::chrono::duration_cast<SecondDuration>(TimingClock::now() - controlStart).count();
+
     // Enable for some extreme checking of collision write data indices
     // pimpl->DebugCheckActiveCollisions();
 }
@@ -1331,16 +2656,36 @@ Ref<PhysicsBody> PhysicalWorld::CreateBody(const JPH::Shape& shape, JPH::EMotion
 
     creationSettings.mAllowedDOFs = allowedDegreesOfFreedom;
 
-    const auto body = physicsSystem->GetBodyInterface().CreateBody(creationSettings);
+    return CreateBodyFromSettings(creationSettings, JPH::BodyID());
+}
+
+Ref<PhysicsBody> PhysicalWorld::CreateBodyFromSettings(
+    const JPH::BodyCreationSettings& creationSettings, JPH::BodyID requestedId)
+{
+    auto& bodyInterface = physicsSystem->GetBodyInterface();
+
+    const auto body = requestedId.IsInvalid() ? bodyInterface.CreateBody(creationSettings) :
+                                                bodyInterface.CreateBodyWithID(requestedId, creationSettings);
 
     if (body == nullptr) [[unlikely]]
     {
-        LOG_ERROR("Ran out of physics bodies");
+        if (requestedId.IsInvalid())
+        {
+            LOG_ERROR("Ran out of physics bodies");
+        }
+        else
+        {
+            LOG_ERROR("Cannot create physics body with ID that is already in use");
+        }
+
         return nullptr;
     }
 
     changesToBodies = true;
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+        recorder->RecordBodyCreated(creationSettings, body->GetID());
+
 #ifdef USE_OBJECT_POOLS
     return ConstructFromGlobalPool<PhysicsBody>(body, body->GetID());
 #else
@@ -1382,11 +2727,25 @@ void PhysicalWorld::OnPostBodyAdded(PhysicsBody& body)
 {
     body.MarkUsedInWorld(this);
 
+    if (auto* recorder = pimpl->GetReplayRecorder()) [[unlikely]]
+    {
+        recorder->RecordBodyEvent(
+            ReplayEventType::AddBody, body.GetId(), physicsSystem->GetBodyInterface().IsActive(body.GetId()));
+    }
+
     // Add an extra reference to the body to keep it from being deleted while in this world
     // TODO: does detached body also need to keep an extra reference?
     body.AddRef();
     ++bodyCount;
 
+    // Bodies keep their flow response while detached
+    if (body.HasFlowResponse())
+    {
+        pimpl->bodiesStepControlLock.Lock();
+        pimpl->AddFlowFieldBody(body);
+        pimpl->bodiesStepControlLock.Unlock();
+    }
+
 #ifndef NDEBUG
     JPH::BodyLockRead lock(physicsSystem->GetBodyLockInterface(), body.GetId());
     if (!lock.Succeeded()) [[unlikely]]
@@ -1414,6 +2773,13 @@ void PhysicalWorld::OnBodyPreLeaveWorld(PhysicsBody& body)
 
     if (body.GetBodyControlState() != nullptr)
         DisableBodyControl(body);
+
+    if (body.HasFlowResponse())
+    {
+        pimpl->bodiesStepControlLock.Lock();
+        pimpl->RemoveFlowFieldBody(body);
+        pimpl->bodiesStepControlLock.Unlock();
+    }
 }
 
 void PhysicalWorld::OnPostBodyLeaveWorld(PhysicsBody& body)
@@ -1440,7 +2806,149 @@ void PhysicalWorld::UpdateBodyUserPointer(const PhysicsBody& body)
 }
 
 // ------------------------------------ //
-void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
+void PhysicalWorld::ApplyAllBodyControl(float delta)
+{
+    const auto count = pimpl->bodiesWithPerStepControl.size();
+
+    if (count < 1)
+        return;
+
+    auto& activations = pimpl->bodyControlActivations;
+    activations.clear();
+    activations.resize(count);
+
+    // Each body has its own slot in the activations so no synchronization is needed for writing them
+    const auto applyRange = [this, delta, &activations](size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            auto& body = *pimpl->bodiesWithPerStepControl[i];
+
+            if (body.GetBodyControlState() != nullptr && ApplyBodyControl(body, delta)) [[likely]]
+                activations[i] = body.GetId();
+        }
+    };
+
+    if (count < BodyControlInlineThreshold)
+    {
+        applyRange(0, count);
+    }
+    else
+    {
+        ParallelFor(count, BodyControlChunkSize, applyRange);
+    }
+
+    // Activate all bodies that need it at once
+    ActivateMarkedBodies(physicsSystem->GetBodyInterfaceNoLock(), activations);
+}
+
+void PhysicalWorld::ApplyFlowField(float delta)
+{
+    const auto count = pimpl->bodiesInFlowField.size();
+
+    if (count < 1 || !pimpl->HasFlowField())
+        return;
+
+    TRACE_SCOPE("FlowField");
+
+    // All bodies use the same time even if the time is changed while this runs
+    const auto time = pimpl->flowFieldTime.load(std::memory_order_relaxed);
+
+    auto& activations = pimpl->flowFieldActivations;
+    activations.clear();
+    activations.resize(count);
+
+    ParallelFor(count, FlowFieldChunkSize,
+        [this, delta, time](size_t start, size_t end) { ApplyFlowFieldRange(start, end, delta, time); });
+
+    ActivateMarkedBodies(physicsSystem->GetBodyInterfaceNoLock(), activations);
+}
+
+void PhysicalWorld::ApplyFlowFieldRange(size_t start, size_t end, float delta, float time)
+{
+    float positionsX[FlowFieldBlockSize];
+    float positionsZ[FlowFieldBlockSize];
+    float flowX[FlowFieldBlockSize];
+    float flowZ[FlowFieldBlockSize];
+    JPH::Body* bodies[FlowFieldBlockSize];
+    size_t bodyIndices[FlowFieldBlockSize];
+
+    // This is called by the step listener, so all bodies are already locked. Each body is only in one range so
+    // the bodies can be modified without further synchronization.
+    const auto& lockInterface = physicsSystem->GetBodyLockInterfaceNoLock();
+
+    const auto* currents = pimpl->flowCurrents.get();
+
+    for (size_t blockStart = start; blockStart < end; blockStart += FlowFieldBlockSize)
+    {
+        const auto blockEnd = std::min(blockStart + FlowFieldBlockSize, end);
+
+        size_t blockCount = 0;
+
+        for (auto i = blockStart; i < blockEnd; ++i)
+        {
+            auto* body = lockInterface.TryGetBody(pimpl->bodiesInFlowField[i]->GetId());
+
+            // Static bodies have no motion properties, and a body not in the broadphase would indicate a bug in
+            // body handling elsewhere
+            if (body == nullptr || !body->IsDynamic() || !body->IsInBroadPhase()) [[unlikely]]
+                continue;
+
+            const auto position = body->GetPosition();
+
+            bodies[blockCount] = body;
+            bodyIndices[blockCount] = i;
+            positionsX[blockCount] = static_cast<float>(position.GetX());
+            positionsZ[blockCount] = static_cast<float>(position.GetZ());
+            ++blockCount;
+        }
+
+        if (currents != nullptr)
+        {
+            currents->CalculateVelocitiesAtTime(time, positionsX, positionsZ, blockCount, flowX, flowZ);
+        }
+        else
+        {
+            for (size_t i = 0; i < blockCount; ++i)
+                pimpl->SampleFlowGrid(positionsX[i], positionsZ[i], flowX[i], flowZ[i]);
+        }
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            auto& body = *bodies[i];
+            const auto& bodyWrapper = *pimpl->bodiesInFlowField[bodyIndices[i]];
+
+            // The flow force is scaled by the step length so that the total pushing done per second doesn't depend on
+            // how many steps (or collision sub-steps) are ran
+            float impulseX = flowX[i] * bodyWrapper.GetFlowForceMultiplier() * delta;
+            float impulseZ = flowZ[i] * bodyWrapper.GetFlowForceMultiplier() * delta;
+
+            const auto drag = bodyWrapper.GetFlowDrag();
+            const auto inverseMass = body.GetMotionProperties()->GetInverseMass();
+
+            if (drag > 0 && inverseMass > 0)
+            {
+                // Clamped so that big steps can't overshoot the flow velocity
+                const auto fraction = std::min(drag * delta, 1.0f) / inverseMass;
+                const auto velocity = body.GetLinearVelocity();
+
+                impulseX += (flowX[i] - velocity.GetX()) * fraction;
+                impulseZ += (flowZ[i] - velocity.GetZ()) * fraction;
+            }
+
+            if (impulseX * impulseX + impulseZ * impulseZ < 0.000001f)
+                continue;
+
+            body.AddImpulse(JPH::Vec3(impulseX, 0, impulseZ));
+
+            // Same as body control, bodies are woken up to not let them accumulate the flow impulse while sleeping
+            if (!body.IsActive())
+                pimpl->flowFieldActivations[bodyIndices[i]] = body.GetID();
+        }
+    }
+}
+
+bool PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
 {
     // Normalize delta to 60Hz update rate to make gameplay logic not depend on the physics framerate
     float normalizedDelta = delta / (1 / 60.0f);
@@ -1449,13 +2957,13 @@ void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
     const auto bodyId = bodyWrapper.GetId();
 
     // This method is called by the step listener meaning that all bodies are already locked so this needs to be used
-    // like this. The call to activate probably needs to be protected with a lock if body control is applied in the
-    // future by multiple threads.
+    // like this. This can be called from multiple threads at once (but only once per body) so activation is not
+    // done here but returned to the caller to do all at once.
     JPH::BodyLockWrite lock(physicsSystem->GetBodyLockInterfaceNoLock(), bodyId);
     if (!lock.Succeeded()) [[unlikely]]
     {
         LOG_ERROR("Couldn't lock body for applying body control");
-        return;
+        return false;
     }
 
     JPH::Body& body = lock.GetBody();
@@ -1464,9 +2972,11 @@ void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
     if (!body.IsInBroadPhase())
     {
         LOG_ERROR("Body not in broadphase used in body control");
-        return;
+        return false;
     }
 
+    bool needsActivation = false;
+
     if (controlState->movement.LengthSq() > 0.000001f)
     {
         body.AddImpulse(controlState->movement * normalizedDelta);
@@ -1475,7 +2985,7 @@ void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
         // shoot off at high velocity when touched
         if (!body.IsActive())
         {
-            physicsSystem->GetBodyInterfaceNoLock().ActivateBody(bodyId);
+            needsActivation = true;
         }
     }
 
@@ -1493,7 +3003,7 @@ void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
 
         physicsSystem->GetBodyInterfaceNoLock().SetRotation(
             bodyId, JPH::Quat::sIdentity(), JPH::EActivation::DontActivate);
-        return;
+        return needsActivation;
     }
 #endif
 
@@ -1514,6 +3024,8 @@ void PhysicalWorld::ApplyBodyControl(PhysicsBody& bodyWrapper, float delta)
     body.SetAngularVelocityClamped(axis * (angle / controlState->rotationRate * normalizedDelta));
 
     // TODO: should enough applied angular velocity also wake up the body?
+
+    return needsActivation;
 }
 
 #pragma clang diagnostic push
@@ -1,13 +1,16 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "Jolt/Core/Reference.h"
 #include "Jolt/Physics/Body/AllowedDOFs.h"
 #include "Jolt/Physics/Body/MotionType.h"
 
 #include "core/ForwardDefinitions.hpp"
+#include "interop/CStructures.h"
 
 #include "Layers.hpp"
 #include "PhysicsCollision.hpp"
@@ -17,8 +20,10 @@ namespace JPH
 {
 class PhysicsSystem;
 class TempAllocator;
+class BodyCreationSettings;
 class BodyID;
 class Shape;
+class StreamIn;
 
 constexpr EAllowedDOFs AllRotationAllowed = EAllowedDOFs::RotationX | EAllowedDOFs::RotationY | EAllowedDOFs::RotationZ;
 } // namespace JPH
@@ -30,6 +35,7 @@ namespace Thrive::Physics
 constexpr float BodyActivationMovementThreshold = 0.01f;
 
 class PhysicsBody;
+class PhysicsReplayPlayer;
 class StepListener;
 
 /// \brief Main handling class of the physics simulation
@@ -39,6 +45,7 @@ class StepListener;
 class PhysicalWorld
 {
     friend StepListener;
+    friend PhysicsReplayPlayer;
 
     // Pimpl-idiom class for hiding some properties to reduce needed headers and size of this class
     class Pimpl;
@@ -54,6 +61,12 @@ public:
     /// \brief Processes as many physics steps as needed in the background
     ///
     /// Note that WaitForPhysicsToCompete must be called after this to ensure that the physics has finished
+    ///
+    /// The game starts the background run at the end of a logic update and only waits for it right before the next
+    /// update, so physics already overlaps with the frame logic and rendering in between. Running the game systems
+    /// themselves at the same time as physics (with the game reading a double buffered state) is not done as many
+    /// systems read the collision recording arrays and modify bodies directly, which is only safe while physics is
+    /// not running.
     void ProcessInBackground(float delta);
 
     /// \brief Waits for ProcessInBackground started run to finish. This must be called before other world operations
@@ -97,6 +110,17 @@ public:
     void ReadBodyTransform(JPH::BodyID bodyId, JPH::RVec3& positionReceiver, JPH::Quat& rotationReceiver) const;
     void ReadBodyVelocity(JPH::BodyID bodyId, JPH::Vec3& velocityReceiver, JPH::Vec3& angularVelocityReceiver) const;
 
+    /// \brief Reads the state of multiple bodies at once into caller owned arrays (one element per body)
+    ///
+    /// This uses the no-lock body interface so this may only be called while physics is not running (i.e. not
+    /// between ProcessInBackground and WaitForPhysicsToComplete). Any of the receiver arrays may be null to skip
+    /// reading that property. Bodies that are null or not in the world get zeroed out data and no state flags (see
+    /// PhysicsBodyStateFlagRead and PhysicsBodyStateFlagActive).
+    /// \returns The number of bodies that were successfully read
+    int ReadBodyStatesBatch(PhysicsBody* const* bodies, int count, JVec3* positionsReceiver,
+        JQuat* rotationsReceiver, JVecF3* velocitiesReceiver, JVecF3* angularVelocitiesReceiver,
+        uint8_t* stateFlagsReceiver) const;
+
     // The activate parameters make the methods activate the body automatically if it has a bit of velocity on it
 
     void GiveImpulse(JPH::BodyID bodyId, JPH::Vec3Arg impulse, bool activate);
@@ -108,6 +132,15 @@ public:
     void SetVelocityAndAngularVelocity(
         JPH::BodyID bodyId, JPH::Vec3Arg velocity, JPH::Vec3Arg angularVelocity, bool activate);
 
+    /// \brief Applies a buffer of body modifications at once
+    ///
+    /// Commands are grouped by the target body so that each body is locked only once (position changes need a
+    /// separate operation) and all needed body activations are done with a single call at the end. Commands
+    /// targeting the same body are applied in the order they are in the buffer. This is thread safe as long as
+    /// physics is not running.
+    /// \returns The number of applied commands
+    int ApplyBodyCommands(const PhysicsBodyCommand* commands, int count);
+
     /// \brief Enables (or updates settings) for a body to have per step movement control
     ///
     /// This is thread safe as long as no two same bodies get this called at the same time
@@ -123,6 +156,10 @@ public:
 
     void SetBodyAllowSleep(JPH::BodyID bodyId, bool allowSleeping);
 
+    /// \brief Switches a body to use continuous collision detection (linear cast motion quality), which stops fast
+    /// moving bodies from going through other bodies at the cost of some performance
+    void SetBodyContinuousCollision(JPH::BodyID bodyId, bool enabled);
+
     /// \brief Ensures body's Y coordinate is 0, if not moves it so that it is 0
     /// \returns True if the body's position changed, false if no fix was needed
     bool FixBodyYCoordinateToZero(JPH::BodyID bodyId);
@@ -153,7 +190,7 @@ public:
     /// \param ignoredBodies list of bodies to ignore (should be a pointer to array of references)
     /// \param ignoreCount specifies the length of the ignoredBodies array, note that instead of passing an array of
     /// length 0 calling ClearCollisionIgnores is preferred
-    void SetCollisionIgnores(PhysicsBody& body, PhysicsBody* const& ignoredBodies, int ignoreCount);
+    void SetCollisionIgnores(PhysicsBody& body, PhysicsBody* const* ignoredBodies, int ignoreCount);
 
     /// \brief More efficient variant of clearing all ignores and setting just one
     void SetSingleCollisionIgnore(PhysicsBody& body, const PhysicsBody& onlyIgnoredBody);
@@ -181,6 +218,36 @@ public:
     void SetGravity(JPH::Vec3 newGravity);
     void RemoveGravity();
 
+    // ------------------------------------ //
+    // Flow field
+
+    /// \brief Sets fluid currents as the ambient flow that pushes the bodies that have a flow response set
+    ///
+    /// The currents are calculated at the time set with SetFlowFieldTime. The grid and time of the currents object
+    /// are not used, so the currents can be updated while physics is running. Replaces any set flow grid, null
+    /// disables the flow field.
+    void SetFlowFieldCurrents(Simulation::FluidCurrents* currents);
+
+    /// \brief Sets a flow velocity grid to use instead of fluid currents
+    ///
+    /// The velocities are given as x, z pairs for a grid of width * height samples where sample (i, j) is at
+    /// (originX + i * spacing, originZ + j * spacing) and has the index i * height + j. Velocities between the samples
+    /// are interpolated and bodies outside the grid are not affected. Replaces any set currents, an empty grid
+    /// disables the flow field.
+    void SetFlowFieldGrid(const float* velocities, int width, int height, float originX, float originZ,
+        float spacing);
+
+    /// \brief Sets the time fluid currents are calculated at. Can be called while physics is running.
+    void SetFlowFieldTime(float time);
+
+    /// \brief Sets how a body reacts to the flow field
+    ///
+    /// Each physics step the body gets an impulse of the flow velocity multiplied by forceMultiplier and the step
+    /// delta. Drag additionally moves the body's velocity on the XZ plane towards the flow velocity by the fraction
+    /// drag * delta. Setting both to 0 stops the flow from affecting the body. The response is kept while a body is
+    /// detached.
+    void SetBodyFlowResponse(PhysicsBody& bodyWrapper, float forceMultiplier, float drag);
+
     // ------------------------------------ //
     // Misc
 
@@ -197,6 +264,41 @@ public:
     int CastRayGetAllUserData(
         JPH::RVec3 start, JPH::Vec3 endOffset, PhysicsRayWithUserData dataReceiver[], int maxHits);
 
+    /// \brief Finds bodies whose bounding boxes overlap a sphere. Only the broadphase is used so this doesn't check the
+    /// exact body shapes, but is much faster than looping through all bodies.
+    /// \param filter Optional filter for the found bodies
+    /// \returns The number of found bodies written to dataReceiver. The hit fraction of the results is the distance
+    /// from the sphere center to the body position.
+    int CollideSphere(JPH::RVec3Arg center, float radius, PhysicsRayWithUserData dataReceiver[], int maxHits,
+        const PhysicsBodyQueryFilter* filter);
+
+    /// \brief Variant of CollideSphere for an axis aligned box. The hit fraction is the distance from the box center.
+    int CollideAABox(JPH::RVec3Arg min, JPH::RVec3Arg max, PhysicsRayWithUserData dataReceiver[], int maxHits,
+        const PhysicsBodyQueryFilter* filter);
+
+    /// \brief Finds up to maxCount bodies that have their position closest to the given position
+    /// \returns The number of found bodies written to dataReceiver sorted by the distance (which is in the hit fraction
+    /// field)
+    int FindNearestBodies(JPH::RVec3Arg position, float maxDistance, PhysicsRayWithUserData dataReceiver[],
+        int maxCount, const PhysicsBodyQueryFilter* filter);
+
+    /// \brief Runs a batch of narrowphase queries, splitting them into background tasks when there are a lot of them.
+    /// Returns only once all queries are done.
+    /// \param queries The queries to run, the result count of each one is set after running it
+    /// \param results Shared result array that the queries write their results to (each to its own slice)
+    /// \returns The total number of results written
+    int RunQueryBatch(PhysicsQuery queries[], int queryCount, PhysicsRayWithUserData results[], int resultCapacity);
+
+    /// \brief Moves a shape from start along directionAndLength and finds the bodies it hits. Meant for things like
+    /// fast projectiles that would otherwise pass through bodies between physics steps.
+    /// \returns The number of hits written to dataReceiver. When there are more hits than fit, the closest ones are
+    /// kept. Hits are sorted by their fraction.
+    int CastShape(const JPH::Shape& shape, JPH::RVec3Arg start, JPH::QuatArg rotation, JPH::Vec3Arg directionAndLength,
+        PhysicsShapeCastHit dataReceiver[], int maxHits, const PhysicsBodyQueryFilter* filter) const;
+
+    /// \brief Batched variant of CastShape, works like RunQueryBatch but only supports shape cast queries
+    int CastShapeBatch(PhysicsQuery queries[], int queryCount, PhysicsShapeCastHit results[], int resultCapacity);
+
     [[nodiscard]] inline float GetLatestPhysicsTime() const
     {
         return latestPhysicsTime;
@@ -207,8 +309,49 @@ public:
         return averagePhysicsTime;
     }
 
+    /// \brief Copies the statistics of the latest physics updates, newest first. Can be called from any thread.
+    /// \returns The number of entries written to receiver
+    int GetStepStatistics(PhysicsStepStatistics receiver[], int maxCount) const noexcept;
+
+    /// \brief Enables counting and timing of contact listener callbacks in the step statistics. This has a small cost
+    /// for each contact so this is off by default.
+    void SetContactStatisticsEnabled(bool enabled) noexcept;
+
+    /// \brief Total amount of simulation time in seconds that has been skipped due to the stepping policy not allowing
+    /// enough steps to catch up. Can be called from any thread.
+    [[nodiscard]] inline float GetDroppedPhysicsTime() const noexcept
+    {
+        return droppedPhysicsTime.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Configures how many steps are allowed to be ran when a lot of time has accumulated (for example after a
+    /// lag spike)
+    /// \param maxSteps Max physics steps per process call, 0 means unlimited
+    /// \param mergeExcess When true the excess time is simulated as a single longer last step (with proportionally
+    /// more collision steps) instead of just dropping the time
+    /// \param mergedStepLimit How many normal length steps can be merged into the last step at most
+    ///
+    /// This is safe to call while physics is running, the new policy is used starting from the next process call
+    void SetSteppingPolicy(int maxSteps, bool mergeExcess, int mergedStepLimit);
+
+    /// \brief Writes the state of all bodies to a file. The file can be loaded with LoadSystemState or by the replay
+    /// tool to debug the physics state offline.
     bool DumpSystemState(std::string_view path);
 
+    /// \brief Restores bodies from a DumpSystemState file into this world (which should have no bodies in it yet)
+    ///
+    /// Bodies get the same IDs they had when dumped (if the dump has that info). Constraints are not restored.
+    /// \param restoredBodies Receives the created bodies, the caller is responsible for destroying them
+    bool LoadSystemState(std::string_view path, std::vector<Ref<PhysicsBody>>& restoredBodies);
+
+    /// \brief Dumps the current state to dumpPath and then starts recording all simulation affecting operations to
+    /// recordingPath. Together these allow replaying the following frames with PhysicsReplayPlayer.
+    bool StartReplayRecording(std::string_view dumpPath, std::string_view recordingPath);
+
+    /// \brief Stops a recording started with StartReplayRecording. The file is finished when the next physics run
+    /// starts as other threads may still be recording an operation when this is called.
+    void StopReplayRecording();
+
     inline void SetDebugLevel(int level) noexcept
     {
         debugDrawLevel = level;
@@ -233,12 +376,24 @@ private:
     /// \brief Steps away all pending time. Needs to be ran in a background thread
     void StepAllPhysicsStepsInBackground();
 
-    void StepPhysics(float time);
+    /// \brief Blocks until the running background physics run ends (if any), sleeps the thread for long waits
+    void WaitForBackgroundRunEnd();
+
+    /// \brief Runs as many steps as the accumulated time and the stepping policy dictate
+    /// \returns The amount of time simulated
+    float StepPendingPhysics();
+
+    void StepPhysics(float time, int collisionSteps);
 
     Ref<PhysicsBody> CreateBody(const JPH::Shape& shape, JPH::EMotionType motionType, JPH::ObjectLayer layer,
         JPH::RVec3Arg position, JPH::Quat rotation = JPH::Quat::sIdentity(),
         JPH::EAllowedDOFs allowedDegreesOfFreedom = JPH::EAllowedDOFs::All, bool isSensor = false);
 
+    /// \brief Creates a body (not added to the world) from full settings
+    /// \param requestedId If valid the body is created with this exact ID, used when restoring a saved state
+    Ref<PhysicsBody> CreateBodyFromSettings(
+        const JPH::BodyCreationSettings& creationSettings, JPH::BodyID requestedId);
+
     /// \brief Called after body has been created
     Ref<PhysicsBody> OnBodyCreated(Ref<PhysicsBody>&& body, bool addToWorld);
 
@@ -252,9 +407,35 @@ private:
     /// various features
     void UpdateBodyUserPointer(const PhysicsBody& body);
 
+    /// \brief Restores the body control and flow response state written by DumpSystemState after the body IDs
+    void LoadDumpedBodyState(JPH::StreamIn& stream, const std::vector<PhysicsBody*>& bodiesByIndex);
+
+    /// \brief Applies body control to all bodies that have it enabled, splits the work into background tasks if there
+    /// are a lot of bodies
+    void ApplyAllBodyControl(float delta);
+
+    /// \brief Applies the flow field to all bodies that have a flow response, in parallel chunks when there are
+    /// enough bodies
+    void ApplyFlowField(float delta);
+
+    /// \brief Applies the flow field to a range of the bodies in the flow. Can be called from multiple threads at
+    /// once for different ranges.
+    void ApplyFlowFieldRange(size_t start, size_t end, float delta, float time);
+
     /// \brief Applies physics body control operations
     /// \param delta Is the physics step delta
-    void ApplyBodyControl(PhysicsBody& bodyWrapper, float delta);
+    /// \returns True if the body needs to be activated
+    bool ApplyBodyControl(PhysicsBody& bodyWrapper, float delta);
+
+    /// \brief Runs a single query of a query batch. Can be called from multiple threads at once.
+    /// \returns The number of results written to the query's slice of results
+    int RunQuery(const PhysicsQuery& query, PhysicsRayWithUserData results[], int resultCapacity) const;
+
+    int RunQuery(const PhysicsQuery& query, PhysicsShapeCastHit results[], int resultCapacity) const;
+
+    /// \brief Runs a query batch with either result type, splitting it into background tasks when large enough
+    template<class ResultType>
+    int RunQueryBatchInChunks(PhysicsQuery queries[], int queryCount, ResultType results[], int resultCapacity);
 
     void DrawPhysics(float delta);
 
@@ -269,6 +450,9 @@ private:
 
     float backgroundSimulatedTime = 0;
 
+    /// \brief Written by the physics thread while the main thread may be reading it
+    std::atomic<float> droppedPhysicsTime{0};
+
     /// \brief Debug draw level (0 is disabled)
     ///
     /// 1 is just bodies
@@ -293,6 +477,17 @@ private:
     float physicsFrameRate = 60;
     int collisionStepsPerUpdate = 1;
 
+    // The stepping policy is atomic as it can be changed while a background physics run is reading it
+
+    /// \brief Max number of steps per process call to avoid a lag spike causing a spiral of more and more steps
+    std::atomic<int> maxStepsPerProcess{4};
+
+    /// \brief If true the last allowed step in a process call simulates all of the excess time (up to a limit) as one
+    /// longer step
+    std::atomic<bool> mergeExcessSteps{false};
+
+    std::atomic<int> maxMergedSteps{4};
+
     int simulationsBetweenBroadPhaseOptimization = 67;
 
     /// When running multiple physics steps with a single call to the simulation update methods this is used to not
@@ -136,7 +136,7 @@ public:
     bool AddCollisionIgnore(const PhysicsBody& ignoredBody, bool skipDuplicates) noexcept;
     bool RemoveCollisionIgnore(const PhysicsBody& noLongerIgnored) noexcept;
 
-    void SetCollisionIgnores(PhysicsBody* const& ignoredBodies, int ignoreCount) noexcept;
+    void SetCollisionIgnores(PhysicsBody* const* ignoredBodies, int ignoreCount) noexcept;
     void SetSingleCollisionIgnore(const PhysicsBody& ignoredBody) noexcept;
 
     void ClearCollisionIgnores() noexcept;
@@ -201,6 +201,22 @@ public:
         return bodyControlStateIfActive.get();
     }
 
+    /// \brief True when this body is pushed by the flow field of the world it is in
+    [[nodiscard]] inline bool HasFlowResponse() const noexcept
+    {
+        return flowForceMultiplier != 0 || flowDrag != 0;
+    }
+
+    [[nodiscard]] inline float GetFlowForceMultiplier() const noexcept
+    {
+        return flowForceMultiplier;
+    }
+
+    [[nodiscard]] inline float GetFlowDrag() const noexcept
+    {
+        return flowDrag;
+    }
+
     // ------------------------------------ //
     // User pointer flags
 
@@ -385,6 +401,12 @@ protected:
     bool EnableBodyControlIfNotAlready() noexcept;
     bool DisableBodyControl() noexcept;
 
+    inline void SetFlowResponse(float forceMultiplier, float drag) noexcept
+    {
+        flowForceMultiplier = forceMultiplier;
+        flowDrag = drag;
+    }
+
     void MarkUsedInWorld(PhysicalWorld* containedInWorld) noexcept;
     void MarkRemovedFromWorld() noexcept;
 
@@ -637,6 +659,10 @@ private:
 
     int maxCollisionsToRecord = 0;
 
+    /// How strongly the flow field velocity pushes this body (and how fast this body is dragged along with the flow)
+    float flowForceMultiplier = 0;
+    float flowDrag = 0;
+
 #ifdef LOCK_FREE_COLLISION_RECORDING
     /// A pointer to this is passed out for users of the collision recording array
     std::atomic<int32_t> activeRecordedCollisionCount{0};
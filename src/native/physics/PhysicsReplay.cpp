@@ -0,0 +1,713 @@
+// ------------------------------------ //
+#include "PhysicsReplay.hpp"
+
+#include <algorithm>
+
+#include "Jolt/Physics/Body/Body.h"
+#include "Jolt/Physics/Body/BodyInterface.h"
+#include "Jolt/Physics/PhysicsSystem.h"
+
+#include "core/Logger.hpp"
+#include "simulation/FluidCurrents.hpp"
+
+#include "PhysicalWorld.hpp"
+#include "PhysicsBody.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Physics
+{
+
+std::unique_ptr<PhysicsReplayRecorder> PhysicsReplayRecorder::Create(std::string_view path)
+{
+    std::ofstream file(path.data(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+    if (!file.is_open()) [[unlikely]]
+    {
+        LOG_ERROR(std::string("Can't open physics replay recording file for writing at: ") + path.data());
+        return nullptr;
+    }
+
+    return std::unique_ptr<PhysicsReplayRecorder>(new PhysicsReplayRecorder(std::move(file)));
+}
+
+PhysicsReplayRecorder::PhysicsReplayRecorder(std::ofstream&& outputFile) :
+    file(std::move(outputFile)), stream(file)
+{
+    stream.Write(REPLAY_FILE_MAGIC);
+    stream.Write(REPLAY_FILE_VERSION);
+}
+
+PhysicsReplayRecorder::~PhysicsReplayRecorder()
+{
+    Lock lock(writeMutex);
+
+    ReplayEvent end;
+    end.Type = ReplayEventType::EndOfRecording;
+    WriteEvent(end);
+
+    file.flush();
+}
+
+void PhysicsReplayRecorder::RecordProcess(float delta)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::Process;
+    event.Value = delta;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+
+    // Flushed once per frame so that a recording leading up to a crash is not lost
+    file.flush();
+}
+
+void PhysicsReplayRecorder::RecordBodyCreated(const JPH::BodyCreationSettings& settings, JPH::BodyID bodyId)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::CreateBody;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+    settings.SaveWithChildren(stream, &shapeMap, &materialMap, &groupFilterMap);
+}
+
+void PhysicsReplayRecorder::RecordBodyEvent(ReplayEventType type, JPH::BodyID bodyId, bool flag /*= false*/)
+{
+    ReplayEvent event;
+    event.Type = type;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Flag = flag;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordVectorEvent(
+    ReplayEventType type, JPH::BodyID bodyId, JPH::Vec3Arg vector, bool activate)
+{
+    ReplayEvent event;
+    event.Type = type;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Flag = activate;
+    vector.StoreFloat3(reinterpret_cast<JPH::Float3*>(event.Vector));
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordPosition(
+    JPH::BodyID bodyId, JPH::DVec3Arg position, const JPH::Quat* rotation, bool activate)
+{
+    ReplayEvent event;
+    event.Type = rotation != nullptr ? ReplayEventType::SetPositionAndRotation : ReplayEventType::SetPosition;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Flag = activate;
+
+    event.Position[0] = position.GetX();
+    event.Position[1] = position.GetY();
+    event.Position[2] = position.GetZ();
+
+    if (rotation != nullptr)
+        rotation->GetXYZW().StoreFloat4(reinterpret_cast<JPH::Float4*>(event.Rotation));
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordBodyControl(
+    JPH::BodyID bodyId, JPH::Vec3Arg movement, JPH::QuatArg rotation, float rotationRate)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetBodyControl;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Value = rotationRate;
+
+    movement.StoreFloat3(reinterpret_cast<JPH::Float3*>(event.Vector));
+    rotation.GetXYZW().StoreFloat4(reinterpret_cast<JPH::Float4*>(event.Rotation));
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordShapeChange(JPH::BodyID bodyId, const JPH::Shape& shape, bool activate)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::ChangeShape;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Flag = activate;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+    shape.SaveWithChildren(stream, shapeMap, materialMap);
+}
+
+void PhysicsReplayRecorder::RecordBodyCommands(const PhysicsBodyCommand* commands, int count)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::BodyCommands;
+    event.Count = static_cast<uint32_t>(count);
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto command = commands[i];
+
+        uint32_t bodyId = JPH::BodyID::cInvalidBodyID;
+
+        if (command.Body != nullptr)
+            bodyId = reinterpret_cast<const PhysicsBody*>(command.Body)->GetId().GetIndexAndSequenceNumber();
+
+        // Pointers are meaningless in the replay so they are not written
+        command.Body = nullptr;
+
+        stream.Write(bodyId);
+        stream.Write(command);
+    }
+}
+
+void PhysicsReplayRecorder::RecordGravity(JPH::Vec3Arg gravity)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetGravity;
+    event.BodyId = JPH::BodyID::cInvalidBodyID;
+    gravity.StoreFloat3(reinterpret_cast<JPH::Float3*>(event.Vector));
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordDamping(JPH::BodyID bodyId, float damping, const float* angularDamping)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetDamping;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Value = damping;
+
+    if (angularDamping != nullptr)
+    {
+        event.Flag = true;
+        event.Vector[0] = *angularDamping;
+    }
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordBodyReferenceEvent(
+    ReplayEventType type, JPH::BodyID bodyId, uint32_t reference, bool flag /*= false*/)
+{
+    ReplayEvent event;
+    event.Type = type;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Count = reference;
+    event.Flag = flag;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordCollisionIgnores(
+    JPH::BodyID bodyId, PhysicsBody* const* ignoredBodies, int ignoreCount)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetCollisionIgnores;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Count = static_cast<uint32_t>(ignoreCount);
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+
+    for (int i = 0; i < ignoreCount; ++i)
+    {
+        stream.Write(ignoredBodies[i]->GetId().GetIndexAndSequenceNumber());
+    }
+}
+
+void PhysicsReplayRecorder::RecordFlowResponse(JPH::BodyID bodyId, float forceMultiplier, float drag)
+{
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetFlowResponse;
+    event.BodyId = bodyId.GetIndexAndSequenceNumber();
+    event.Value = forceMultiplier;
+    event.Vector[0] = drag;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordWorldEvent(ReplayEventType type, float value, bool flag /*= false*/)
+{
+    ReplayEvent event;
+    event.Type = type;
+    event.BodyId = JPH::BodyID::cInvalidBodyID;
+    event.Value = value;
+    event.Flag = flag;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+}
+
+void PhysicsReplayRecorder::RecordFlowFieldGrid(
+    const float* velocities, int width, int height, float originX, float originZ, float spacing)
+{
+    if (velocities == nullptr)
+    {
+        width = 0;
+        height = 0;
+    }
+
+    ReplayEvent event;
+    event.Type = ReplayEventType::SetFlowFieldGrid;
+    event.BodyId = JPH::BodyID::cInvalidBodyID;
+    event.Vector[0] = originX;
+    event.Vector[1] = originZ;
+    event.Vector[2] = spacing;
+
+    const auto valueCount = width > 0 && height > 0 ? static_cast<size_t>(width) * height * 2 : 0;
+
+    Lock lock(writeMutex);
+    WriteEvent(event);
+
+    stream.Write(static_cast<int32_t>(width));
+    stream.Write(static_cast<int32_t>(height));
+    stream.WriteBytes(velocities, valueCount * sizeof(float));
+}
+
+void PhysicsReplayRecorder::WriteEvent(const ReplayEvent& event)
+{
+    stream.Write(event);
+}
+
+// ------------------------------------ //
+PhysicsReplayPlayer::PhysicsReplayPlayer(PhysicalWorld& world) : world(world)
+{
+}
+
+PhysicsReplayPlayer::~PhysicsReplayPlayer()
+{
+    auto& bodyInterface = world.physicsSystem->GetBodyInterface();
+
+    for (auto& [id, body] : bodies)
+    {
+        if (body->IsInWorld())
+        {
+            world.DestroyBody(body);
+        }
+        else
+        {
+            // Created but never added to the world
+            bodyInterface.DestroyBody(body->GetId());
+        }
+    }
+
+    bodies.clear();
+}
+
+bool PhysicsReplayPlayer::LoadState(std::string_view path)
+{
+    std::vector<Ref<PhysicsBody>> restoredBodies;
+
+    if (!world.LoadSystemState(path, restoredBodies))
+        return false;
+
+    for (auto& body : restoredBodies)
+    {
+        const auto id = body->GetId().GetIndexAndSequenceNumber();
+        bodies[id] = std::move(body);
+    }
+
+    return true;
+}
+
+bool PhysicsReplayPlayer::OpenRecording(std::string_view path)
+{
+    file = std::ifstream(path.data(), std::ifstream::in | std::ifstream::binary);
+
+    if (!file.is_open()) [[unlikely]]
+    {
+        LOG_ERROR(std::string("Can't open physics replay recording at: ") + path.data());
+        return false;
+    }
+
+    stream = std::make_unique<JPH::StreamInWrapper>(file);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+
+    stream->Read(magic);
+    stream->Read(version);
+
+    if (magic != REPLAY_FILE_MAGIC || version != REPLAY_FILE_VERSION)
+    {
+        LOG_ERROR("Physics replay recording has an unknown format or version");
+        stream.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool PhysicsReplayPlayer::PlayNextFrame(float& processDelta, bool& stepped)
+{
+    if (stream == nullptr)
+        return false;
+
+    while (true)
+    {
+        ReplayEvent event;
+        stream->Read(event);
+
+        if (stream->IsEOF() || stream->IsFailed() || event.Type == ReplayEventType::EndOfRecording)
+        {
+            stream.reset();
+            return false;
+        }
+
+        if (event.Type == ReplayEventType::Process)
+        {
+            processDelta = event.Value;
+            stepped = world.Process(event.Value);
+            return true;
+        }
+
+        ApplyEvent(event);
+    }
+}
+
+uint64_t PhysicsReplayPlayer::HashBodyStates() const
+{
+    std::vector<JPH::BodyID> ids;
+    ids.reserve(bodies.size());
+
+    for (const auto& [id, body] : bodies)
+    {
+        if (body->IsInWorld() && !body->IsDetached())
+            ids.push_back(body->GetId());
+    }
+
+    // Map iteration order is not stable so the bodies are sorted to get a consistent hash
+    std::sort(ids.begin(), ids.end());
+
+    // FNV-1a over the raw bytes of the transforms
+    uint64_t hash = 14695981039346656037ULL;
+
+    const auto hashBytes = [&hash](const void* data, size_t length)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    const auto& lockInterface = world.physicsSystem->GetBodyLockInterfaceNoLock();
+
+    for (const auto id : ids)
+    {
+        const JPH::Body* body = lockInterface.TryGetBody(id);
+
+        if (body == nullptr) [[unlikely]]
+            continue;
+
+        const auto bodyPosition = body->GetPosition();
+        const double position[3] = {static_cast<double>(bodyPosition.GetX()),
+            static_cast<double>(bodyPosition.GetY()), static_cast<double>(bodyPosition.GetZ())};
+
+        JPH::Float4 rotation;
+        body->GetRotation().GetXYZW().StoreFloat4(&rotation);
+
+        hashBytes(position, sizeof(position));
+        hashBytes(&rotation, sizeof(rotation));
+    }
+
+    return hash;
+}
+
+PhysicsBody* PhysicsReplayPlayer::FindBody(uint32_t bodyId) const
+{
+    const auto iter = bodies.find(bodyId);
+
+    if (iter == bodies.end()) [[unlikely]]
+        return nullptr;
+
+    return iter->second.get();
+}
+
+void PhysicsReplayPlayer::ApplyEvent(const ReplayEvent& event)
+{
+    if (event.Type == ReplayEventType::CreateBody)
+    {
+        const auto result = JPH::BodyCreationSettings::sRestoreWithChildren(
+            *stream, shapeMap, materialMap, groupFilterMap);
+
+        if (result.HasError()) [[unlikely]]
+        {
+            LOG_ERROR("Failed to read body creation data from replay: " + std::string(result.GetError().c_str()));
+            return;
+        }
+
+        auto body = world.CreateBodyFromSettings(result.Get(), JPH::BodyID(event.BodyId));
+
+        if (body != nullptr)
+            bodies[event.BodyId] = std::move(body);
+
+        return;
+    }
+
+    if (event.Type == ReplayEventType::BodyCommands)
+    {
+        ApplyBodyCommands(event.Count);
+        return;
+    }
+
+    if (event.Type == ReplayEventType::SetGravity)
+    {
+        world.SetGravity(JPH::Vec3(event.Vector[0], event.Vector[1], event.Vector[2]));
+        return;
+    }
+
+    if (event.Type == ReplayEventType::SetCollisionIgnores)
+    {
+        // The ignored body IDs are read even if the body is missing to not lose the position in the stream
+        ApplyCollisionIgnores(FindBody(event.BodyId), event.Count);
+        return;
+    }
+
+    if (event.Type == ReplayEventType::CollisionFilterUsed)
+    {
+        ++unreplayableEvents;
+        return;
+    }
+
+    if (event.Type == ReplayEventType::SetFlowFieldCurrents || event.Type == ReplayEventType::SetFlowFieldTime ||
+        event.Type == ReplayEventType::SetFlowFieldGrid)
+    {
+        ApplyFlowFieldEvent(event);
+        return;
+    }
+
+    // Shape data needs to be read even if the body is missing to not lose the position in the stream
+    JPH::RefConst<JPH::Shape> shape;
+
+    if (event.Type == ReplayEventType::ChangeShape)
+    {
+        const auto result = JPH::Shape::sRestoreWithChildren(*stream, shapeMap, materialMap);
+
+        if (result.HasError()) [[unlikely]]
+        {
+            LOG_ERROR("Failed to read shape data from replay: " + std::string(result.GetError().c_str()));
+            return;
+        }
+
+        shape = result.Get();
+    }
+
+    auto* body = FindBody(event.BodyId);
+
+    if (body == nullptr) [[unlikely]]
+    {
+        LOG_WARNING("Replay event targets an unknown body, skipping it");
+        return;
+    }
+
+    const auto bodyId = body->GetId();
+    const auto vector = JPH::Vec3(event.Vector[0], event.Vector[1], event.Vector[2]);
+    const auto position = JPH::DVec3(event.Position[0], event.Position[1], event.Position[2]);
+    const auto rotation = JPH::Quat(event.Rotation[0], event.Rotation[1], event.Rotation[2], event.Rotation[3]);
+
+    switch (event.Type)
+    {
+        case ReplayEventType::AddBody:
+            if (body->IsInWorld())
+            {
+                world.AddBody(*body, event.Flag);
+            }
+            else
+            {
+                world.physicsSystem->GetBodyInterface().AddBody(
+                    bodyId, event.Flag ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+                world.OnPostBodyAdded(*body);
+            }
+
+            break;
+        case ReplayEventType::DetachBody:
+            world.DetachBody(*body);
+            break;
+        case ReplayEventType::DestroyBody:
+            world.DestroyBody(body);
+            bodies.erase(event.BodyId);
+            break;
+        case ReplayEventType::GiveImpulse:
+            world.GiveImpulse(bodyId, vector, event.Flag);
+            break;
+        case ReplayEventType::GiveAngularImpulse:
+            world.GiveAngularImpulse(bodyId, vector, event.Flag);
+            break;
+        case ReplayEventType::SetVelocity:
+            world.SetVelocity(bodyId, vector, event.Flag);
+            break;
+        case ReplayEventType::SetAngularVelocity:
+            world.SetAngularVelocity(bodyId, vector, event.Flag);
+            break;
+        case ReplayEventType::SetPosition:
+            world.SetPosition(bodyId, position, event.Flag);
+            break;
+        case ReplayEventType::SetPositionAndRotation:
+            world.SetPositionAndRotation(bodyId, position, rotation, event.Flag);
+            break;
+        case ReplayEventType::SetBodyControl:
+            world.SetBodyControl(*body, vector, rotation, event.Value);
+            break;
+        case ReplayEventType::DisableBodyControl:
+            world.DisableBodyControl(*body);
+            break;
+        case ReplayEventType::ChangeShape:
+            world.ChangeBodyShape(*body, shape, event.Flag);
+            break;
+        case ReplayEventType::SetCollisionDisabled:
+            world.SetCollisionDisabledState(*body, event.Flag);
+            break;
+        case ReplayEventType::SetDamping:
+            world.SetDamping(bodyId, event.Value, event.Flag ? &event.Vector[0] : nullptr);
+            break;
+        case ReplayEventType::SetAllowSleep:
+            world.SetBodyAllowSleep(bodyId, event.Flag);
+            break;
+        case ReplayEventType::AddCollisionIgnore:
+        case ReplayEventType::RemoveCollisionIgnore:
+        case ReplayEventType::SetSingleCollisionIgnore:
+        {
+            const auto* other = FindBody(event.Count);
+
+            if (other == nullptr) [[unlikely]]
+            {
+                LOG_WARNING("Replay collision ignore refers to an unknown body, skipping it");
+                break;
+            }
+
+            if (event.Type == ReplayEventType::AddCollisionIgnore)
+            {
+                world.AddCollisionIgnore(*body, *other, event.Flag);
+            }
+            else if (event.Type == ReplayEventType::RemoveCollisionIgnore)
+            {
+                world.RemoveCollisionIgnore(*body, *other);
+            }
+            else
+            {
+                world.SetSingleCollisionIgnore(*body, *other);
+            }
+
+            break;
+        }
+        case ReplayEventType::ClearCollisionIgnores:
+            world.ClearCollisionIgnores(*body);
+            break;
+        case ReplayEventType::CreateAxisLockConstraint:
+            world.CreateAxisLockConstraint(*body, vector, event.Flag);
+            break;
+        case ReplayEventType::DestroyConstraint:
+        {
+            // Constraints that were already destroyed along with their body are not found anymore, which is fine
+            const auto& constraints = body->GetConstraints();
+
+            if (event.Count < constraints.size())
+                world.DestroyConstraint(*constraints[event.Count]);
+
+            break;
+        }
+        case ReplayEventType::SetContinuousCollision:
+            world.SetBodyContinuousCollision(bodyId, event.Flag);
+            break;
+        case ReplayEventType::SetFlowResponse:
+            world.SetBodyFlowResponse(*body, event.Value, event.Vector[0]);
+            break;
+        default:
+            LOG_ERROR("Unknown replay event type: " + std::to_string(static_cast<int>(event.Type)));
+            break;
+    }
+}
+
+void PhysicsReplayPlayer::ApplyBodyCommands(uint32_t count)
+{
+    commandBuffer.resize(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t bodyId = 0;
+        stream->Read(bodyId);
+
+        auto& command = commandBuffer[i];
+        stream->Read(command);
+
+        command.Body = reinterpret_cast<::PhysicsBody*>(FindBody(bodyId));
+
+        if (command.Body == nullptr) [[unlikely]]
+            command.Type = PhysicsBodyCommandNone;
+    }
+
+    world.ApplyBodyCommands(commandBuffer.data(), static_cast<int>(count));
+}
+
+void PhysicsReplayPlayer::ApplyCollisionIgnores(PhysicsBody* body, uint32_t count)
+{
+    ignoreBuffer.clear();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t bodyId = 0;
+        stream->Read(bodyId);
+
+        if (auto* ignored = FindBody(bodyId)) [[likely]]
+            ignoreBuffer.push_back(ignored);
+    }
+
+    if (body == nullptr) [[unlikely]]
+    {
+        LOG_WARNING("Replay event targets an unknown body, skipping it");
+        return;
+    }
+
+    world.SetCollisionIgnores(*body, ignoreBuffer.data(), static_cast<int>(ignoreBuffer.size()));
+}
+
+void PhysicsReplayPlayer::ApplyFlowFieldEvent(const ReplayEvent& event)
+{
+    switch (event.Type)
+    {
+        case ReplayEventType::SetFlowFieldCurrents:
+            if (event.Flag && flowCurrents == nullptr)
+                flowCurrents = Ref<Simulation::FluidCurrents>(new Simulation::FluidCurrents());
+
+            world.SetFlowFieldCurrents(event.Flag ? flowCurrents.get() : nullptr);
+            break;
+        case ReplayEventType::SetFlowFieldTime:
+            world.SetFlowFieldTime(event.Value);
+            break;
+        case ReplayEventType::SetFlowFieldGrid:
+        {
+            int32_t width = 0;
+            int32_t height = 0;
+            stream->Read(width);
+            stream->Read(height);
+
+            const auto valueCount = width > 0 && height > 0 ? static_cast<size_t>(width) * height * 2 : 0;
+            flowGridBuffer.resize(valueCount);
+            stream->ReadBytes(flowGridBuffer.data(), valueCount * sizeof(float));
+
+            world.SetFlowFieldGrid(flowGridBuffer.empty() ? nullptr : flowGridBuffer.data(), width, height,
+                event.Vector[0], event.Vector[1], event.Vector[2]);
+            break;
+        }
+        default:
+            LOG_ERROR("Not a flow field replay event: " + std::to_string(static_cast<int>(event.Type)));
+            break;
+    }
+}
+
+} // namespace Thrive::Physics
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Core/StreamWrapper.h"
+#include "Jolt/Physics/Body/BodyCreationSettings.h"
+
+#include "core/ForwardDefinitions.hpp"
+#include "core/Mutex.hpp"
+#include "core/NonCopyable.hpp"
+#include "interop/CStructures.h"
+
+namespace Thrive::Physics
+{
+
+class PhysicalWorld;
+class PhysicsBody;
+
+/// \brief Identifies replay recording files, written as the first value in the file
+constexpr uint32_t REPLAY_FILE_MAGIC = 0x52525054;
+
+/// \brief Increment when the format of the replay events changes
+constexpr uint32_t REPLAY_FILE_VERSION = 2;
+
+/// \brief Starts the world header of a physics state dump, which is before the Jolt scene data and contains the world
+/// settings that the scene doesn't have (gravity)
+constexpr uint32_t DUMP_WORLD_HEADER_MAGIC = 0x44574844;
+
+/// \brief Marks the start of the extra body ID data in a physics state dump (after the Jolt scene data)
+constexpr uint32_t DUMP_BODY_ID_MAGIC = 0x44494254;
+
+/// \brief Marks the start of the state of the Thrive body wrappers (body control and flow response) in a physics state
+/// dump, written after the body IDs
+constexpr uint32_t DUMP_BODY_STATE_MAGIC = 0x44425354;
+
+/// \brief Flags for each body entry in the body state part of a physics state dump
+constexpr uint8_t DUMP_BODY_STATE_CONTROL = 1;
+constexpr uint8_t DUMP_BODY_STATE_FLOW = 2;
+
+enum class ReplayEventType : uint8_t
+{
+    EndOfRecording = 0,
+
+    /// \brief Value is the process delta
+    Process,
+
+    /// \brief Followed by the body creation settings (with the shape data)
+    CreateBody,
+
+    /// \brief Flag is the activation state
+    AddBody,
+    DetachBody,
+    DestroyBody,
+
+    /// \brief The vector events use Vector with Flag as the activate parameter
+    GiveImpulse,
+    GiveAngularImpulse,
+    SetVelocity,
+    SetAngularVelocity,
+
+    /// \brief Flag is the activate parameter
+    SetPosition,
+    SetPositionAndRotation,
+
+    /// \brief Vector is the movement, Rotation the target rotation and Value the rotation rate
+    SetBodyControl,
+    DisableBodyControl,
+
+    /// \brief Followed by the new shape data. Flag is the activate parameter.
+    ChangeShape,
+
+    /// \brief Flag is the new disabled state
+    SetCollisionDisabled,
+
+    /// \brief Followed by Count body commands each prefixed by the ID of the target body
+    BodyCommands,
+
+    /// \brief Vector is the new gravity. Doesn't target a body.
+    SetGravity,
+
+    /// \brief Value is the linear damping. When Flag is set Vector[0] is the angular damping.
+    SetDamping,
+
+    /// \brief Flag is whether the body is allowed to sleep
+    SetAllowSleep,
+
+    /// \brief Count is the ID of the other body. Flag is the skip duplicates parameter for adding.
+    AddCollisionIgnore,
+    RemoveCollisionIgnore,
+    SetSingleCollisionIgnore,
+
+    /// \brief Followed by Count IDs of the ignored bodies
+    SetCollisionIgnores,
+    ClearCollisionIgnores,
+
+    /// \brief Vector is the locked axis and Flag the lock rotation parameter
+    CreateAxisLockConstraint,
+
+    /// \brief Count is the index of the constraint in the constraints of the target body (the first body of the
+    /// constraint)
+    DestroyConstraint,
+
+    /// \brief Marks that a collision filter callback was set on the body. The callbacks are game code that can't be
+    /// recorded so a replay with this is not faithful to the original run.
+    CollisionFilterUsed,
+
+    /// \brief Flag is whether continuous collision detection is on
+    SetContinuousCollision,
+
+    /// \brief Value is the force multiplier and Vector[0] the drag
+    SetFlowResponse,
+
+    /// \brief Flag is whether fluid currents are used as the flow field. Doesn't target a body.
+    SetFlowFieldCurrents,
+
+    /// \brief Value is the new time. Doesn't target a body.
+    SetFlowFieldTime,
+
+    /// \brief Vector has the grid origin x, z and the spacing. Followed by the width, height and the velocity data.
+    /// Doesn't target a body.
+    SetFlowFieldGrid,
+};
+
+/// \brief A single recorded operation in a replay file. Some types have extra data following them in the file.
+struct ReplayEvent
+{
+    double Position[3] = {0, 0, 0};
+    float Rotation[4] = {0, 0, 0, 1};
+    float Vector[3] = {0, 0, 0};
+    float Value = 0;
+
+    /// \brief Full Jolt body ID (index and sequence number) of the target body
+    uint32_t BodyId = 0;
+
+    uint32_t Count = 0;
+
+    ReplayEventType Type = ReplayEventType::EndOfRecording;
+    bool Flag = false;
+};
+
+/// \brief Writes the operations done on a PhysicalWorld to a file so that they can be replayed later with
+/// PhysicsReplayPlayer
+///
+/// Only operations that affect the simulation are recorded (for example collision recording is not). Collision
+/// filter callbacks can't be recorded, so only the fact that one was used is. Recording methods are thread safe.
+class PhysicsReplayRecorder : NonCopyable
+{
+public:
+    /// \returns A new recorder or null if the file can't be written
+    static std::unique_ptr<PhysicsReplayRecorder> Create(std::string_view path);
+
+    ~PhysicsReplayRecorder();
+
+    void RecordProcess(float delta);
+
+    void RecordBodyCreated(const JPH::BodyCreationSettings& settings, JPH::BodyID bodyId);
+
+    /// \brief Records an event that only needs the body and optionally the flag
+    void RecordBodyEvent(ReplayEventType type, JPH::BodyID bodyId, bool flag = false);
+
+    void RecordVectorEvent(ReplayEventType type, JPH::BodyID bodyId, JPH::Vec3Arg vector, bool activate);
+
+    void RecordPosition(JPH::BodyID bodyId, JPH::DVec3Arg position, const JPH::Quat* rotation, bool activate);
+
+    void RecordBodyControl(JPH::BodyID bodyId, JPH::Vec3Arg movement, JPH::QuatArg rotation, float rotationRate);
+
+    void RecordShapeChange(JPH::BodyID bodyId, const JPH::Shape& shape, bool activate);
+
+    void RecordBodyCommands(const PhysicsBodyCommand* commands, int count);
+
+    void RecordGravity(JPH::Vec3Arg gravity);
+
+    void RecordDamping(JPH::BodyID bodyId, float damping, const float* angularDamping);
+
+    /// \brief Records an event that refers to another body or a constraint by the number stored in Count
+    void RecordBodyReferenceEvent(ReplayEventType type, JPH::BodyID bodyId, uint32_t reference, bool flag = false);
+
+    void RecordCollisionIgnores(JPH::BodyID bodyId, PhysicsBody* const* ignoredBodies, int ignoreCount);
+
+    void RecordFlowResponse(JPH::BodyID bodyId, float forceMultiplier, float drag);
+
+    /// \brief Records an event that doesn't target any body
+    void RecordWorldEvent(ReplayEventType type, float value, bool flag = false);
+
+    void RecordFlowFieldGrid(const float* velocities, int width, int height, float originX, float originZ,
+        float spacing);
+
+private:
+    explicit PhysicsReplayRecorder(std::ofstream&& outputFile);
+
+    /// \brief Writes an event, the write mutex must be locked
+    void WriteEvent(const ReplayEvent& event);
+
+private:
+    Mutex writeMutex;
+
+    std::ofstream file;
+    JPH::StreamOutWrapper stream;
+
+    // Shapes are written only once even when multiple bodies use them
+    JPH::BodyCreationSettings::ShapeToIDMap shapeMap;
+    JPH::BodyCreationSettings::MaterialToIDMap materialMap;
+    JPH::BodyCreationSettings::GroupFilterToIDMap groupFilterMap;
+};
+
+/// \brief Restores a physics state dump into a world and replays a recording made with PhysicsReplayRecorder on it
+///
+/// Bodies are recreated with their original IDs so that the replay matches the original run. The world should be
+/// freshly created and not have other bodies in it.
+class PhysicsReplayPlayer : NonCopyable
+{
+public:
+    explicit PhysicsReplayPlayer(PhysicalWorld& world);
+
+    /// \brief Destroys all bodies that were created by this player
+    ~PhysicsReplayPlayer();
+
+    /// \brief Loads a state dump written by PhysicalWorld::DumpSystemState
+    bool LoadState(std::string_view path);
+
+    bool OpenRecording(std::string_view path);
+
+    /// \brief Applies all recorded operations up to the next process event and then processes the world
+    /// \param processDelta Receives the delta of the process event
+    /// \param stepped Is set to true if the world ran a physics step
+    /// \returns False when the end of the recording was reached (or the recording is not valid)
+    bool PlayNextFrame(float& processDelta, bool& stepped);
+
+    /// \brief Calculates a hash of the position and rotation of all bodies, used to check that repeated replays
+    /// produce the same result
+    [[nodiscard]] uint64_t HashBodyStates() const;
+
+    [[nodiscard]] size_t GetBodyCount() const noexcept
+    {
+        return bodies.size();
+    }
+
+    /// \brief Number of replayed events that marked something that couldn't be recorded (like collision filter
+    /// callbacks). When this is not 0 the replay doesn't match the original run.
+    [[nodiscard]] uint32_t GetUnreplayableEventCount() const noexcept
+    {
+        return unreplayableEvents;
+    }
+
+private:
+    [[nodiscard]] PhysicsBody* FindBody(uint32_t bodyId) const;
+
+    void ApplyEvent(const ReplayEvent& event);
+
+    void ApplyBodyCommands(uint32_t count);
+
+    void ApplyCollisionIgnores(PhysicsBody* body, uint32_t count);
+
+    /// \brief Applies the events that affect the flow field of the whole world
+    void ApplyFlowFieldEvent(const ReplayEvent& event);
+
+private:
+    PhysicalWorld& world;
+
+    /// \brief All known bodies by their full ID, this holds the reference the game side normally holds
+    std::unordered_map<uint32_t, Ref<PhysicsBody>> bodies;
+
+    std::ifstream file;
+    std::unique_ptr<JPH::StreamInWrapper> stream;
+
+    JPH::BodyCreationSettings::IDToShapeMap shapeMap;
+    JPH::BodyCreationSettings::IDToMaterialMap materialMap;
+    JPH::BodyCreationSettings::IDToGroupFilterMap groupFilterMap;
+
+    std::vector<PhysicsBodyCommand> commandBuffer;
+    std::vector<PhysicsBody*> ignoreBuffer;
+
+    /// \brief The currents are not saved in the recording as they only depend on the time, so the player has its own
+    Ref<Simulation::FluidCurrents> flowCurrents;
+    std::vector<float> flowGridBuffer;
+
+    uint32_t unreplayableEvents = 0;
+};
+
+} // namespace Thrive::Physics
@@ -0,0 +1,141 @@
+// ------------------------------------ //
+#include "ShapeBuildTask.hpp"
+
+#include <thread>
+
+#include "core/Logger.hpp"
+#include "core/TaskSystem.hpp"
+#include "core/Tracing.hpp"
+#include "interop/JoltTypeConversions.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Physics
+{
+
+Ref<ShapeBuildTask> ShapeBuildTask::StartCached(CachedShapeKind kind, const JVecF3* points, uint32_t pointCount,
+    float density, float scale, float extraParameter, ShapeCache::ShapeCreateCallback createCallback)
+{
+    Ref<ShapeBuildTask> task(new ShapeBuildTask());
+
+    task->points.assign(points, points + pointCount);
+    task->cachedCreateCallback = createCallback;
+    task->density = density;
+    task->scale = scale;
+    task->extraParameter = extraParameter;
+    task->cachedKind = kind;
+
+    task->Queue();
+    return task;
+}
+
+Ref<ShapeBuildTask> ShapeBuildTask::StartStaticCompound(const SubShapeDefinition* subShapes, uint32_t count)
+{
+    Ref<ShapeBuildTask> task(new ShapeBuildTask());
+
+    task->compound = true;
+    task->compoundSubShapes.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const auto& subShape = subShapes[i];
+
+        if (subShape.Shape == nullptr) [[unlikely]]
+        {
+            LOG_ERROR("Sub-shape of an asynchronously built compound shape is null");
+            task->state.store(ShapeBuildTaskStateFailed, std::memory_order_release);
+            return task;
+        }
+
+        // Referencing the Jolt shape keeps it alive even if the caller releases the sub-shape before the build
+        task->compoundSubShapes.emplace_back(subShape.Shape->GetShape(), Vec3FromCAPI(subShape.Position),
+            QuatFromCAPI(subShape.Rotation), subShape.UserData);
+    }
+
+    task->Queue();
+    return task;
+}
+
+// ------------------------------------ //
+Ref<ShapeWrapper> ShapeBuildTask::TakeResult()
+{
+    if (GetState() != ShapeBuildTaskStateCompleted)
+        return nullptr;
+
+    return std::move(result);
+}
+
+Ref<ShapeWrapper> ShapeBuildTask::Wait()
+{
+    // Build on this thread if the task is still waiting in the queue, this also makes sure waiting can't get stuck
+    // when the task system is busy or has been shut down
+    TryBuild();
+
+    while (!IsDone())
+    {
+        std::this_thread::yield();
+    }
+
+    return TakeResult();
+}
+
+// ------------------------------------ //
+void ShapeBuildTask::Queue()
+{
+    // The queued task holds a reference so that the task object stays alive even if the caller releases it
+    Ref<ShapeBuildTask> self(this);
+
+    TaskSystem::Get().QueueTaskFromBackgroundThread([self]() { self->TryBuild(); });
+}
+
+void ShapeBuildTask::TryBuild()
+{
+    auto expected = ShapeBuildTaskStateQueued;
+
+    if (!state.compare_exchange_strong(
+            expected, ShapeBuildTaskStateBuilding, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        // Another thread is already building (or has built) the shape
+        return;
+    }
+
+    Build();
+}
+
+void ShapeBuildTask::Build()
+{
+    TRACE_SCOPE("ShapeBuild");
+
+    if (compound)
+    {
+        auto shape = ShapeCreator::CreateStaticCompound(compoundSubShapes);
+
+        if (shape != nullptr) [[likely]]
+        {
+#ifdef USE_OBJECT_POOLS
+            result = ConstructFromGlobalPool<ShapeWrapper>(std::move(shape));
+#else
+            result = Ref<ShapeWrapper>(new ShapeWrapper(std::move(shape)));
+#endif
+        }
+    }
+    else
+    {
+        result = ShapeCache::Get().GetOrCreate(cachedKind, points.data(), static_cast<uint32_t>(points.size()),
+            density, scale, extraParameter, cachedCreateCallback);
+    }
+
+    // Inputs are no longer needed, release them already as the caller may take a while to check the result
+    CompoundSubShapes().swap(compoundSubShapes);
+    std::vector<JVecF3>().swap(points);
+
+    if (result == nullptr) [[unlikely]]
+    {
+        LOG_ERROR("Asynchronous shape build failed");
+        state.store(ShapeBuildTaskStateFailed, std::memory_order_release);
+        return;
+    }
+
+    state.store(ShapeBuildTaskStateCompleted, std::memory_order_release);
+}
+
+} // namespace Thrive::Physics
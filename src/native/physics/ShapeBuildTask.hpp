@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+#include "Jolt/Core/Reference.h"
+#include "Jolt/Physics/Collision/Shape/Shape.h"
+
+#include "core/ForwardDefinitions.hpp"
+#include "core/RefCounted.hpp"
+#include "interop/CStructures.h"
+
+#include "ShapeCache.hpp"
+#include "ShapeCreator.hpp"
+#include "ShapeWrapper.hpp"
+
+namespace Thrive::Physics
+{
+
+/// \brief Builds a shape in the background on the task system
+///
+/// The input data is copied when the build is started so the caller doesn't need to keep it alive. The state can be
+/// polled each frame and once the build is complete the resulting shape can be taken. If the result is needed right
+/// away Wait can be used, which builds the shape on the calling thread if no task thread has started it yet.
+class ShapeBuildTask : public RefCountedBasic
+{
+protected:
+    using CompoundSubShapes = std::vector<std::tuple<JPH::RefConst<JPH::Shape>, JPH::Vec3, JPH::Quat, uint32_t>>;
+
+    ShapeBuildTask() = default;
+
+public:
+    /// \brief Starts building a shape through the shape cache (so an existing identical shape is reused)
+    static Ref<ShapeBuildTask> StartCached(CachedShapeKind kind, const JVecF3* points, uint32_t pointCount,
+        float density, float scale, float extraParameter, ShapeCache::ShapeCreateCallback createCallback);
+
+    /// \brief Starts building a static compound shape. The sub-shapes are kept alive until the build is done.
+    static Ref<ShapeBuildTask> StartStaticCompound(const SubShapeDefinition* subShapes, uint32_t count);
+
+    [[nodiscard]] inline ShapeBuildTaskState GetState() const noexcept
+    {
+        return state.load(std::memory_order_acquire);
+    }
+
+    /// \returns True once the build has either completed or failed
+    [[nodiscard]] inline bool IsDone() const noexcept
+    {
+        const auto current = GetState();
+        return current == ShapeBuildTaskStateCompleted || current == ShapeBuildTaskStateFailed;
+    }
+
+    /// \brief Takes the built shape out of this task. Only the first call after completion returns the shape.
+    /// \returns The shape or null if the build is not complete, it failed or the shape was already taken
+    Ref<ShapeWrapper> TakeResult();
+
+    /// \brief Blocks until the build is done and then takes the result
+    Ref<ShapeWrapper> Wait();
+
+private:
+    void Queue();
+
+    /// \brief Builds the shape if no other thread has started building it
+    void TryBuild();
+
+    void Build();
+
+private:
+    std::atomic<ShapeBuildTaskState> state{ShapeBuildTaskStateQueued};
+
+    // Build inputs, released once the build is done
+    CompoundSubShapes compoundSubShapes;
+    std::vector<JVecF3> points;
+    ShapeCache::ShapeCreateCallback cachedCreateCallback = nullptr;
+    float density = 0;
+    float scale = 0;
+    float extraParameter = 0;
+    CachedShapeKind cachedKind = CachedShapeKind::Convex;
+    bool compound = false;
+
+    Ref<ShapeWrapper> result;
+};
+
+} // namespace Thrive::Physics
@@ -0,0 +1,228 @@
+// ------------------------------------ //
+#include "ShapeCache.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "core/Logger.hpp"
+#include "core/Time.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Physics
+{
+
+ShapeCache& ShapeCache::Get()
+{
+    static ShapeCache cache;
+
+    return cache;
+}
+
+// ------------------------------------ //
+Ref<ShapeWrapper> ShapeCache::GetOrCreate(CachedShapeKind kind, const JVecF3* points, uint32_t pointCount,
+    float density, float scale, float extraParameter, ShapeCreateCallback createCallback)
+{
+    Entry key;
+    BuildKey(key, kind, points, pointCount, density, scale, extraParameter);
+
+    {
+        Lock lock(cacheMutex);
+
+        if (maxEntries > 0)
+        {
+            if (auto existing = FindEntry(key))
+            {
+                ++hits;
+                return existing;
+            }
+        }
+
+        ++misses;
+    }
+
+    // The lock is not held while creating the shape as building convex hulls is slow and this shouldn't block other
+    // threads getting already created shapes
+    const auto start = TimingClock::now();
+
+    auto shape = createCallback(points, pointCount, density, scale, extraParameter);
+
+    const auto elapsed = std::chrono::duration_cast<PreciseSecondDuration>(TimingClock::now() - start).count();
+
+    if (shape == nullptr) [[unlikely]]
+    {
+        LOG_ERROR("Failed to create a shape for the shape cache");
+        return nullptr;
+    }
+
+#ifdef USE_OBJECT_POOLS
+    auto wrapper = ConstructFromGlobalPool<ShapeWrapper>(std::move(shape));
+#else
+    auto wrapper = Ref<ShapeWrapper>(new ShapeWrapper(std::move(shape)));
+#endif
+
+    Lock lock(cacheMutex);
+
+    creationTime += elapsed;
+
+    if (maxEntries < 1)
+        return wrapper;
+
+    // Another thread may have created the same shape at the same time, in which case its shape is used to keep all
+    // users sharing one shape
+    if (auto existing = FindEntry(key))
+        return existing;
+
+    key.Shape = wrapper;
+    entries.push_front(std::move(key));
+    lookup.emplace(entries.front().Hash, entries.begin());
+
+    EvictOverLimit(maxEntries);
+
+    return wrapper;
+}
+
+void ShapeCache::SetMaxEntries(size_t newMaxEntries)
+{
+    Lock lock(cacheMutex);
+
+    maxEntries = newMaxEntries;
+    EvictOverLimit(maxEntries);
+}
+
+void ShapeCache::ClearUnused()
+{
+    Lock lock(cacheMutex);
+
+    EvictOverLimit(0);
+}
+
+void ShapeCache::Clear()
+{
+    Lock lock(cacheMutex);
+
+    lookup.clear();
+    entries.clear();
+}
+
+ShapeCacheStatistics ShapeCache::GetStatistics() const
+{
+    Lock lock(cacheMutex);
+
+    ShapeCacheStatistics result{};
+
+    result.Hits = hits;
+    result.Misses = misses;
+    result.Evictions = evictions;
+    result.Entries = static_cast<int32_t>(entries.size());
+    result.CreationTime = static_cast<float>(creationTime);
+
+    for (const auto& entry : entries)
+    {
+        if (entry.Shape->GetRefCount() <= 1)
+            ++result.UnusedEntries;
+    }
+
+    return result;
+}
+
+// ------------------------------------ //
+void ShapeCache::BuildKey(Entry& entry, CachedShapeKind kind, const JVecF3* points, uint32_t pointCount,
+    float density, float scale, float extraParameter)
+{
+    entry.Kind = kind;
+    entry.Density = density;
+    entry.Scale = scale;
+    entry.ExtraParameter = extraParameter;
+
+    entry.QuantisedPoints.resize(static_cast<size_t>(pointCount) * 3);
+
+    for (uint32_t i = 0; i < pointCount; ++i)
+    {
+        const auto& point = points[i];
+
+        entry.QuantisedPoints[i * 3] = static_cast<int32_t>(std::lround(point.X / POINT_QUANTISATION));
+        entry.QuantisedPoints[i * 3 + 1] = static_cast<int32_t>(std::lround(point.Y / POINT_QUANTISATION));
+        entry.QuantisedPoints[i * 3 + 2] = static_cast<int32_t>(std::lround(point.Z / POINT_QUANTISATION));
+    }
+
+    // FNV-1a over all of the key data
+    uint64_t hash = 14695981039346656037ULL;
+
+    const auto hashBytes = [&hash](const void* data, size_t length)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    hashBytes(&kind, sizeof(kind));
+    hashBytes(&density, sizeof(density));
+    hashBytes(&scale, sizeof(scale));
+    hashBytes(&extraParameter, sizeof(extraParameter));
+    hashBytes(entry.QuantisedPoints.data(), entry.QuantisedPoints.size() * sizeof(int32_t));
+
+    entry.Hash = hash;
+}
+
+bool ShapeCache::KeysMatch(const Entry& first, const Entry& second) noexcept
+{
+    return first.Hash == second.Hash && first.Kind == second.Kind && first.Density == second.Density &&
+        first.Scale == second.Scale && first.ExtraParameter == second.ExtraParameter &&
+        first.QuantisedPoints == second.QuantisedPoints;
+}
+
+Ref<ShapeWrapper> ShapeCache::FindEntry(const Entry& key)
+{
+    const auto [begin, end] = lookup.equal_range(key.Hash);
+
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        if (!KeysMatch(*iter->second, key)) [[unlikely]]
+            continue;
+
+        // Move to the front as the most recently used entry, this doesn't invalidate the stored iterators
+        entries.splice(entries.begin(), entries, iter->second);
+        return iter->second->Shape;
+    }
+
+    return nullptr;
+}
+
+void ShapeCache::EvictOverLimit(size_t limit)
+{
+    auto iter = entries.end();
+
+    while (entries.size() > limit && iter != entries.begin())
+    {
+        --iter;
+
+        // Shapes still in use are kept so that new users of them still get the same shape
+        if (iter->Shape->GetRefCount() > 1)
+            continue;
+
+        RemoveFromLookup(iter);
+        iter = entries.erase(iter);
+
+        ++evictions;
+    }
+}
+
+void ShapeCache::RemoveFromLookup(std::list<Entry>::iterator entry)
+{
+    const auto [begin, end] = lookup.equal_range(entry->Hash);
+
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        if (iter->second == entry)
+        {
+            lookup.erase(iter);
+            return;
+        }
+    }
+}
+
+} // namespace Thrive::Physics
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "Jolt/Core/Reference.h"
+#include "Jolt/Physics/Collision/Shape/Shape.h"
+
+#include "core/ForwardDefinitions.hpp"
+#include "core/Mutex.hpp"
+#include "core/NonCopyable.hpp"
+#include "core/RefCounted.hpp"
+#include "interop/CStructures.h"
+
+#include "ShapeWrapper.hpp"
+
+namespace Thrive::Physics
+{
+
+/// \brief The different ways a shape can be created from a point list, part of the shape cache key
+enum class CachedShapeKind : uint8_t
+{
+    Convex,
+    MicrobeConvex,
+    MicrobeSpheres,
+};
+
+/// \brief Shares shapes created from point lists so that identical shapes are only created once
+///
+/// Shapes are found by their kind, creation parameters and points. Points are quantised before comparing so that
+/// tiny floating point differences (for example from different code paths calculating the same membrane) don't
+/// prevent sharing. When there are more entries than the maximum, the least recently used entries that are not
+/// referenced from outside the cache are removed.
+class ShapeCache : NonCopyable
+{
+public:
+    /// \brief Default limit for how many shapes are kept
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 1024;
+
+    /// \brief Points are rounded to this fraction of a unit for the cache key
+    static constexpr float POINT_QUANTISATION = 1.0f / 1024.0f;
+
+    using ShapeCreateCallback = JPH::RefConst<JPH::Shape> (*)(
+        const JVecF3* points, uint32_t pointCount, float density, float scale, float extraParameter);
+
+private:
+    struct Entry
+    {
+        uint64_t Hash;
+
+        std::vector<int32_t> QuantisedPoints;
+        float Density;
+        float Scale;
+        float ExtraParameter;
+        CachedShapeKind Kind;
+
+        Ref<ShapeWrapper> Shape;
+    };
+
+    ShapeCache() = default;
+
+public:
+    static ShapeCache& Get();
+
+    /// \brief Finds an existing shape with the same parameters or creates a new one with the callback
+    /// \param extraParameter Shape kind specific value (for example convex radius or thickness), part of the key
+    /// \returns The shape or null if creating it failed
+    Ref<ShapeWrapper> GetOrCreate(CachedShapeKind kind, const JVecF3* points, uint32_t pointCount, float density,
+        float scale, float extraParameter, ShapeCreateCallback createCallback);
+
+    /// \brief Sets how many entries can be kept, 0 disables caching. Unused entries over the limit are evicted.
+    void SetMaxEntries(size_t maxEntries);
+
+    /// \brief Removes all entries that are not used outside the cache
+    void ClearUnused();
+
+    /// \brief Removes all entries, shapes still used outside the cache stay alive through their other references.
+    /// Called on library shutdown as the static cache would otherwise release its shapes only after Jolt has been
+    /// shut down.
+    void Clear();
+
+    [[nodiscard]] ShapeCacheStatistics GetStatistics() const;
+
+private:
+    /// \brief Builds the key data of a shape into entry (everything except the shape itself)
+    static void BuildKey(Entry& entry, CachedShapeKind kind, const JVecF3* points, uint32_t pointCount,
+        float density, float scale, float extraParameter);
+
+    [[nodiscard]] static bool KeysMatch(const Entry& first, const Entry& second) noexcept;
+
+    /// \brief Finds an entry and marks it as recently used. The mutex must be locked.
+    Ref<ShapeWrapper> FindEntry(const Entry& key);
+
+    /// \brief Evicts least recently used unreferenced entries until there are at most maxEntries. The mutex must be
+    /// locked.
+    void EvictOverLimit(size_t limit);
+
+    void RemoveFromLookup(std::list<Entry>::iterator entry);
+
+private:
+    mutable Mutex cacheMutex;
+
+    /// \brief Most recently used entries are at the front
+    std::list<Entry> entries;
+
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> lookup;
+
+    size_t maxEntries = DEFAULT_MAX_ENTRIES;
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t evictions = 0;
+
+    /// \brief Total time spent creating shapes on cache misses, in seconds
+    double creationTime = 0;
+};
+
+} // namespace Thrive::Physics
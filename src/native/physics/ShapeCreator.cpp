@@ -10,6 +10,7 @@
 #include "core/Logger.hpp"
 #include "interop/JoltTypeConversions.hpp"
 
+#include "ConvexHull2D.hpp"
 #include "ShapeWrapper.hpp"
 
 // ------------------------------------ //
@@ -144,8 +145,8 @@ JPH::RefConst<JPH::Shape> ShapeCreator::CreateMesh(
 }
 
 // ------------------------------------ //
-JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeConvex(JVecF3* points, uint32_t pointCount, float density,
-    float scale, float thickness, const JPH::PhysicsMaterial* material /*= nullptr*/)
+JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeConvex(const JVecF3* points, uint32_t pointCount,
+    float density, float scale, float thickness, const JPH::PhysicsMaterial* material /*= nullptr*/)
 {
     if (pointCount < 1)
     {
@@ -161,10 +162,27 @@ JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeConvex(JVecF3* points,
     settings.mMaxConvexRadius = JPH::cDefaultConvexRadius;
 
     auto& pointTarget = settings.mPoints;
-    pointTarget.reserve(pointCount * 2);
 
-    if (scale != 1)
+    // Membranes are flat polygons extruded along the Y-axis so only the points on their 2D outline hull can end up
+    // in the final shape. Giving just those to the generic 3D hull builder is a lot faster than all of the points.
+    std::vector<HullPoint2D> outline;
+
+    if (ConvexHull2D::IsPlanarInY(points, pointCount) && ConvexHull2D::Compute(points, pointCount, scale, outline))
     {
+        const auto y = points[0].Y * scale;
+
+        pointTarget.reserve(outline.size() * 2);
+
+        for (const auto& outlinePoint : outline)
+        {
+            pointTarget.emplace_back(outlinePoint.X, y - halfThickness, outlinePoint.Z);
+            pointTarget.emplace_back(outlinePoint.X, y + halfThickness, outlinePoint.Z);
+        }
+    }
+    else if (scale != 1)
+    {
+        pointTarget.reserve(pointCount * 2);
+
         for (uint32_t i = 0; i < pointCount; ++i)
         {
             const auto& sourcePoint = points[i];
@@ -179,6 +197,8 @@ JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeConvex(JVecF3* points,
     }
     else
     {
+        pointTarget.reserve(pointCount * 2);
+
         for (uint32_t i = 0; i < pointCount; ++i)
         {
             const auto& sourcePoint = points[i];
@@ -197,7 +217,8 @@ JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeConvex(JVecF3* points,
 }
 
 JPH::RefConst<JPH::Shape> ShapeCreator::CreateMicrobeShapeSpheres(
-    JVecF3* points, uint32_t pointCount, float density, float scale, const JPH::PhysicsMaterial* material /*= nullptr*/)
+    const JVecF3* points, uint32_t pointCount, float density, float scale,
+    const JPH::PhysicsMaterial* material /*= nullptr*/)
 {
     if (pointCount < 1)
     {
@@ -65,9 +65,9 @@ public:
     // ------------------------------------ //
     // Advanced game related shapes
 
-    static JPH::RefConst<JPH::Shape> CreateMicrobeShapeConvex(JVecF3* points, uint32_t pointCount, float density = 1000,
-        float scale = 1, float thickness = 1.0f, const JPH::PhysicsMaterial* material = nullptr);
-    static JPH::RefConst<JPH::Shape> CreateMicrobeShapeSpheres(JVecF3* points, uint32_t pointCount,
+    static JPH::RefConst<JPH::Shape> CreateMicrobeShapeConvex(const JVecF3* points, uint32_t pointCount,
+        float density = 1000, float scale = 1, float thickness = 1.0f, const JPH::PhysicsMaterial* material = nullptr);
+    static JPH::RefConst<JPH::Shape> CreateMicrobeShapeSpheres(const JVecF3* points, uint32_t pointCount,
         float density = 1000, float scale = 1, const JPH::PhysicsMaterial* material = nullptr);
 };
 
@@ -0,0 +1,651 @@
+// ------------------------------------ //
+#include "CompoundCloudSimulation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#ifdef THRIVE_USE_AVX2
+#include <immintrin.h>
+#endif
+
+#include "core/Logger.hpp"
+#include "core/ParallelFor.hpp"
+#include "core/Tracing.hpp"
+
+#include "FluidCurrents.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Simulation
+{
+
+constexpr int SquaresPerCloud = CompoundCloudSimulation::SQUARES_PER_SIDE * CompoundCloudSimulation::SQUARES_PER_SIDE;
+
+// Texture writing reads whole blocks from density rows, which is only safe if rows are padded to the block size
+static_assert(CompoundCloudSimulation::ROW_ALIGNMENT % CompoundCloudSimulation::TEXTURE_ROW_BLOCK == 0);
+
+/// \brief Only cells with more density than this (length of all channels squared) are moved by advection
+constexpr float AdvectionDensityThreshold = 1;
+
+static FORCE_INLINE int PositiveModulo(int value, int divisor)
+{
+    const auto result = value % divisor;
+    return result < 0 ? result + divisor : result;
+}
+
+/// \brief Splits a target position to the 2x2 cells around it and the weights for them
+static FORCE_INLINE void CalculateMovementFactors(
+    float dx, float dy, int& q0, int& q1, int& r0, int& r1, float& s1, float& s0, float& t1, float& t0)
+{
+    q0 = static_cast<int>(std::floor(dx));
+    q1 = q0 + 1;
+    r0 = static_cast<int>(std::floor(dy));
+    r1 = r0 + 1;
+
+    s1 = std::abs(dx - static_cast<float>(q0));
+    s0 = 1.0f - s1;
+    t1 = std::abs(dy - static_cast<float>(r0));
+    t0 = 1.0f - t1;
+}
+
+CompoundCloudSimulation::CompoundCloudSimulation(
+    int size, int rowStride, float* density, float* oldDensity, float diffusionRate, float viscosity) :
+    size(size),
+    rowStride(rowStride), density(density), oldDensity(oldDensity), diffusionRate(diffusionRate),
+    viscosity(viscosity)
+{
+}
+
+// ------------------------------------ //
+void CompoundCloudSimulation::UpdateClouds(CompoundCloudSimulation* const* clouds, int count, float delta)
+{
+    if (count < 1)
+        return;
+
+    if (clouds == nullptr) [[unlikely]]
+    {
+        LOG_ERROR("No clouds given to update");
+        return;
+    }
+
+    TRACE_SCOPE("CompoundCloudUpdate");
+
+    const auto cloudCount = static_cast<size_t>(count);
+
+    // Clouds don't share any data so the edges of different clouds can be processed in parallel. The edges of a
+    // single cloud are done by one thread as the moved density can wrap around to the other edges.
+    ParallelFor(cloudCount, 1,
+        [clouds, delta](size_t start, size_t end)
+        {
+            std::vector<Region> regions;
+
+            for (size_t i = start; i < end; ++i)
+            {
+                clouds[i]->CollectEdgeRegions(regions);
+
+                for (const auto& region : regions)
+                    clouds[i]->DiffuseEdges(region, delta);
+            }
+        });
+
+    // All squares need to be cleared before any advection as squares can move density to the border of the next
+    // square
+    ParallelFor(cloudCount * SquaresPerCloud, 1,
+        [clouds, delta](size_t start, size_t end)
+        {
+            for (size_t i = start; i < end; ++i)
+                clouds[i / SquaresPerCloud]->DiffuseAndClearSquare(static_cast<int>(i % SquaresPerCloud), delta);
+        });
+
+    ParallelFor(cloudCount * SquaresPerCloud, 1,
+        [clouds, delta](size_t start, size_t end)
+        {
+            for (size_t i = start; i < end; ++i)
+                clouds[i / SquaresPerCloud]->AdvectSquare(static_cast<int>(i % SquaresPerCloud), delta);
+        });
+
+    ParallelFor(cloudCount, 1,
+        [clouds, delta](size_t start, size_t end)
+        {
+            std::vector<Region> regions;
+
+            for (size_t i = start; i < end; ++i)
+            {
+                clouds[i]->CollectEdgeRegions(regions);
+
+                for (const auto& region : regions)
+                    clouds[i]->AdvectEdges(region, delta);
+            }
+        });
+
+    // Texture data is written last to show the final state of this update
+    const auto blocksPerCloud = static_cast<size_t>(
+        (clouds[0]->size + TEXTURE_ROW_BLOCK - 1) / TEXTURE_ROW_BLOCK);
+
+    bool anyTextures = false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (clouds[i]->HasTextureOutput())
+            anyTextures = true;
+
+        // Clouds of different sizes would need a more complex work split
+        if (clouds[i]->size != clouds[0]->size) [[unlikely]]
+        {
+            LOG_ERROR("All clouds updated at once need to have the same size for texture output");
+            return;
+        }
+    }
+
+    if (!anyTextures)
+        return;
+
+    ParallelFor(cloudCount * blocksPerCloud, 4,
+        [clouds, blocksPerCloud](size_t start, size_t end)
+        {
+            for (size_t i = start; i < end; ++i)
+            {
+                const auto cloud = clouds[i / blocksPerCloud];
+
+                if (cloud->HasTextureOutput())
+                    cloud->WriteTextureRows(static_cast<int>(i % blocksPerCloud) * TEXTURE_ROW_BLOCK);
+            }
+        });
+}
+
+void CompoundCloudSimulation::SetVelocityGrid(const float* velocities, int width, int height, float spacing)
+{
+    if (velocities == nullptr || width < 1 || height < 1 || spacing <= 0)
+    {
+        velocityWidth = 0;
+        velocityHeight = 0;
+        return;
+    }
+
+    const auto count = static_cast<size_t>(width) * height;
+
+    velocityX.resize(count);
+    velocityY.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        velocityX[i] = velocities[i * 2];
+        velocityY[i] = velocities[i * 2 + 1];
+    }
+
+    velocityWidth = width;
+    velocityHeight = height;
+    velocitySpacing = spacing;
+}
+
+void CompoundCloudSimulation::SetVelocityGridFromCurrents(
+    const FluidCurrents& currents, float originX, float originY, float cellSize, int spacing)
+{
+    if (spacing < 1 || cellSize <= 0) [[unlikely]]
+    {
+        LOG_ERROR("Invalid cloud velocity grid spacing");
+        return;
+    }
+
+    // One extra sample is needed to be able to interpolate the last cells
+    const auto samples = (size + spacing - 1) / spacing + 1;
+    const auto count = static_cast<size_t>(samples) * samples;
+
+    std::vector<float> positionsX(count);
+    std::vector<float> positionsY(count);
+
+    for (int i = 0; i < samples; ++i)
+    {
+        for (int j = 0; j < samples; ++j)
+        {
+            const auto index = static_cast<size_t>(i) * samples + j;
+            positionsX[index] = originX + static_cast<float>(i * spacing) * cellSize;
+            positionsY[index] = originY + static_cast<float>(j * spacing) * cellSize;
+        }
+    }
+
+    velocityX.resize(count);
+    velocityY.resize(count);
+
+    currents.SampleVelocities(positionsX.data(), positionsY.data(), count, velocityX.data(), velocityY.data());
+
+    velocityWidth = samples;
+    velocityHeight = samples;
+    velocitySpacing = static_cast<float>(spacing);
+}
+
+// ------------------------------------ //
+CompoundCloudSimulation::Region CompoundCloudSimulation::GetSquare(int index) const noexcept
+{
+    const auto squareSize = size / SQUARES_PER_SIDE;
+
+    return Region{index / SQUARES_PER_SIDE * squareSize, index % SQUARES_PER_SIDE * squareSize, squareSize,
+        squareSize};
+}
+
+void CompoundCloudSimulation::CollectEdgeRegions(std::vector<Region>& regions) const
+{
+    regions.clear();
+
+    constexpr int halfEdge = EDGE_WIDTH / 2;
+    const auto third = size / SQUARES_PER_SIDE;
+    const auto twoThirds = 2 * size / SQUARES_PER_SIDE;
+    const auto innerLength = third - EDGE_WIDTH;
+
+    // The edges at the current wrap around point of the plane are not simulated
+    if (planeX != 0)
+    {
+        regions.push_back(Region{0, 0, halfEdge, size});
+        regions.push_back(Region{size - halfEdge, 0, halfEdge, size});
+    }
+
+    if (planeX != 1)
+        regions.push_back(Region{third - halfEdge, 0, EDGE_WIDTH, size});
+
+    if (planeX != 2)
+        regions.push_back(Region{twoThirds - halfEdge, 0, EDGE_WIDTH, size});
+
+    if (planeY != 0)
+    {
+        regions.push_back(Region{halfEdge, 0, innerLength, halfEdge});
+        regions.push_back(Region{halfEdge, size - halfEdge, innerLength, halfEdge});
+        regions.push_back(Region{third + halfEdge, 0, innerLength, halfEdge});
+        regions.push_back(Region{third + halfEdge, size - halfEdge, innerLength, halfEdge});
+        regions.push_back(Region{twoThirds + halfEdge, 0, innerLength, halfEdge});
+        regions.push_back(Region{twoThirds + halfEdge, size - halfEdge, innerLength, halfEdge});
+    }
+
+    if (planeY != 1)
+    {
+        regions.push_back(Region{halfEdge, third - halfEdge, innerLength, EDGE_WIDTH});
+        regions.push_back(Region{third + halfEdge, third - halfEdge, innerLength, EDGE_WIDTH});
+        regions.push_back(Region{twoThirds + halfEdge, third - halfEdge, innerLength, EDGE_WIDTH});
+    }
+
+    if (planeY != 2)
+    {
+        regions.push_back(Region{halfEdge, twoThirds - halfEdge, innerLength, EDGE_WIDTH});
+        regions.push_back(Region{third + halfEdge, twoThirds - halfEdge, innerLength, EDGE_WIDTH});
+        regions.push_back(Region{twoThirds + halfEdge, twoThirds - halfEdge, innerLength, EDGE_WIDTH});
+    }
+}
+
+void CompoundCloudSimulation::DiffuseAndClearSquare(int square, float delta)
+{
+    const auto region = GetSquare(square);
+
+    constexpr int halfEdge = EDGE_WIDTH / 2;
+
+    DiffuseCenter(Region{region.X + halfEdge, region.Y + halfEdge, region.Width - EDGE_WIDTH,
+                      region.Height - EDGE_WIDTH},
+        delta);
+    ClearDensity(region);
+}
+
+void CompoundCloudSimulation::AdvectSquare(int square, float delta)
+{
+    const auto region = GetSquare(square);
+
+    constexpr int halfEdge = EDGE_WIDTH / 2;
+
+    AdvectCenter(Region{region.X + halfEdge, region.Y + halfEdge, region.Width - EDGE_WIDTH,
+                     region.Height - EDGE_WIDTH},
+        region, delta);
+}
+
+// ------------------------------------ //
+void CompoundCloudSimulation::DiffuseEdges(const Region& region, float delta)
+{
+    const float a = delta * diffusionRate;
+    const float keep = 1 - a;
+    const float spread = a / 4;
+
+    for (int channel = 0; channel < CHANNELS; ++channel)
+    {
+        const float* source = DensityChannel(channel);
+        float* target = OldDensityChannel(channel);
+
+        for (int x = region.X; x < region.X + region.Width; ++x)
+        {
+            const auto previousX = PositiveModulo(x - 1, size);
+            const auto nextX = (x + 1) % size;
+
+            for (int y = region.Y; y < region.Y + region.Height; ++y)
+            {
+                const auto neighbours = source[CellIndex(x, PositiveModulo(y - 1, size))] +
+                    source[CellIndex(x, (y + 1) % size)] + source[CellIndex(previousX, y)] +
+                    source[CellIndex(nextX, y)];
+
+                target[CellIndex(x, y)] = source[CellIndex(x, y)] * keep + neighbours * spread;
+            }
+        }
+    }
+}
+
+void CompoundCloudSimulation::AdvectEdges(const Region& region, float delta)
+{
+    float amounts[CHANNELS];
+
+    for (int x = region.X; x < region.X + region.Width; ++x)
+    {
+        for (int y = region.Y; y < region.Y + region.Height; ++y)
+        {
+            const auto index = CellIndex(x, y);
+
+            float lengthSquared = 0;
+
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                amounts[channel] = OldDensityChannel(channel)[index];
+                lengthSquared += amounts[channel] * amounts[channel];
+            }
+
+            if (lengthSquared <= AdvectionDensityThreshold)
+                continue;
+
+            float velocityXAtCell;
+            float velocityYAtCell;
+            SampleVelocity(static_cast<float>(x), static_cast<float>(y), velocityXAtCell, velocityYAtCell);
+
+            const float dx = static_cast<float>(x) + delta * velocityXAtCell * viscosity;
+            const float dy = static_cast<float>(y) + delta * velocityYAtCell * viscosity;
+
+            int q0, q1, r0, r1;
+            float s1, s0, t1, t0;
+            CalculateMovementFactors(dx, dy, q0, q1, r0, r1, s1, s0, t1, t0);
+
+            // Edges are processed by a single thread so no atomics are needed
+            AddMovedDensity<false>(amounts, PositiveModulo(q0, size), PositiveModulo(q1, size),
+                PositiveModulo(r0, size), PositiveModulo(r1, size), s0, s1, t0, t1);
+        }
+    }
+}
+
+void CompoundCloudSimulation::DiffuseCenter(const Region& region, float delta)
+{
+    const float a = delta * diffusionRate;
+    const float keep = 1 - a;
+    const float spread = a / 4;
+
+    const auto end = region.Y + region.Height;
+
+#ifdef THRIVE_USE_AVX2
+    const auto keepVector = _mm256_set1_ps(keep);
+    const auto spreadVector = _mm256_set1_ps(spread);
+#endif
+
+    for (int channel = 0; channel < CHANNELS; ++channel)
+    {
+        const float* source = DensityChannel(channel);
+        float* target = OldDensityChannel(channel);
+
+        for (int x = region.X; x < region.X + region.Width; ++x)
+        {
+            const float* row = source + CellIndex(x, 0);
+            const float* previousRow = source + CellIndex(x - 1, 0);
+            const float* nextRow = source + CellIndex(x + 1, 0);
+            float* targetRow = target + CellIndex(x, 0);
+
+            int y = region.Y;
+
+#ifdef THRIVE_USE_AVX2
+            // FMA is not used as the build keeps it disabled for deterministic results
+            for (; y + 8 <= end; y += 8)
+            {
+                const auto neighbours =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(row + y - 1), _mm256_loadu_ps(row + y + 1)),
+                        _mm256_add_ps(_mm256_loadu_ps(previousRow + y), _mm256_loadu_ps(nextRow + y)));
+
+                _mm256_storeu_ps(targetRow + y,
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(row + y), keepVector),
+                        _mm256_mul_ps(neighbours, spreadVector)));
+            }
+#endif
+
+            for (; y < end; ++y)
+            {
+                const auto neighbours = row[y - 1] + row[y + 1] + previousRow[y] + nextRow[y];
+                targetRow[y] = row[y] * keep + neighbours * spread;
+            }
+        }
+    }
+}
+
+void CompoundCloudSimulation::ClearDensity(const Region& region)
+{
+    for (int channel = 0; channel < CHANNELS; ++channel)
+    {
+        float* target = DensityChannel(channel);
+
+        for (int x = region.X; x < region.X + region.Width; ++x)
+        {
+            std::memset(target + CellIndex(x, region.Y), 0, sizeof(float) * region.Height);
+        }
+    }
+}
+
+void CompoundCloudSimulation::AdvectCenter(const Region& region, const Region& square, float delta)
+{
+    const auto end = region.Y + region.Height;
+
+    const float minX = static_cast<float>(region.X) - 0.5f;
+    const float maxX = static_cast<float>(region.X + region.Width) + 0.5f;
+    const float minY = static_cast<float>(region.Y) - 0.5f;
+    const float maxY = static_cast<float>(region.Y + region.Height) + 0.5f;
+
+    const float* channels[CHANNELS];
+    for (int channel = 0; channel < CHANNELS; ++channel)
+        channels[channel] = OldDensityChannel(channel);
+
+    float amounts[CHANNELS];
+
+    const auto advectCell = [&](int x, int y)
+    {
+        const auto index = CellIndex(x, y);
+
+        for (int channel = 0; channel < CHANNELS; ++channel)
+            amounts[channel] = channels[channel][index] * decayRates[channel];
+
+        float velocityXAtCell;
+        float velocityYAtCell;
+        SampleVelocity(static_cast<float>(x), static_cast<float>(y), velocityXAtCell, velocityYAtCell);
+
+        // Clamped so that this doesn't touch other squares that are processed in parallel (except their border)
+        const float dx = std::clamp(static_cast<float>(x) + delta * velocityXAtCell * viscosity, minX, maxX);
+        const float dy = std::clamp(static_cast<float>(y) + delta * velocityYAtCell * viscosity, minY, maxY);
+
+        int q0, q1, r0, r1;
+        float s1, s0, t1, t0;
+        CalculateMovementFactors(dx, dy, q0, q1, r0, r1, s1, s0, t1, t0);
+
+        const bool onBorder = q0 == square.X || q1 == square.X + square.Width || r0 == square.Y ||
+            r1 == square.Y + square.Height;
+
+        q0 = PositiveModulo(q0, size);
+        q1 = PositiveModulo(q1, size);
+        r0 = PositiveModulo(r0, size);
+        r1 = PositiveModulo(r1, size);
+
+        if (onBorder)
+        {
+            AddMovedDensity<true>(amounts, q0, q1, r0, r1, s0, s1, t0, t1);
+        }
+        else
+        {
+            AddMovedDensity<false>(amounts, q0, q1, r0, r1, s0, s1, t0, t1);
+        }
+    };
+
+#ifdef THRIVE_USE_AVX2
+    const auto threshold = _mm256_set1_ps(AdvectionDensityThreshold);
+#endif
+
+    for (int x = region.X; x < region.X + region.Width; ++x)
+    {
+        const auto rowStart = CellIndex(x, 0);
+        int y = region.Y;
+
+#ifdef THRIVE_USE_AVX2
+        // Most cells are empty so the density threshold is checked for multiple cells at once to skip those quickly
+        for (; y + 8 <= end; y += 8)
+        {
+            auto lengthSquared = _mm256_setzero_ps();
+
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const auto values = _mm256_loadu_ps(channels[channel] + rowStart + y);
+                lengthSquared = _mm256_add_ps(lengthSquared, _mm256_mul_ps(values, values));
+            }
+
+            const auto movingCells = _mm256_movemask_ps(_mm256_cmp_ps(lengthSquared, threshold, _CMP_GT_OQ));
+
+            if (movingCells == 0)
+                continue;
+
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if ((movingCells & (1 << lane)) != 0)
+                    advectCell(x, y + lane);
+            }
+        }
+#endif
+
+        for (; y < end; ++y)
+        {
+            float lengthSquared = 0;
+
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const auto value = channels[channel][rowStart + y];
+                lengthSquared += value * value;
+            }
+
+            if (lengthSquared > AdvectionDensityThreshold)
+                advectCell(x, y);
+        }
+    }
+}
+
+void CompoundCloudSimulation::WriteTextureRows(int firstRow) const noexcept
+{
+    // Same conversion as Godot uses for RGBA8 images, which truncates
+    const float scale = textureIntensityScale * 255.0f;
+    const auto rowCount = std::min(TEXTURE_ROW_BLOCK, size - firstRow);
+
+    const float* channels[CHANNELS];
+    for (int channel = 0; channel < CHANNELS; ++channel)
+        channels[channel] = DensityChannel(channel) + firstRow;
+
+    auto* target = reinterpret_cast<uint32_t*>(texturePixels) + static_cast<size_t>(firstRow) * size;
+
+    alignas(32) uint32_t packed[TEXTURE_ROW_BLOCK];
+
+#ifdef THRIVE_USE_AVX2
+    const auto scaleVector = _mm256_set1_ps(scale);
+    const auto zero = _mm256_setzero_ps();
+    const auto maxValue = _mm256_set1_ps(255.0f);
+#endif
+
+    for (int x = 0; x < size; ++x)
+    {
+        const auto offset = CellIndex(x, 0);
+
+#ifdef THRIVE_USE_AVX2
+        const auto convert = [&](int channel)
+        {
+            const auto values = _mm256_mul_ps(_mm256_loadu_ps(channels[channel] + offset), scaleVector);
+            return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(values, zero), maxValue));
+        };
+
+        // RGBA bytes in memory order on little endian
+        const auto result = _mm256_or_si256(_mm256_or_si256(convert(0), _mm256_slli_epi32(convert(1), 8)),
+            _mm256_or_si256(_mm256_slli_epi32(convert(2), 16), _mm256_slli_epi32(convert(3), 24)));
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(packed), result);
+#else
+        for (int row = 0; row < rowCount; ++row)
+        {
+            uint32_t pixel = 0;
+
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const auto value = std::clamp(channels[channel][offset + row] * scale, 0.0f, 255.0f);
+                pixel |= static_cast<uint32_t>(value) << (channel * 8);
+            }
+
+            packed[row] = pixel;
+        }
+#endif
+
+        // Each density value is in a different image row
+        for (int row = 0; row < rowCount; ++row)
+            target[static_cast<size_t>(row) * size + x] = packed[row];
+    }
+}
+
+void CompoundCloudSimulation::SampleVelocity(float x, float y, float& velocityXResult,
+    float& velocityYResult) const noexcept
+{
+    if (velocityWidth < 1) [[unlikely]]
+    {
+        velocityXResult = 0;
+        velocityYResult = 0;
+        return;
+    }
+
+    const auto gridX = std::clamp(x / velocitySpacing, 0.0f, static_cast<float>(velocityWidth - 1));
+    const auto gridY = std::clamp(y / velocitySpacing, 0.0f, static_cast<float>(velocityHeight - 1));
+
+    const auto x0 = static_cast<int>(gridX);
+    const auto y0 = static_cast<int>(gridY);
+    const auto x1 = std::min(x0 + 1, velocityWidth - 1);
+    const auto y1 = std::min(y0 + 1, velocityHeight - 1);
+
+    const auto tx = gridX - static_cast<float>(x0);
+    const auto ty = gridY - static_cast<float>(y0);
+
+    const auto index00 = static_cast<size_t>(x0) * velocityHeight + y0;
+    const auto index01 = static_cast<size_t>(x0) * velocityHeight + y1;
+    const auto index10 = static_cast<size_t>(x1) * velocityHeight + y0;
+    const auto index11 = static_cast<size_t>(x1) * velocityHeight + y1;
+
+    const auto interpolate = [tx, ty, index00, index01, index10, index11](const std::vector<float>& values)
+    {
+        const auto first = values[index00] + (values[index01] - values[index00]) * ty;
+        const auto second = values[index10] + (values[index11] - values[index10]) * ty;
+        return first + (second - first) * tx;
+    };
+
+    velocityXResult = interpolate(velocityX);
+    velocityYResult = interpolate(velocityY);
+}
+
+template<bool Atomic>
+void CompoundCloudSimulation::AddMovedDensity(const float* amounts, int q0, int q1, int r0, int r1, float s0,
+    float s1, float t0, float t1) const noexcept
+{
+    const size_t indices[4] = {CellIndex(q0, r0), CellIndex(q0, r1), CellIndex(q1, r0), CellIndex(q1, r1)};
+    const float weights[4] = {s0 * t0, s0 * t1, s1 * t0, s1 * t1};
+
+    for (int channel = 0; channel < CHANNELS; ++channel)
+    {
+        float* target = DensityChannel(channel);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto amount = amounts[channel] * weights[i];
+
+            if constexpr (Atomic)
+            {
+                std::atomic_ref<float>(target[indices[i]]).fetch_add(amount, std::memory_order_relaxed);
+            }
+            else
+            {
+                target[indices[i]] += amount;
+            }
+        }
+    }
+}
+
+} // namespace Thrive::Simulation
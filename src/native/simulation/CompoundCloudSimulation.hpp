@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/ForwardDefinitions.hpp"
+#include "core/RefCounted.hpp"
+
+namespace Thrive::Simulation
+{
+
+/// \brief Runs the diffusion and advection of a single compound cloud plane
+///
+/// The density data is stored as a separate grid for each compound (channel) where each row is one x coordinate. The
+/// density buffers are allocated by the caller (so that the C# side can access them directly) and need to stay
+/// valid as long as this object exists. Rows are padded to a multiple of 8 floats and should be 32 byte aligned.
+///
+/// The simulation is split into 3x3 squares that match the layout of the C# cloud code: the insides of the squares
+/// are simulated in parallel and the edges between them afterwards on the calling thread.
+///
+/// After each update the densities can be written directly to texture memory (for example a Godot image) so that
+/// rendering doesn't need to go through any managed copies of the data.
+class CompoundCloudSimulation : public RefCountedBasic
+{
+public:
+    /// \brief Number of compounds stored in one cloud plane
+    static constexpr int CHANNELS = 4;
+
+    /// \brief These need to match CLOUD_SQUARES_PER_SIDE and CLOUD_EDGE_WIDTH in Constants.cs
+    static constexpr int SQUARES_PER_SIDE = 3;
+    static constexpr int EDGE_WIDTH = 2;
+
+    /// \brief Rows are padded to a multiple of this many floats to keep them aligned for vector operations
+    static constexpr int ROW_ALIGNMENT = 8;
+
+    /// \brief How many image rows are converted to texture data at once. As the density rows are transposed
+    /// compared to the image, this many consecutive density values are read from each density row at once.
+    static constexpr int TEXTURE_ROW_BLOCK = 8;
+
+private:
+    struct Region
+    {
+        int X;
+        int Y;
+        int Width;
+        int Height;
+    };
+
+public:
+    CompoundCloudSimulation(int size, int rowStride, float* density, float* oldDensity, float diffusionRate,
+        float viscosity);
+
+    /// \brief Runs one simulation step of all the given clouds. Squares of all of the clouds are processed in
+    /// parallel on the task system. After that the texture data is written for the clouds that have a texture
+    /// output set.
+    /// \param delta Time step, already scaled to the cloud simulation speed
+    static void UpdateClouds(CompoundCloudSimulation* const* clouds, int count, float delta);
+
+    [[nodiscard]] static int CalculateRowStride(int size) noexcept
+    {
+        return (size + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+    }
+
+    /// \brief Sets the multipliers applied to each compound when it moves inside a square
+    void SetDecayRates(const std::array<float, CHANNELS>& rates) noexcept
+    {
+        decayRates = rates;
+    }
+
+    /// \brief Sets the position of this plane in the cloud grid, determines which edges are simulated
+    void SetPlanePosition(int x, int y) noexcept
+    {
+        planeX = x;
+        planeY = y;
+    }
+
+    /// \brief Sets the fluid velocity used for advection
+    ///
+    /// The velocities are given as x, y pairs for a grid of width * height samples where sample (i, j) is at cloud
+    /// cell (i * spacing, j * spacing). Velocities between the samples are interpolated.
+    void SetVelocityGrid(const float* velocities, int width, int height, float spacing);
+
+    /// \brief Sets the velocity grid from fluid currents
+    ///
+    /// Cloud cell (x, y) is at world position (originX + x * cellSize, originY + y * cellSize). The currents are
+    /// sampled every spacing cells, using the precalculated grid of the currents when it covers the cloud.
+    void SetVelocityGridFromCurrents(
+        const FluidCurrents& currents, float originX, float originY, float cellSize, int spacing);
+
+    /// \brief Sets where the densities are written as RGBA8 pixels after each update
+    ///
+    /// The pixels are size * size, where each image row is one y coordinate (which matches the Godot image layout).
+    /// Each channel is multiplied by intensityScale and then clamped to 0-1 before conversion to a byte.
+    /// \param pixels Target memory, null to disable texture output. Needs to stay valid until the next update is done.
+    void SetTextureOutput(uint8_t* pixels, float intensityScale) noexcept
+    {
+        texturePixels = pixels;
+        textureIntensityScale = intensityScale;
+    }
+
+    [[nodiscard]] bool HasTextureOutput() const noexcept
+    {
+        return texturePixels != nullptr;
+    }
+
+    [[nodiscard]] int GetSize() const noexcept
+    {
+        return size;
+    }
+
+private:
+    [[nodiscard]] FORCE_INLINE float* DensityChannel(int channel) const noexcept
+    {
+        return density + static_cast<size_t>(channel) * size * rowStride;
+    }
+
+    [[nodiscard]] FORCE_INLINE float* OldDensityChannel(int channel) const noexcept
+    {
+        return oldDensity + static_cast<size_t>(channel) * size * rowStride;
+    }
+
+    [[nodiscard]] FORCE_INLINE size_t CellIndex(int x, int y) const noexcept
+    {
+        return static_cast<size_t>(x) * rowStride + y;
+    }
+
+    [[nodiscard]] Region GetSquare(int index) const noexcept;
+
+    /// \brief Edge strips between the squares that are simulated, depends on the plane position
+    void CollectEdgeRegions(std::vector<Region>& regions) const;
+
+    /// \brief Diffuses the inside of a square and then clears its density for advection to fill in again
+    void DiffuseAndClearSquare(int square, float delta);
+
+    void AdvectSquare(int square, float delta);
+
+    void DiffuseEdges(const Region& region, float delta);
+    void AdvectEdges(const Region& region, float delta);
+
+    void DiffuseCenter(const Region& region, float delta);
+    void ClearDensity(const Region& region);
+
+    /// \brief Moves the old density of a square inside to the new density. The movement is clamped to stay inside
+    /// the square. Cells on the border of the square can be written by neighbouring squares so those are written
+    /// atomically.
+    void AdvectCenter(const Region& region, const Region& square, float delta);
+
+    /// \brief Writes the texture pixels for image rows [firstRow, firstRow + TEXTURE_ROW_BLOCK)
+    void WriteTextureRows(int firstRow) const noexcept;
+
+    void SampleVelocity(float x, float y, float& velocityXResult, float& velocityYResult) const noexcept;
+
+    /// \brief Adds density moved from one cell to the 2x2 cells around the target position
+    template<bool Atomic>
+    void AddMovedDensity(const float* amounts, int q0, int q1, int r0, int r1, float s0, float s1, float t0,
+        float t1) const noexcept;
+
+private:
+    const int size;
+    const int rowStride;
+
+    float* const density;
+    float* const oldDensity;
+
+    const float diffusionRate;
+    const float viscosity;
+
+    std::array<float, CHANNELS> decayRates{1, 1, 1, 1};
+
+    int planeX = 0;
+    int planeY = 0;
+
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    int velocityWidth = 0;
+    int velocityHeight = 0;
+    float velocitySpacing = 1;
+
+    uint8_t* texturePixels = nullptr;
+    float textureIntensityScale = 1;
+};
+
+} // namespace Thrive::Simulation
@@ -0,0 +1,479 @@
+// ------------------------------------ //
+#include "FluidCurrents.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef THRIVE_USE_AVX2
+#include <immintrin.h>
+#endif
+
+#include "core/ParallelFor.hpp"
+#include "core/Tracing.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Simulation
+{
+
+// These need to match the values the C# FluidCurrentsSystem used with FastNoiseLite
+constexpr float NoiseFrequency = 0.01f;
+constexpr float DisturbanceTimescale = 1.0f;
+constexpr float CurrentsTimescale = 1.0f / 500.0f;
+constexpr float CurrentsStretchingMultiplier = 1.0f / 10.0f;
+constexpr float MinCurrentIntensity = 0.4f;
+constexpr float DisturbanceToCurrentsRatio = 0.15f;
+constexpr float PositionScaling = 0.9f;
+
+// Perlin noise constants from FastNoiseLite
+constexpr uint32_t PrimeX = 501125321;
+constexpr uint32_t PrimeY = 1136930381;
+constexpr uint32_t PrimeZ = 1720413743;
+constexpr uint32_t HashMultiplier = 0x27d4eb2d;
+constexpr uint32_t GradientIndexMask = 63 << 2;
+constexpr float PerlinScale = 0.964921414852142333984375f;
+
+/// \brief Number of positions whose noise is calculated at once before it is combined to velocities
+constexpr size_t NoiseBlockSize = 64;
+
+enum NoiseChannel
+{
+    DisturbancesX = 0,
+    DisturbancesY,
+    CurrentsX,
+    CurrentsY
+};
+
+struct NoiseField
+{
+    uint32_t Seed;
+    float ScaleX;
+    float ScaleY;
+    float Timescale;
+};
+
+/// \brief The noise fields in the order of NoiseChannel
+constexpr NoiseField NoiseFields[FluidCurrents::GRID_CHANNELS] = {
+    {69, 1, 1, DisturbanceTimescale},
+    {13, 1, 1, DisturbanceTimescale},
+    {420, CurrentsStretchingMultiplier, 1, CurrentsTimescale},
+    {1337, 1, CurrentsStretchingMultiplier, CurrentsTimescale},
+};
+
+/// \brief 3D gradients of FastNoiseLite, each gradient is padded to 4 values
+alignas(32) static constexpr float Gradients3D[256] = {
+    0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 1, 0, 1, 0, -1, 0, 1, 0, 1, 0, -1, 0, -1, 0, -1, 0, //
+    1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 0, 0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, //
+    1, 0, 1, 0, -1, 0, 1, 0, 1, 0, -1, 0, -1, 0, -1, 0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 0, //
+    0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 1, 0, 1, 0, -1, 0, 1, 0, 1, 0, -1, 0, -1, 0, -1, 0, //
+    1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 0, 0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, //
+    1, 0, 1, 0, -1, 0, 1, 0, 1, 0, -1, 0, -1, 0, -1, 0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 0, //
+    0, 1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 1, 0, 1, 0, -1, 0, 1, 0, 1, 0, -1, 0, -1, 0, -1, 0, //
+    1, 1, 0, 0, -1, 1, 0, 0, 1, -1, 0, 0, -1, -1, 0, 0, 1, 1, 0, 0, 0, -1, 1, 0, -1, 1, 0, 0, 0, -1, -1, 0, //
+};
+
+// ------------------------------------ //
+// Scalar noise, this is the same as FastNoiseLite except that floats are used for the coordinates
+
+/// \brief Rounds down, except that negative integers are also decremented like FastNoiseLite does
+static FORCE_INLINE int32_t FastFloor(float value)
+{
+    return value >= 0 ? static_cast<int32_t>(value) : static_cast<int32_t>(value) - 1;
+}
+
+static FORCE_INLINE float InterpolateQuintic(float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static FORCE_INLINE float Lerp(float a, float b, float t)
+{
+    return a + t * (b - a);
+}
+
+/// \brief Dot product of the offset and a pseudorandom gradient of a grid corner. Unsigned integers are used for the
+/// hashing to get the same wrapping results as the C# version.
+static FORCE_INLINE float GradientDot(
+    uint32_t seed, uint32_t xPrimed, uint32_t yPrimed, uint32_t zPrimed, float xd, float yd, float zd)
+{
+    auto hash = (seed ^ xPrimed ^ yPrimed ^ zPrimed) * HashMultiplier;
+    hash ^= hash >> 15;
+    hash &= GradientIndexMask;
+
+    return xd * Gradients3D[hash] + yd * Gradients3D[hash | 1] + zd * Gradients3D[hash | 2];
+}
+
+static float PerlinNoise(uint32_t seed, float x, float y, float z)
+{
+    const auto xFloor = FastFloor(x);
+    const auto yFloor = FastFloor(y);
+    const auto zFloor = FastFloor(z);
+
+    const auto xd0 = x - static_cast<float>(xFloor);
+    const auto yd0 = y - static_cast<float>(yFloor);
+    const auto zd0 = z - static_cast<float>(zFloor);
+    const auto xd1 = xd0 - 1;
+    const auto yd1 = yd0 - 1;
+    const auto zd1 = zd0 - 1;
+
+    const auto xs = InterpolateQuintic(xd0);
+    const auto ys = InterpolateQuintic(yd0);
+    const auto zs = InterpolateQuintic(zd0);
+
+    const auto x0 = static_cast<uint32_t>(xFloor) * PrimeX;
+    const auto y0 = static_cast<uint32_t>(yFloor) * PrimeY;
+    const auto z0 = static_cast<uint32_t>(zFloor) * PrimeZ;
+    const auto x1 = x0 + PrimeX;
+    const auto y1 = y0 + PrimeY;
+    const auto z1 = z0 + PrimeZ;
+
+    const auto xf00 =
+        Lerp(GradientDot(seed, x0, y0, z0, xd0, yd0, zd0), GradientDot(seed, x1, y0, z0, xd1, yd0, zd0), xs);
+    const auto xf10 =
+        Lerp(GradientDot(seed, x0, y1, z0, xd0, yd1, zd0), GradientDot(seed, x1, y1, z0, xd1, yd1, zd0), xs);
+    const auto xf01 =
+        Lerp(GradientDot(seed, x0, y0, z1, xd0, yd0, zd1), GradientDot(seed, x1, y0, z1, xd1, yd0, zd1), xs);
+    const auto xf11 =
+        Lerp(GradientDot(seed, x0, y1, z1, xd0, yd1, zd1), GradientDot(seed, x1, y1, z1, xd1, yd1, zd1), xs);
+
+    const auto yf0 = Lerp(xf00, xf10, ys);
+    const auto yf1 = Lerp(xf01, xf11, ys);
+
+    return Lerp(yf0, yf1, zs) * PerlinScale;
+}
+
+// ------------------------------------ //
+// Vectorized versions of the above that calculate 8 positions at once. No FMA is used so that the results are exactly
+// the same as with the scalar code.
+#ifdef THRIVE_USE_AVX2
+
+static FORCE_INLINE __m256i FastFloor(__m256 value)
+{
+    // The comparison result is -1 for negative values
+    const auto negative = _mm256_castps_si256(_mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_LT_OQ));
+    return _mm256_add_epi32(_mm256_cvttps_epi32(value), negative);
+}
+
+static FORCE_INLINE __m256 InterpolateQuintic(__m256 t)
+{
+    const auto cubed = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+
+    auto polynomial = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6)), _mm256_set1_ps(15));
+    polynomial = _mm256_add_ps(_mm256_mul_ps(t, polynomial), _mm256_set1_ps(10));
+
+    return _mm256_mul_ps(cubed, polynomial);
+}
+
+static FORCE_INLINE __m256 Lerp(__m256 a, __m256 b, __m256 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+static FORCE_INLINE __m256 GradientDot(
+    __m256i seed, __m256i xPrimed, __m256i yPrimed, __m256i zPrimed, __m256 xd, __m256 yd, __m256 zd)
+{
+    auto hash = _mm256_xor_si256(_mm256_xor_si256(seed, xPrimed), _mm256_xor_si256(yPrimed, zPrimed));
+    hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(static_cast<int>(HashMultiplier)));
+    hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 15));
+    hash = _mm256_and_si256(hash, _mm256_set1_epi32(GradientIndexMask));
+
+    const auto one = _mm256_set1_epi32(1);
+    const auto two = _mm256_set1_epi32(2);
+
+    const auto xGradient = _mm256_i32gather_ps(Gradients3D, hash, sizeof(float));
+    const auto yGradient = _mm256_i32gather_ps(Gradients3D, _mm256_or_si256(hash, one), sizeof(float));
+    const auto zGradient = _mm256_i32gather_ps(Gradients3D, _mm256_or_si256(hash, two), sizeof(float));
+
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xd, xGradient), _mm256_mul_ps(yd, yGradient)),
+        _mm256_mul_ps(zd, zGradient));
+}
+
+static FORCE_INLINE __m256 PerlinNoise(uint32_t seedValue, __m256 x, __m256 y, __m256 z)
+{
+    const auto seed = _mm256_set1_epi32(static_cast<int>(seedValue));
+
+    const auto xFloor = FastFloor(x);
+    const auto yFloor = FastFloor(y);
+    const auto zFloor = FastFloor(z);
+
+    const auto one = _mm256_set1_ps(1);
+
+    const auto xd0 = _mm256_sub_ps(x, _mm256_cvtepi32_ps(xFloor));
+    const auto yd0 = _mm256_sub_ps(y, _mm256_cvtepi32_ps(yFloor));
+    const auto zd0 = _mm256_sub_ps(z, _mm256_cvtepi32_ps(zFloor));
+    const auto xd1 = _mm256_sub_ps(xd0, one);
+    const auto yd1 = _mm256_sub_ps(yd0, one);
+    const auto zd1 = _mm256_sub_ps(zd0, one);
+
+    const auto xs = InterpolateQuintic(xd0);
+    const auto ys = InterpolateQuintic(yd0);
+    const auto zs = InterpolateQuintic(zd0);
+
+    const auto primeX = _mm256_set1_epi32(static_cast<int>(PrimeX));
+    const auto primeY = _mm256_set1_epi32(static_cast<int>(PrimeY));
+    const auto primeZ = _mm256_set1_epi32(static_cast<int>(PrimeZ));
+
+    const auto x0 = _mm256_mullo_epi32(xFloor, primeX);
+    const auto y0 = _mm256_mullo_epi32(yFloor, primeY);
+    const auto z0 = _mm256_mullo_epi32(zFloor, primeZ);
+    const auto x1 = _mm256_add_epi32(x0, primeX);
+    const auto y1 = _mm256_add_epi32(y0, primeY);
+    const auto z1 = _mm256_add_epi32(z0, primeZ);
+
+    const auto xf00 =
+        Lerp(GradientDot(seed, x0, y0, z0, xd0, yd0, zd0), GradientDot(seed, x1, y0, z0, xd1, yd0, zd0), xs);
+    const auto xf10 =
+        Lerp(GradientDot(seed, x0, y1, z0, xd0, yd1, zd0), GradientDot(seed, x1, y1, z0, xd1, yd1, zd0), xs);
+    const auto xf01 =
+        Lerp(GradientDot(seed, x0, y0, z1, xd0, yd0, zd1), GradientDot(seed, x1, y0, z1, xd1, yd0, zd1), xs);
+    const auto xf11 =
+        Lerp(GradientDot(seed, x0, y1, z1, xd0, yd1, zd1), GradientDot(seed, x1, y1, z1, xd1, yd1, zd1), xs);
+
+    const auto yf0 = Lerp(xf00, xf10, ys);
+    const auto yf1 = Lerp(xf01, xf11, ys);
+
+    return _mm256_mul_ps(Lerp(yf0, yf1, zs), _mm256_set1_ps(PerlinScale));
+}
+
+#endif
+
+// ------------------------------------ //
+/// \brief Currents below the minimum intensity don't move anything
+static FORCE_INLINE float CurrentStrength(float value)
+{
+    return std::abs(value) > MinCurrentIntensity ? value : 0;
+}
+
+static FORCE_INLINE float CombineVelocity(float disturbance, float current)
+{
+    return disturbance * DisturbanceToCurrentsRatio + CurrentStrength(current) * (1.0f - DisturbanceToCurrentsRatio);
+}
+
+// ------------------------------------ //
+void FluidCurrents::CalculateVelocities(
+    const float* positionsX, const float* positionsY, size_t count, float* resultX, float* resultY) const
+{
+    TRACE_SCOPE("FluidCurrentVelocities");
+
+    ParallelFor(count, PARALLEL_BATCH_SIZE,
+        [this, positionsX, positionsY, resultX, resultY](size_t start, size_t end)
+        {
+            CalculateRange(
+                currentTime, positionsX + start, positionsY + start, end - start, resultX + start, resultY + start);
+        });
+}
+
+void FluidCurrents::SampleVelocities(
+    const float* positionsX, const float* positionsY, size_t count, float* resultX, float* resultY) const
+{
+    if (!HasGrid())
+    {
+        CalculateVelocities(positionsX, positionsY, count, resultX, resultY);
+        return;
+    }
+
+    TRACE_SCOPE("FluidCurrentSampling");
+
+    ParallelFor(count, PARALLEL_BATCH_SIZE,
+        [this, positionsX, positionsY, resultX, resultY](size_t start, size_t end)
+        {
+            // Positions outside the grid are collected to be calculated in blocks
+            size_t missedIndices[NoiseBlockSize];
+            float missedX[NoiseBlockSize];
+            float missedY[NoiseBlockSize];
+            float missedResultX[NoiseBlockSize];
+            float missedResultY[NoiseBlockSize];
+            size_t missedCount = 0;
+
+            const auto calculateMissed = [&]()
+            {
+                CalculateRange(currentTime, missedX, missedY, missedCount, missedResultX, missedResultY);
+
+                for (size_t i = 0; i < missedCount; ++i)
+                {
+                    resultX[missedIndices[i]] = missedResultX[i];
+                    resultY[missedIndices[i]] = missedResultY[i];
+                }
+
+                missedCount = 0;
+            };
+
+            for (size_t i = start; i < end; ++i)
+            {
+                if (SampleGrid(positionsX[i], positionsY[i], resultX[i], resultY[i])) [[likely]]
+                    continue;
+
+                missedIndices[missedCount] = i;
+                missedX[missedCount] = positionsX[i];
+                missedY[missedCount] = positionsY[i];
+
+                if (++missedCount >= NoiseBlockSize)
+                    calculateMissed();
+            }
+
+            if (missedCount > 0)
+                calculateMissed();
+        });
+}
+
+void FluidCurrents::CalculateVelocitiesAtTime(float time, const float* positionsX, const float* positionsY,
+    size_t count, float* resultX, float* resultY) const noexcept
+{
+    CalculateRange(time, positionsX, positionsY, count, resultX, resultY);
+}
+
+void FluidCurrents::UpdateGrid(float originX, float originY, float spacing, int width, int height)
+{
+    if (width < 2 || height < 2 || spacing <= 0)
+    {
+        gridWidth = 0;
+        gridHeight = 0;
+        return;
+    }
+
+    TRACE_SCOPE("FluidCurrentGrid");
+
+    const auto count = static_cast<size_t>(width) * height;
+
+    for (auto& channel : gridNoise)
+        channel.resize(count);
+
+    gridOriginX = originX;
+    gridOriginY = originY;
+    gridSpacing = spacing;
+    gridWidth = width;
+    gridHeight = height;
+
+    // Each task calculates whole grid columns (constant x)
+    ParallelFor(static_cast<size_t>(width), std::max<size_t>(PARALLEL_BATCH_SIZE / height, 1),
+        [this](size_t start, size_t end)
+        {
+            std::vector<float> columnX(gridHeight);
+            std::vector<float> columnY(gridHeight);
+
+            for (int j = 0; j < gridHeight; ++j)
+                columnY[j] = gridOriginY + static_cast<float>(j) * gridSpacing;
+
+            for (size_t i = start; i < end; ++i)
+            {
+                std::fill(columnX.begin(), columnX.end(), gridOriginX + static_cast<float>(i) * gridSpacing);
+
+                const auto offset = i * gridHeight;
+
+                float* results[GRID_CHANNELS] = {gridNoise[0].data() + offset, gridNoise[1].data() + offset,
+                    gridNoise[2].data() + offset, gridNoise[3].data() + offset};
+
+                CalculateNoise(currentTime, columnX.data(), columnY.data(), gridHeight, results);
+            }
+        });
+}
+
+// ------------------------------------ //
+void FluidCurrents::CalculateRange(float time, const float* positionsX, const float* positionsY, size_t count,
+    float* resultX, float* resultY) const noexcept
+{
+    float noise[GRID_CHANNELS][NoiseBlockSize];
+    float* noiseResults[GRID_CHANNELS] = {noise[0], noise[1], noise[2], noise[3]};
+
+    for (size_t blockStart = 0; blockStart < count; blockStart += NoiseBlockSize)
+    {
+        const auto blockSize = std::min(NoiseBlockSize, count - blockStart);
+
+        CalculateNoise(time, positionsX + blockStart, positionsY + blockStart, blockSize, noiseResults);
+
+        for (size_t i = 0; i < blockSize; ++i)
+        {
+            resultX[blockStart + i] = CombineVelocity(noise[DisturbancesX][i], noise[CurrentsX][i]);
+            resultY[blockStart + i] = CombineVelocity(noise[DisturbancesY][i], noise[CurrentsY][i]);
+        }
+    }
+}
+
+void FluidCurrents::CalculateNoise(float time, const float* positionsX, const float* positionsY, size_t count,
+    float* const* noiseResults) const noexcept
+{
+    // The time is the third noise coordinate, which is the same for all positions
+    float noiseZ[GRID_CHANNELS];
+
+    for (int channel = 0; channel < GRID_CHANNELS; ++channel)
+        noiseZ[channel] = time * NoiseFields[channel].Timescale * NoiseFrequency;
+
+    size_t i = 0;
+
+#ifdef THRIVE_USE_AVX2
+    const auto positionScaling = _mm256_set1_ps(PositionScaling);
+    const auto frequency = _mm256_set1_ps(NoiseFrequency);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm256_mul_ps(_mm256_loadu_ps(positionsX + i), positionScaling);
+        const auto y = _mm256_mul_ps(_mm256_loadu_ps(positionsY + i), positionScaling);
+
+        for (int channel = 0; channel < GRID_CHANNELS; ++channel)
+        {
+            const auto& field = NoiseFields[channel];
+
+            const auto noiseX = _mm256_mul_ps(_mm256_mul_ps(x, _mm256_set1_ps(field.ScaleX)), frequency);
+            const auto noiseY = _mm256_mul_ps(_mm256_mul_ps(y, _mm256_set1_ps(field.ScaleY)), frequency);
+
+            _mm256_storeu_ps(
+                noiseResults[channel] + i, PerlinNoise(field.Seed, noiseX, noiseY, _mm256_set1_ps(noiseZ[channel])));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const auto x = positionsX[i] * PositionScaling;
+        const auto y = positionsY[i] * PositionScaling;
+
+        for (int channel = 0; channel < GRID_CHANNELS; ++channel)
+        {
+            const auto& field = NoiseFields[channel];
+
+            noiseResults[channel][i] =
+                PerlinNoise(field.Seed, x * field.ScaleX * NoiseFrequency, y * field.ScaleY * NoiseFrequency,
+                    noiseZ[channel]);
+        }
+    }
+}
+
+bool FluidCurrents::SampleGrid(float x, float y, float& resultX, float& resultY) const noexcept
+{
+    const auto gridX = (x - gridOriginX) / gridSpacing;
+    const auto gridY = (y - gridOriginY) / gridSpacing;
+
+    // Written so that NaN positions are also outside
+    if (!(gridX >= 0 && gridY >= 0 && gridX <= static_cast<float>(gridWidth - 1) &&
+            gridY <= static_cast<float>(gridHeight - 1)))
+    {
+        return false;
+    }
+
+    const auto x0 = std::min(static_cast<int>(gridX), gridWidth - 2);
+    const auto y0 = std::min(static_cast<int>(gridY), gridHeight - 2);
+
+    const auto tx = gridX - static_cast<float>(x0);
+    const auto ty = gridY - static_cast<float>(y0);
+
+    const auto index00 = static_cast<size_t>(x0) * gridHeight + y0;
+    const auto index10 = index00 + gridHeight;
+
+    float noise[GRID_CHANNELS];
+
+    // The noise values are interpolated instead of the velocities so that the minimum current intensity cutoff
+    // stays as sharp as it is without the grid
+    for (int channel = 0; channel < GRID_CHANNELS; ++channel)
+    {
+        const auto* values = gridNoise[channel].data();
+
+        const auto first = values[index00] + (values[index00 + 1] - values[index00]) * ty;
+        const auto second = values[index10] + (values[index10 + 1] - values[index10]) * ty;
+        noise[channel] = first + (second - first) * tx;
+    }
+
+    resultX = CombineVelocity(noise[DisturbancesX], noise[CurrentsX]);
+    resultY = CombineVelocity(noise[DisturbancesY], noise[CurrentsY]);
+    return true;
+}
+
+} // namespace Thrive::Simulation
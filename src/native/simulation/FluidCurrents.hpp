@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/ForwardDefinitions.hpp"
+#include "core/RefCounted.hpp"
+
+namespace Thrive::Simulation
+{
+
+/// \brief Calculates the velocity of the fluid currents in the microbe stage
+///
+/// The velocity is made from 4 Perlin noise fields (small disturbances and the larger currents for both axes) that
+/// are calculated the same way as the FastNoiseLite library used to do it on the C# side. Velocities are always
+/// calculated for batches of positions and with AVX2 8 positions are calculated at once.
+///
+/// To avoid calculating the noise for every single entity and compound cloud cell a coarse grid of the noise values
+/// can be calculated once per frame. Positions inside the grid are then sampled from it with bilinear interpolation.
+class FluidCurrents : public RefCountedBasic
+{
+public:
+    /// \brief Number of positions calculated in one task when a batch is split between threads
+    static constexpr size_t PARALLEL_BATCH_SIZE = 1024;
+
+    /// \brief How many noise values are stored for each grid point
+    static constexpr int GRID_CHANNELS = 4;
+
+public:
+    FluidCurrents() = default;
+
+    /// \brief Sets the time of the noise, which makes the currents change over time
+    void SetTime(float time) noexcept
+    {
+        currentTime = time;
+    }
+
+    [[nodiscard]] float GetTime() const noexcept
+    {
+        return currentTime;
+    }
+
+    /// \brief Calculates the velocities at the given positions without using the grid
+    ///
+    /// Large batches are split between the task threads.
+    void CalculateVelocities(const float* positionsX, const float* positionsY, size_t count, float* resultX,
+        float* resultY) const;
+
+    /// \brief Calculates the velocities at the given time on the calling thread
+    ///
+    /// Doesn't use the grid or the time set on this object so this is safe to call from other threads (for example
+    /// the physics thread) while the currents are updated.
+    void CalculateVelocitiesAtTime(float time, const float* positionsX, const float* positionsY, size_t count,
+        float* resultX, float* resultY) const noexcept;
+
+    /// \brief Calculates velocities, using the grid for positions inside it
+    void SampleVelocities(const float* positionsX, const float* positionsY, size_t count, float* resultX,
+        float* resultY) const;
+
+    /// \brief Calculates the noise grid for the current time
+    ///
+    /// Point (i, j) of the grid is at (originX + i * spacing, originY + j * spacing). Width or height of 0 removes
+    /// the grid. Must not be called while velocities are being sampled on other threads.
+    void UpdateGrid(float originX, float originY, float spacing, int width, int height);
+
+    [[nodiscard]] bool HasGrid() const noexcept
+    {
+        return gridWidth > 1 && gridHeight > 1;
+    }
+
+private:
+    /// \brief Calculates the velocities of count positions on the calling thread
+    void CalculateRange(float time, const float* positionsX, const float* positionsY, size_t count, float* resultX,
+        float* resultY) const noexcept;
+
+    /// \brief Calculates the raw noise values (one array per channel) without combining them to velocities
+    void CalculateNoise(float time, const float* positionsX, const float* positionsY, size_t count,
+        float* const* noiseResults) const noexcept;
+
+    /// \brief Samples one position from the grid. Returns false if the position is outside the grid.
+    bool SampleGrid(float x, float y, float& resultX, float& resultY) const noexcept;
+
+private:
+    float currentTime = 0;
+
+    /// \brief Noise values of the grid points, each channel is x-major (index i * height + j)
+    std::vector<float> gridNoise[GRID_CHANNELS];
+
+    float gridOriginX = 0;
+    float gridOriginY = 0;
+    float gridSpacing = 1;
+    int gridWidth = 0;
+    int gridHeight = 0;
+};
+
+} // namespace Thrive::Simulation
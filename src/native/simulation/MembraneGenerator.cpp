@@ -0,0 +1,530 @@
+// ------------------------------------ //
+#include "MembraneGenerator.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+#ifdef THRIVE_USE_AVX2
+#include <immintrin.h>
+#endif
+
+#include "core/Logger.hpp"
+
+// ------------------------------------ //
+namespace Thrive::Simulation
+{
+
+// These need to match the MEMBRANE_ constants in Constants.cs
+constexpr float RoomForOrganelles = 1.9f;
+constexpr float NumberOfWaves = 9.0f;
+constexpr float WaveHeightDependenceOnSize = 0.3f;
+constexpr float WaveHeightMultiplier = 0.025f;
+constexpr float WaveHeightMultiplierCellWall = 0.015f;
+constexpr float SmoothingPower = 3.0f;
+constexpr float SideRounding = 20.0f;
+constexpr float EngulfAnimationDistance = 1.25f;
+
+/// \brief Same value as MathF.PI
+constexpr float Pi = 3.14159265358979323846f;
+
+constexpr float EngulfMeshHeight = 0.1f;
+
+// The point calculations are done with the same operation order as the C# code used to, so that the points don't
+// change (which would for example affect the cached data and saves)
+
+static FORCE_INLINE float Length(float x, float y) noexcept
+{
+    return std::sqrt(x * x + y * y);
+}
+
+/// \brief Normalizes the same way as Godot: a zero vector stays as zero
+static FORCE_INLINE void Normalize(float& x, float& y) noexcept
+{
+    const float lengthSquared = x * x + y * y;
+
+    if (lengthSquared == 0) [[unlikely]]
+    {
+        x = 0;
+        y = 0;
+        return;
+    }
+
+    const float length = std::sqrt(lengthSquared);
+    x /= length;
+    y /= length;
+}
+
+static FORCE_INLINE void Normalize(float& x, float& y, float& z) noexcept
+{
+    const float lengthSquared = x * x + y * y + z * z;
+
+    if (lengthSquared == 0) [[unlikely]]
+    {
+        x = 0;
+        y = 0;
+        z = 0;
+        return;
+    }
+
+    const float length = std::sqrt(lengthSquared);
+    x /= length;
+    y /= length;
+    z /= length;
+}
+
+// ------------------------------------ //
+int MembraneGenerator::GeneratePoints(
+    const float* hexPositions, int hexCount, bool cellWall, float* pointsResult)
+{
+    if (hexCount < 0) [[unlikely]]
+    {
+        LOG_ERROR("Negative hex count given to membrane generation");
+        return 0;
+    }
+
+    // Half the side length of the square that is compressed to make the membrane
+    int cellDimensions = 10;
+
+    for (int i = 0; i < hexCount; ++i)
+    {
+        const float x = std::abs(hexPositions[i * 2]);
+        const float y = std::abs(hexPositions[i * 2 + 1]);
+
+        if (x + 1 > static_cast<float>(cellDimensions))
+            cellDimensions = static_cast<int>(x) + 1;
+
+        if (y + 1 > static_cast<float>(cellDimensions))
+            cellDimensions = static_cast<int>(y) + 1;
+    }
+
+    // Make the length longer to guarantee that everything fits easily inside the square
+    cellDimensions *= 100;
+
+    alignas(32) float startX[MAX_POINTS];
+    alignas(32) float startY[MAX_POINTS];
+
+    // Integer divides are intentional here
+    const int step = 2 * cellDimensions / RESOLUTION;
+
+    for (int i = RESOLUTION, index = 0; i > 0; --i, ++index)
+    {
+        startX[index] = static_cast<float>(-cellDimensions);
+        startY[index] = static_cast<float>(cellDimensions - step * i);
+
+        startX[index + RESOLUTION] = static_cast<float>(cellDimensions - step * i);
+        startY[index + RESOLUTION] = static_cast<float>(cellDimensions);
+
+        startX[index + RESOLUTION * 2] = static_cast<float>(cellDimensions);
+        startY[index + RESOLUTION * 2] = static_cast<float>(-cellDimensions + step * i);
+
+        startX[index + RESOLUTION * 3] = static_cast<float>(-cellDimensions + step * i);
+        startY[index + RESOLUTION * 3] = static_cast<float>(-cellDimensions);
+    }
+
+    // Move all the starting points close to the organelles. This is done in a single step instead of iteratively.
+    alignas(32) float closestX[MAX_POINTS];
+    alignas(32) float closestY[MAX_POINTS];
+
+    FindClosestHexes(hexPositions, hexCount, startX, startY, MAX_POINTS, closestX, closestY);
+
+    for (int i = 0; i < MAX_POINTS; ++i)
+    {
+        float directionX = startX[i] - closestX[i];
+        float directionY = startY[i] - closestY[i];
+        Normalize(directionX, directionY);
+
+        startX[i] = closestX[i] + directionX * RoomForOrganelles;
+        startY[i] = closestY[i] + directionY * RoomForOrganelles;
+    }
+
+    float circumference = 0;
+
+    for (int i = 0; i < MAX_POINTS; ++i)
+    {
+        const int next = (i + 1) % MAX_POINTS;
+        circumference += Length(startX[next] - startX[i], startY[next] - startY[i]);
+    }
+
+    // Go around the membrane and place points evenly in the result
+    pointsResult[0] = startX[0];
+    pointsResult[1] = startY[0];
+    int count = 1;
+
+    const float gap = circumference / MAX_POINTS;
+    float distanceToLastAddedPoint = 0;
+    float distanceToLastPassedPoint = 0;
+
+    for (int i = 0; i < MAX_POINTS; ++i)
+    {
+        const int next = (i + 1) % MAX_POINTS;
+        const float currentX = startX[i];
+        const float currentY = startY[i];
+        const float differenceX = startX[next] - currentX;
+        const float differenceY = startY[next] - currentY;
+        const float distance = Length(differenceX, differenceY);
+
+        // Add a new point if the next point is too far
+        if (distance + distanceToLastAddedPoint - distanceToLastPassedPoint > gap)
+        {
+            float directionX = differenceX;
+            float directionY = differenceY;
+            Normalize(directionX, directionY);
+
+            const float movement = gap - distanceToLastAddedPoint + distanceToLastPassedPoint;
+
+            const float addedX = currentX + directionX * movement;
+            const float addedY = currentY + directionY * movement;
+
+            pointsResult[count * 2] = addedX;
+            pointsResult[count * 2 + 1] = addedY;
+            ++count;
+
+            if (count >= MAX_POINTS)
+                break;
+
+            distanceToLastPassedPoint = Length(addedX - currentX, addedY - currentY);
+            distanceToLastAddedPoint = 0;
+            --i;
+        }
+        else
+        {
+            distanceToLastAddedPoint += distance - distanceToLastPassedPoint;
+            distanceToLastPassedPoint = 0;
+        }
+    }
+
+    // Make the membrane wavier
+    const float waveFrequency = 2.0f * Pi * NumberOfWaves / static_cast<float>(count);
+
+    const float waveHeight = std::pow(circumference, WaveHeightDependenceOnSize) *
+        (cellWall ? WaveHeightMultiplierCellWall : WaveHeightMultiplier);
+
+    for (int i = 0; i < count; ++i)
+    {
+        // The last point uses the already moved first point like the C# code did
+        const int next = (i + 1) % count;
+        float directionX = pointsResult[next * 2] - pointsResult[i * 2];
+        float directionY = pointsResult[next * 2 + 1] - pointsResult[i * 2 + 1];
+        Normalize(directionX, directionY);
+
+        // Turned 90 degrees
+        const float sine = std::sin(waveFrequency * static_cast<float>(i));
+
+        pointsResult[i * 2] += -directionY * sine * waveHeight;
+        pointsResult[i * 2 + 1] += directionX * sine * waveHeight;
+    }
+
+    return count;
+}
+
+// ------------------------------------ //
+void MembraneGenerator::FindClosestHexes(const float* hexPositions, int hexCount, const float* pointsX,
+    const float* pointsY, int count, float* closestX, float* closestY) noexcept
+{
+    int i = 0;
+
+#ifdef THRIVE_USE_AVX2
+    // 8 points are checked against each hex at once. The comparison is strict so that the first hex at the closest
+    // distance is picked, like in the scalar version.
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm256_loadu_ps(pointsX + i);
+        const auto y = _mm256_loadu_ps(pointsY + i);
+
+        auto closestDistance = _mm256_set1_ps(FLT_MAX);
+        auto resultX = _mm256_setzero_ps();
+        auto resultY = _mm256_setzero_ps();
+
+        for (int hex = 0; hex < hexCount; ++hex)
+        {
+            const auto hexX = _mm256_set1_ps(hexPositions[hex * 2]);
+            const auto hexY = _mm256_set1_ps(hexPositions[hex * 2 + 1]);
+
+            const auto differenceX = _mm256_sub_ps(x, hexX);
+            const auto differenceY = _mm256_sub_ps(y, hexY);
+
+            const auto distance =
+                _mm256_add_ps(_mm256_mul_ps(differenceX, differenceX), _mm256_mul_ps(differenceY, differenceY));
+
+            const auto closer = _mm256_cmp_ps(distance, closestDistance, _CMP_LT_OQ);
+
+            closestDistance = _mm256_blendv_ps(closestDistance, distance, closer);
+            resultX = _mm256_blendv_ps(resultX, hexX, closer);
+            resultY = _mm256_blendv_ps(resultY, hexY, closer);
+        }
+
+        _mm256_storeu_ps(closestX + i, resultX);
+        _mm256_storeu_ps(closestY + i, resultY);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float closestDistance = FLT_MAX;
+        float resultX = 0;
+        float resultY = 0;
+
+        for (int hex = 0; hex < hexCount; ++hex)
+        {
+            const float hexX = hexPositions[hex * 2];
+            const float hexY = hexPositions[hex * 2 + 1];
+
+            const float differenceX = pointsX[i] - hexX;
+            const float differenceY = pointsY[i] - hexY;
+            const float distance = differenceX * differenceX + differenceY * differenceY;
+
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                resultX = hexX;
+                resultY = hexY;
+            }
+        }
+
+        closestX[i] = resultX;
+        closestY[i] = resultY;
+    }
+}
+
+// ------------------------------------ //
+void MembraneGenerator::BuildMesh(const float* points, int pointCount, float height, float* vertices,
+    float* normals, float* uvs, int32_t* indices)
+{
+    if (pointCount < 3) [[unlikely]]
+    {
+        LOG_ERROR("Membrane mesh needs at least 3 points");
+        return;
+    }
+
+    // Average of all outline points
+    float centerX = 0;
+    float centerZ = 0;
+
+    for (int i = 0; i < pointCount; ++i)
+    {
+        centerX += points[i * 2];
+        centerZ += points[i * 2 + 1];
+    }
+
+    centerX /= static_cast<float>(pointCount);
+    centerZ /= static_cast<float>(pointCount);
+
+    // Place prism points, already with squishification. Point i of layer l is at index i + l * pointCount.
+    const float roundingMaximum = std::pow(1.0f + SideRounding * 1.05f, SmoothingPower);
+    constexpr float roundingMinimum = 1.0f;
+
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        const int layerOffset = layer - VERTICAL_RESOLUTION;
+
+        const float widthModifier = 1.0f -
+            (std::pow(SideRounding * static_cast<float>(std::abs(layerOffset)) / VERTICAL_RESOLUTION + 1.0f,
+                 SmoothingPower) -
+                roundingMinimum) /
+                roundingMaximum;
+
+        const float vertical = height * static_cast<float>(layerOffset) / VERTICAL_RESOLUTION;
+
+        float* layerVertices = vertices + static_cast<size_t>(layer) * pointCount * 3;
+
+        for (int i = 0; i < pointCount; ++i)
+        {
+            layerVertices[i * 3] = centerX + (points[i * 2] - centerX) * widthModifier;
+            layerVertices[i * 3 + 1] = vertical;
+            layerVertices[i * 3 + 2] = centerZ + (points[i * 2 + 1] - centerZ) * widthModifier;
+        }
+    }
+
+    // The last two vertices are the bottom and the top
+    const int bottomPeak = LAYER_COUNT * pointCount;
+    const int topPeak = bottomPeak + 1;
+
+    vertices[bottomPeak * 3] = centerX;
+    vertices[bottomPeak * 3 + 1] = vertices[1];
+    vertices[bottomPeak * 3 + 2] = centerZ;
+
+    vertices[topPeak * 3] = centerX;
+    vertices[topPeak * 3 + 1] = vertices[(LAYER_COUNT - 1) * pointCount * 3 + 1];
+    vertices[topPeak * 3 + 2] = centerZ;
+
+    PlaceTriangles(pointCount, indices);
+
+    FinishMesh(pointCount, vertices, normals, uvs);
+}
+
+void MembraneGenerator::BuildEngulfMesh(
+    const float* points, int pointCount, float* vertices, float* uvs, int32_t* indices)
+{
+    // Extrusion is from this point (and not the real center of the membrane) to match how the engulf animation shader
+    // has been set up
+    constexpr float centerX = 0.5f;
+    constexpr float centerY = 0.5f;
+
+    for (int i = 0; i < pointCount; ++i)
+    {
+        const int index = i * 2;
+
+        // The reverse order is required to make the mesh respect winding order, otherwise it will get culled
+        const float sourceX = points[(pointCount - i - 1) * 2];
+        const float sourceY = points[(pointCount - i - 1) * 2 + 1];
+
+        indices[index] = index;
+        indices[index + 1] = index + 1;
+
+        vertices[index * 3] = sourceX;
+        vertices[index * 3 + 1] = EngulfMeshHeight / 2;
+        vertices[index * 3 + 2] = sourceY;
+
+        vertices[index * 3 + 3] = sourceX + (sourceX - centerX) * EngulfAnimationDistance;
+        vertices[index * 3 + 4] = EngulfMeshHeight / 2;
+        vertices[index * 3 + 5] = sourceY + (sourceY - centerY) * EngulfAnimationDistance;
+
+        // UVs are used like a distance from the membrane instead of actual texture coordinates
+        uvs[index * 2] = 0;
+        uvs[index * 2 + 1] = 0;
+        uvs[index * 2 + 2] = 0;
+        uvs[index * 2 + 3] = 1;
+    }
+
+    // Connect back to the start
+    indices[pointCount * 2] = 0;
+    indices[pointCount * 2 + 1] = 1;
+}
+
+// ------------------------------------ //
+void MembraneGenerator::PlaceTriangles(int pointCount, int32_t* indices) noexcept
+{
+    int writeIndex = 0;
+
+    // Each point forms side faces with the next point on the same layer and the same and the next point on the layer
+    // above. The top layer doesn't connect upwards.
+    for (int layer = 0; layer < LAYER_COUNT - 1; ++layer)
+    {
+        const int current = layer * pointCount;
+        const int above = (layer + 1) * pointCount;
+
+        for (int i = 0; i < pointCount - 1; ++i)
+        {
+            indices[writeIndex] = i + current;
+            indices[writeIndex + 1] = i + 1 + above;
+            indices[writeIndex + 2] = i + 1 + current;
+
+            indices[writeIndex + 3] = i + current;
+            indices[writeIndex + 4] = i + above;
+            indices[writeIndex + 5] = i + 1 + above;
+
+            writeIndex += 6;
+        }
+    }
+
+    // Final side faces that connect the last points back to the first ones
+    for (int layer = 0; layer < LAYER_COUNT - 1; ++layer)
+    {
+        const int current = layer * pointCount;
+        const int above = (layer + 1) * pointCount;
+
+        indices[writeIndex] = pointCount - 1 + current;
+        indices[writeIndex + 1] = above;
+        indices[writeIndex + 2] = current;
+
+        indices[writeIndex + 3] = pointCount - 1 + current;
+        indices[writeIndex + 4] = pointCount - 1 + above;
+        indices[writeIndex + 5] = above;
+
+        writeIndex += 6;
+    }
+
+    const int bottomPeak = LAYER_COUNT * pointCount;
+    const int topPeak = bottomPeak + 1;
+    const int topLayerStart = (LAYER_COUNT - 1) * pointCount;
+
+    // Top face triangles
+    for (int i = 0; i < pointCount; ++i)
+    {
+        indices[writeIndex] = topPeak;
+        indices[writeIndex + 1] = topLayerStart + i;
+        indices[writeIndex + 2] = topLayerStart + (i == 0 ? pointCount - 1 : i - 1);
+        writeIndex += 3;
+    }
+
+    // Bottom face triangles, same as the top but with reversed order
+    for (int i = 0; i < pointCount; ++i)
+    {
+        indices[writeIndex] = bottomPeak;
+
+        if (i == 0)
+        {
+            indices[writeIndex + 1] = pointCount - 1;
+            indices[writeIndex + 2] = 0;
+        }
+        else
+        {
+            indices[writeIndex + 1] = i - 1;
+            indices[writeIndex + 2] = i;
+        }
+
+        writeIndex += 3;
+    }
+}
+
+void MembraneGenerator::FinishMesh(int pointCount, const float* vertices, float* normals, float* uvs) noexcept
+{
+    const int bottomPeak = LAYER_COUNT * pointCount;
+    const int topPeak = bottomPeak + 1;
+
+    const float uvAngleModifier = 2.0f * Pi / static_cast<float>(pointCount);
+
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        const float y =
+            0.9f * static_cast<float>(std::abs(layer - VERTICAL_RESOLUTION)) / VERTICAL_RESOLUTION;
+
+        for (int i = 0; i < pointCount; ++i)
+        {
+            const int id = i + layer * pointCount;
+
+            const float angle = uvAngleModifier * static_cast<float>(i);
+
+            uvs[id * 2] = (1.0f - y) * std::sin(angle) * 0.49f + 0.5f;
+            uvs[id * 2 + 1] = (1.0f - y) * std::cos(angle) * 0.49f + 0.5f;
+
+            // Normals are from the neighbouring points on the same layer and the layers above and below
+            const float* previous = vertices + (i == 0 ? id + pointCount - 1 : id - 1) * 3;
+            const float* next = vertices + (i == pointCount - 1 ? id - i : id + 1) * 3;
+            const float* down = vertices + (layer == 0 ? bottomPeak : id - pointCount) * 3;
+            const float* up = vertices + (layer == LAYER_COUNT - 1 ? topPeak : id + pointCount) * 3;
+
+            const float alongX = next[0] - previous[0];
+            const float alongY = next[1] - previous[1];
+            const float alongZ = next[2] - previous[2];
+
+            const float upX = up[0] - down[0];
+            const float upY = up[1] - down[1];
+            const float upZ = up[2] - down[2];
+
+            float normalX = alongY * upZ - alongZ * upY;
+            float normalY = alongZ * upX - alongX * upZ;
+            float normalZ = alongX * upY - alongY * upX;
+            Normalize(normalX, normalY, normalZ);
+
+            normals[id * 3] = normalX;
+            normals[id * 3 + 1] = normalY;
+            normals[id * 3 + 2] = normalZ;
+        }
+    }
+
+    uvs[bottomPeak * 2] = 0.5f;
+    uvs[bottomPeak * 2 + 1] = 0.5f;
+    uvs[topPeak * 2] = 0.5f;
+    uvs[topPeak * 2 + 1] = 0.5f;
+
+    normals[bottomPeak * 3] = 0;
+    normals[bottomPeak * 3 + 1] = -1;
+    normals[bottomPeak * 3 + 2] = 0;
+
+    normals[topPeak * 3] = 0;
+    normals[topPeak * 3 + 1] = 1;
+    normals[topPeak * 3 + 2] = 0;
+}
+
+} // namespace Thrive::Simulation
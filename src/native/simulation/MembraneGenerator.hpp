@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Thrive::Simulation
+{
+
+/// \brief Generates the membrane shape of a microbe from the positions of its organelle hexes
+///
+/// First the 2D outline points of the membrane are generated, which are then used for the layered membrane mesh and
+/// the engulf animation mesh (and on the C# side the collision shape). 2D points are x, y pairs where y is the world
+/// z coordinate and 3D vectors are x, y, z triples, which matches the memory layout of the Godot vector types so
+/// the buffers can be given directly to Godot meshes.
+class MembraneGenerator
+{
+public:
+    /// \brief These need to match the MEMBRANE_ constants in Constants.cs
+    static constexpr int RESOLUTION = 10;
+    static constexpr int VERTICAL_RESOLUTION = 7;
+
+    /// \brief The maximum number of outline points a membrane can have
+    static constexpr int MAX_POINTS = RESOLUTION * 4;
+
+    /// \brief Number of outline copies stacked on top of each other in the membrane mesh
+    static constexpr int LAYER_COUNT = VERTICAL_RESOLUTION * 2 + 1;
+
+public:
+    MembraneGenerator() = delete;
+
+    /// \brief Generates the outline points of a membrane
+    /// \param hexPositions Positions of all the organelle hexes as x, y pairs
+    /// \param cellWall Cell walls have less wavy membranes
+    /// \param pointsResult Receives the points as x, y pairs, needs to have space for MAX_POINTS points
+    /// \returns The number of generated points
+    static int GeneratePoints(const float* hexPositions, int hexCount, bool cellWall, float* pointsResult);
+
+    [[nodiscard]] static constexpr int GetMeshVertexCount(int pointCount) noexcept
+    {
+        // The last two vertices are the centers of the bottom and the top
+        return LAYER_COUNT * pointCount + 2;
+    }
+
+    [[nodiscard]] static constexpr int GetMeshIndexCount(int pointCount) noexcept
+    {
+        return (pointCount * 2 + (LAYER_COUNT - 1) * pointCount * 2) * 3;
+    }
+
+    [[nodiscard]] static constexpr int GetEngulfMeshVertexCount(int pointCount) noexcept
+    {
+        return pointCount * 2;
+    }
+
+    [[nodiscard]] static constexpr int GetEngulfMeshIndexCount(int pointCount) noexcept
+    {
+        // Two extra indices connect the triangle strip back to the start
+        return pointCount * 2 + 2;
+    }
+
+    /// \brief Builds the membrane mesh as a triangle list. The buffers need to be the size given by
+    /// GetMeshVertexCount and GetMeshIndexCount.
+    ///
+    /// The layers of the mesh are copies of the outline which are squished towards the center at the top and the
+    /// bottom to make the membrane rounded.
+    static void BuildMesh(const float* points, int pointCount, float height, float* vertices, float* normals,
+        float* uvs, int32_t* indices);
+
+    /// \brief Builds the engulf animation mesh as a triangle strip around the outline. The buffers need to be the size
+    /// given by GetEngulfMeshVertexCount and GetEngulfMeshIndexCount.
+    static void BuildEngulfMesh(const float* points, int pointCount, float* vertices, float* uvs, int32_t* indices);
+
+private:
+    /// \brief Finds the closest hex of each of the count points. Hexes at the same distance are resolved to the first
+    /// one in the hex list.
+    static void FindClosestHexes(const float* hexPositions, int hexCount, const float* pointsX,
+        const float* pointsY, int count, float* closestX, float* closestY) noexcept;
+
+    /// \brief Writes the triangles of the membrane mesh
+    static void PlaceTriangles(int pointCount, int32_t* indices) noexcept;
+
+    /// \brief Calculates the UVs and normals of the already placed membrane mesh vertices
+    static void FinishMesh(int pointCount, const float* vertices, float* normals, float* uvs) noexcept;
+};
+
+} // namespace Thrive::Simulation
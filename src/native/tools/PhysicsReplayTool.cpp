@@ -0,0 +1,310 @@
+// ------------------------------------ //
+// Headless tool for replaying a physics state dump and a recording of the operations done on the world after it (see
+// PhysicalWorld::StartReplayRecording). Allows profiling problematic frames captured from the game offline and
+// repeatedly. Results are printed as JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "interop/CInterop.h"
+#include "physics/PhysicalWorld.hpp"
+#include "physics/PhysicsReplay.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Delta used when only a dump is given and there is no recording to take the process calls from
+constexpr float DEFAULT_PROCESS_DELTA = 1 / 60.0f;
+
+struct ReplayOptions
+{
+    std::string DumpFile;
+    std::string RecordingFile;
+    std::string OutputFile;
+    int Steps = 600;
+    int Repeats = 1;
+    int Threads = -1;
+};
+
+struct ReplayRunResult
+{
+    /// \brief Wall time of each process call that ran at least one physics step
+    std::vector<double> FrameMilliseconds;
+
+    /// \brief Index of the process call for each entry in FrameMilliseconds
+    std::vector<int> FrameIndices;
+
+    size_t Bodies = 0;
+    uint64_t StateHash = 0;
+
+    /// \brief Events that marked something that couldn't be recorded, the replay doesn't match the game when not 0
+    uint32_t UnreplayableEvents = 0;
+};
+
+// ------------------------------------ //
+bool ParseArguments(int argc, char* argv[], ReplayOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+
+        if (argument == "--help" || argument == "-h")
+        {
+            std::cerr << "Usage: thrive_physics_replay --dump state.bin [--recording recording.bin] [--steps N] "
+                         "[--repeat N] [--threads N] [--output file.json]\n"
+                         "--steps is only used when there is no recording\n";
+            return false;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for argument: " << argument << "\n";
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (argument == "--dump")
+        {
+            options.DumpFile = value;
+        }
+        else if (argument == "--recording")
+        {
+            options.RecordingFile = value;
+        }
+        else if (argument == "--output")
+        {
+            options.OutputFile = value;
+        }
+        else if (argument == "--steps")
+        {
+            options.Steps = std::atoi(value);
+        }
+        else if (argument == "--repeat")
+        {
+            options.Repeats = std::atoi(value);
+        }
+        else if (argument == "--threads")
+        {
+            options.Threads = std::atoi(value);
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << argument << "\n";
+            return false;
+        }
+    }
+
+    if (options.DumpFile.empty())
+    {
+        std::cerr << "A state dump file is required (--dump)\n";
+        return false;
+    }
+
+    if (options.Steps < 1 || options.Repeats < 1)
+    {
+        std::cerr << "Invalid replay options\n";
+        return false;
+    }
+
+    return true;
+}
+
+void ForwardLogMessage(const char* message, int32_t messageLength, int8_t logLevel)
+{
+    // Logs go to stderr to keep the JSON output clean
+    if (logLevel >= 1)
+        std::cerr << std::string_view(message, messageLength) << "\n";
+}
+
+double Percentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0;
+
+    const auto index = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedValues.size())));
+
+    return sortedValues[std::clamp<size_t>(index, 1, sortedValues.size()) - 1];
+}
+
+// ------------------------------------ //
+bool RunReplay(const ReplayOptions& options, ReplayRunResult& result)
+{
+    auto world = std::make_unique<Thrive::Physics::PhysicalWorld>();
+
+    // The player must be destroyed before the world as it destroys the bodies it created
+    Thrive::Physics::PhysicsReplayPlayer player(*world);
+
+    if (!player.LoadState(options.DumpFile))
+        return false;
+
+    const bool hasRecording = !options.RecordingFile.empty();
+
+    if (hasRecording && !player.OpenRecording(options.RecordingFile))
+        return false;
+
+    for (int frame = 0; hasRecording || frame < options.Steps; ++frame)
+    {
+        bool stepped = false;
+
+        const auto start = Clock::now();
+
+        if (hasRecording)
+        {
+            float delta = 0;
+
+            if (!player.PlayNextFrame(delta, stepped))
+                break;
+        }
+        else
+        {
+            stepped = world->Process(DEFAULT_PROCESS_DELTA);
+        }
+
+        const auto end = Clock::now();
+
+        if (!stepped)
+            continue;
+
+        result.FrameMilliseconds.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        result.FrameIndices.push_back(frame);
+    }
+
+    result.Bodies = player.GetBodyCount();
+    result.StateHash = player.HashBodyStates();
+    result.UnreplayableEvents = player.GetUnreplayableEventCount();
+    return true;
+}
+
+// ------------------------------------ //
+void WriteResults(std::ostream& output, const ReplayOptions& options, const std::vector<ReplayRunResult>& runs)
+{
+    output << "{\n";
+    output << "  \"dump\": \"" << options.DumpFile << "\",\n";
+    output << "  \"recording\": \"" << options.RecordingFile << "\",\n";
+    output << "  \"threads\": " << GetNativeExecutorThreads() << ",\n";
+
+    bool deterministic = true;
+
+    for (const auto& run : runs)
+    {
+        if (run.StateHash != runs.front().StateHash)
+            deterministic = false;
+    }
+
+    output << "  \"deterministic\": " << (deterministic ? "true" : "false") << ",\n";
+    output << "  \"faithful\": " << (runs.front().UnreplayableEvents == 0 ? "true" : "false") << ",\n";
+    output << "  \"runs\": [\n";
+
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const auto& run = runs[i];
+
+        auto sorted = run.FrameMilliseconds;
+        std::sort(sorted.begin(), sorted.end());
+
+        const double mean = sorted.empty() ?
+            0 :
+            std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+
+        // The slowest frame is reported so that it can be looked at more closely
+        int slowestFrame = -1;
+        if (!run.FrameMilliseconds.empty())
+        {
+            const auto slowest = std::max_element(run.FrameMilliseconds.begin(), run.FrameMilliseconds.end());
+            slowestFrame = run.FrameIndices[slowest - run.FrameMilliseconds.begin()];
+        }
+
+        output << "    {\n";
+        output << "      \"bodies\": " << run.Bodies << ",\n";
+        output << "      \"stepped_frames\": " << sorted.size() << ",\n";
+        output << "      \"mean_ms\": " << mean << ",\n";
+        output << "      \"p50_ms\": " << Percentile(sorted, 50) << ",\n";
+        output << "      \"p90_ms\": " << Percentile(sorted, 90) << ",\n";
+        output << "      \"p99_ms\": " << Percentile(sorted, 99) << ",\n";
+        output << "      \"max_ms\": " << (sorted.empty() ? 0 : sorted.back()) << ",\n";
+        output << "      \"slowest_frame\": " << slowestFrame << ",\n";
+        output << "      \"state_hash\": \"" << std::hex << run.StateHash << std::dec << "\"\n";
+        output << "    }" << (i + 1 < runs.size() ? ",\n" : "\n");
+    }
+
+    output << "  ]\n";
+    output << "}\n";
+}
+
+} // namespace
+
+// ------------------------------------ //
+int main(int argc, char* argv[])
+{
+    ReplayOptions options;
+
+    if (!ParseArguments(argc, argv, options))
+        return 1;
+
+    SetLogForwardingCallback(&ForwardLogMessage);
+
+    if (InitThriveLibrary() != 0)
+    {
+        std::cerr << "Failed to initialize the native library\n";
+        return 2;
+    }
+
+    if (options.Threads > 0)
+        SetNativeExecutorThreads(options.Threads);
+
+    std::vector<ReplayRunResult> runs(options.Repeats);
+
+    for (auto& run : runs)
+    {
+        if (!RunReplay(options, run))
+        {
+            std::cerr << "Replay failed\n";
+            ShutdownThriveLibrary();
+            return 3;
+        }
+    }
+
+    ShutdownThriveLibrary();
+
+    if (runs.front().UnreplayableEvents > 0)
+    {
+        std::cerr << "Warning: recording uses collision filter callbacks which can't be replayed, the replay is not "
+                     "faithful to the original run (" << runs.front().UnreplayableEvents << " unreplayable events)\n";
+    }
+
+    std::ostringstream output;
+    output.precision(6);
+    output << std::fixed;
+
+    WriteResults(output, options, runs);
+
+    if (options.OutputFile.empty())
+    {
+        std::cout << output.str();
+        return 0;
+    }
+
+    std::ofstream file(options.OutputFile);
+    file << output.str();
+
+    if (!file.good())
+    {
+        std::cerr << "Failed to write results to: " << options.OutputFile << "\n";
+        return 4;
+    }
+
+    return 0;
+}